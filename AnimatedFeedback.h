@@ -12,6 +12,7 @@ It also includes media buttons for rewinding and pausing the animation.
 #include <gdiplus.h>
 #include "Word.h"
 #include "Slider.h"
+#include "FeedbackTimeline.h"
 
 class Button;
 class BackBuffer;
@@ -25,7 +26,8 @@ public:
     enum ColourType{PAPER, PEN, CORRECT, WRONG, MISSING, SWAPPED};
     AnimatedFeedback(Speller& speller,
                      Gdiplus::Font* font,
-                     AnalysedLetters& attempt,
+                     ScreenPrinter* sp,
+                     const AnalysedLetters& attempt,
                      BackBuffer* bb);
                      
     void ShowMediaControls();
@@ -36,25 +38,15 @@ public:
     
     void WordPosition( Gdiplus::PointF& newPos);
     
-    void Update( double dt, const Gdiplus::PointF& mousePos );
+    bool Update( double dt, const Gdiplus::PointF& mousePos ); // Returns true if the animation moved on
     void Display( double dt );
+    bool Animating() const; // Playing, and not yet complete
+    Gdiplus::RectF Bounds() const; // Where the letters and slider can be drawn, throughout the animation
     void Click( Gdiplus::PointF clickPos );
     
 private:
     
-    void CalculateAnimation();
-    int  CalculateMWGroups(); // Number and location of missing/wrong groups for Stage 2
-    int  CalculateMisplacedGroups(); // Number and location of swapped and three away groups for Stage 3
-    void Stage1Update( double t );
-    void Stage2Update( double t );
-    void Stage3Update( double t );
-    void Stage1Display();
-    void Stage2Display();
-    void Stage3Display();
-    void CompleteDisplay();
-    
-    Gdiplus::Color GetFadeColour( const Gdiplus::Color& start, const Gdiplus::Color& dest, double ratio );
-    double MeasureSpacer( std::wstring letters ); //calculates width of passed in letters
+    void CalculateAnimation(); // Compiles timeline_ from the attempt and the Speller's colours
 
     void Rewind();
     void Pause();
@@ -72,14 +64,6 @@ private:
          useNaturalSpacing_,// From Speller Options
          paused_;           // Freeze animation
 
-    enum Stage{ STAGE1, STAGE2, STAGE3, COMPLETE};
-    Stage stage_;
-
-    double spacerBefore_, spacerAfter_, currentSpacer_; // For stage 2, how far apart the letters either side of the animation need to be
-    
-    std::wstring  missingLetters_, // Missing letters dropping in from above
-                  wrongLetters_;   // Wrong letters dropping out of the word   
-         
     Gdiplus::Font* font_;
     
     double  timer_; // Identifies position in animation.
@@ -92,23 +76,11 @@ private:
                     
     AnalysedLetters attemptCopy_;  // Copy of the speller's attempt.
 
-    // Timers - these control the length of each animation part and therefore overall animation length.  TODO:Convert to const
-    double pause0_, pause1_, pause2_, stage1Speed_, stage2Speed_, stage3Speed_;
+    FeedbackTimeline timeline_; // Every letter's position and colour through the animation
+    Gdiplus::RectF letterBounds_; // Where the letters go, from wordPos_
+    LetterFrameList frames_;    // The letters at timer_
     double animationLength_; // Stores overall animation length.
-    double dropDistance_; // TODO:convert to CONSTANT - this is the distance missing/wrong letters moved when dropping in/out
-    double jumpDistance_; // as above.   This is used to control the max height of a jumping letter (Stage 3)
-    double verticalOffset_; // Current vertical position for animated letters. (Stage 2)
-    double leftLetterOffset_, rightLetterOffset_, currentLeft_, currentRight_,
-            jumpedLettersOffset_, currentJumped_, flyingLetterOffset_ ; // For swapping letters (Stage 3)
-    Gdiplus::PointF flyingLetter_; // Location of ThreeAway (Stage 3)
-    typedef std::vector<std::pair<int,int> > Stage2Groups; // 1st=position in attemptCopy_. 2nd=no. of letters
-    Stage2Groups stage2Groups_;
-    enum MisplacedTypes{ SWAP, ARCFORWARD, ARCBACK };
-    typedef std::vector<std::pair<int,MisplacedTypes> > Stage3Groups;
-    Stage3Groups stage3Groups_;
     ScreenPrinter* pSP_;
-    Gdiplus::Color correctTween_, wrongTween_, missingTween_, misplacedTween_; // colours used for fading
-    int currentGroup_; // track changes to groups (stages 2 and 3) to save time with some calcs
     BackBuffer* bb_;
     Slider slider_;
     
@@ -1,7 +1,7 @@
 // App.cpp
 
-#include <ctime>
 #include <cstdlib>
+#include <cmath>
 #include "App.h"
 #include "BackBuffer.h"
 #include "TitleScreen.h"
@@ -11,6 +11,11 @@
 #include "ScreenPrinter.h"
 #include "Word.h"
 #include "Speller.h"
+#include "ScrollBox.h"
+#include "ObjectPool.h"
+#ifdef _DEBUG
+#include <sstream>
+#endif
 
 using namespace std;
 using namespace Gdiplus;
@@ -19,7 +24,8 @@ extern std::wstring ToWString(const std::string& s);
 
 App::App()
 : gWidth(1024), gHeight(768), currentMode_(0), gotoMode_(1), previousMode_(0), pDBController_(new DBController()),
-    spellerID_(0), pSpeller_(0)
+    imageCache_(imageDecoder_, 64 * 1024 * 1024), imagePreloader_(imageDecoder_),
+    scheduler_(clock_, DirtyRect(0, 0, gWidth, gHeight), 1.0 / 60.0), spellerID_(0), pSpeller_(0), sessionCount_(0)
 {
     // GDI+ initialization
     // Variables used to initialize GDI+
@@ -80,6 +86,21 @@ LRESULT App::WndProc( HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             gBackBuffer = new BackBuffer(hwnd, gWidth, gHeight, screenX, screenY);
             pScreenPrinter_ = new ScreenPrinter(gBackBuffer);
             
+            // Animate at the display's own rate, where it says what that is.
+            HDC hdc = GetDC(hwnd);
+            int refresh = GetDeviceCaps(hdc, VREFRESH);
+            ReleaseDC(hwnd, hdc);
+            if( refresh > 1 )
+                scheduler_.SetFramePeriod( 1.0 / refresh );
+            
+            break;
+        }
+    case WM_PAINT:  // Uncovered - nothing else would redraw an idle screen
+        {
+            PAINTSTRUCT ps;
+            BeginPaint(hwnd, &ps);
+            EndPaint(hwnd, &ps);
+            scheduler_.InvalidateAll();
             break;
         }
     case WM_DESTROY:
@@ -220,7 +241,7 @@ bool App::CreateDisplay(HINSTANCE hInstance, int nCmdShow)
 }
 
 void App::SetUp(){
-    srand( static_cast<unsigned int>( time( 0 ) ) );
+    random_.Reseed( MakeSeed() ); // Use GetSeed() to replay a run.
     
     // Get Tags
     pDBController_->GetTagList(tagList_);
@@ -238,6 +259,11 @@ void App::SetUp(){
             tagList_[0].AddWordID(iter->second.GetID() );
         }
     }
+    substringIndex_.Build( wordBank_ );
+    
+    // Words with homophones can't be used sound only without context, whether or not the database says so.
+    phoneticIndex_.Build( wordBank_ );
+    phoneticIndex_.MarkConfusables( wordBank_ );
     
     // Set Font
     mpFont = new Gdiplus::Font(L"Arial", 30.0);
@@ -259,56 +285,42 @@ int App::BeginGame()
 		return 0;
 	}
 
-	double timeScale = 1.0 / (double)cntsPerSec;
-	// Get the current time.
-	__int64 lastTime = 0;
-	QueryPerformanceCounter((LARGE_INTEGER*)&lastTime);
-	
-	//unsigned double timeElapsed = 0.0f;
+	double startTime = clock_.Now();
 
 	while(msg.message != WM_QUIT)
 	{
-		// IF there is a Windows message then process it.
-		if(PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+		// Process every waiting Windows message.
+		bool input = false;
+		while(msg.message != WM_QUIT && PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
 		{
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
+			input = true;
 		}
-		// ELSE, do game stuff.
-		else
-        {
-			// Get the time now.	
-			__int64 currTime = 0; 
-			QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
-			// Compute time difference
-			double deltaTime = (double)(currTime - lastTime) * timeScale;
-			timeElapsed_ += (double)deltaTime;
-            
-            if( pMode_ ){
-            
-                // Update stuff
-                Update( deltaTime );
-                
-                gBackBuffer->Clear();
-                // Draw screen to back buffer
-                Display( *gBackBuffer );
-
-                // Present new buffer
-                gBackBuffer->present();          
-            }
-            
-            // Check for new mode.
-            if( gotoMode_ ){
-                SwitchMode();                
-                deltaTime = 0.0; // Is this necessary?!
-            }      
-                
-			// update time variables for next loop
-			lastTime = currTime;
-
-            // Slight pause
-            Sleep(20);
+		if(msg.message == WM_QUIT)
+			break;
+
+		timeElapsed_ = clock_.Now() - startTime;
+
+        // Update on input, and every frame while animating.
+        if( pMode_ && ( input || scheduler_.UpdateDue() ) )
+            Update( scheduler_.Step() );
+        
+        // Check for new mode.
+        if( gotoMode_ ){
+            SwitchMode();
+            scheduler_.InvalidateAll();
         }
+        
+        // Redraw and present whatever has changed.
+        if( pMode_ )
+            scheduler_.Frame( *this );
+        
+        // Sleep until the next frame is due - or, on a still screen, until there is input.
+        double wait = scheduler_.Wait();
+        if( wait != 0.0 )
+            MsgWaitForMultipleObjects(0, NULL, FALSE, wait < 0.0 ? INFINITE : static_cast<DWORD>( ceil( wait * 1000.0 ) ),
+                                      QS_ALLINPUT);
     }
 	// Return exit code back to operating system.
 	return (int)msg.wParam;
@@ -317,7 +329,13 @@ int App::BeginGame()
 
 
 void App::Update(double dt){
+    imagePreloader_.Deliver( imageCache_ );
     pMode_->Update(dt, &GetMousePosition() );
+    
+    DirtyRegion dirty;
+    pMode_->TakeDirty( dirty );
+    scheduler_.Invalidate( dirty );
+    scheduler_.SetAnimating( pMode_->Animating() );
 }
 
 void App::Display(BackBuffer& bb)
@@ -329,28 +347,63 @@ void App::Display(BackBuffer& bb)
 
 }
 
+void App::Draw(const DirtyRect& rect)
+{
+    RECT clip = { rect.left_, rect.top_, rect.right_, rect.bottom_ };
+    gBackBuffer->Clip( &clip );
+    gBackBuffer->Clear();
+    Display( *gBackBuffer );
+    gBackBuffer->Clip( 0 );
+}
+
+void App::Present(const DirtyRect& rect)
+{
+    RECT area = { rect.left_, rect.top_, rect.right_, rect.bottom_ };
+    gBackBuffer->present( area );
+}
+
 void App::LMBDown()
 {
     pMode_->LMBDown( &GetMousePosition(), timeElapsed_ );
+    scheduler_.InvalidateAll(); // Input can change anything on screen
 }
 
 void App::LMBUp()
 {
     pMode_->LMBUp( &GetMousePosition() );
+    scheduler_.InvalidateAll(); // Input can change anything on screen
 }
 
 void App::KeyStroke( UINT key )
 {
     pMode_->KeyDown(key);
+    scheduler_.InvalidateAll(); // Input can change anything on screen
 }
 
 void App::KeyRelease(){
     pMode_->KeyUp();
+    scheduler_.InvalidateAll(); // Input can change anything on screen
 }
 
 void App::Wheel(short zDelta, Gdiplus::PointF& mousePos){
 
     pMode_->Wheel(zDelta, &mousePos);
+    scheduler_.InvalidateAll(); // Input can change anything on screen
+}
+
+PerformanceClock::PerformanceClock()
+: secondsPerCount_(0.0)
+{
+    __int64 cntsPerSec = 0;
+    if( QueryPerformanceFrequency((LARGE_INTEGER*)&cntsPerSec) && cntsPerSec > 0 )
+        secondsPerCount_ = 1.0 / (double)cntsPerSec;
+}
+
+double PerformanceClock::Now()
+{
+    __int64 count = 0;
+    QueryPerformanceCounter((LARGE_INTEGER*)&count);
+    return (double)count * secondsPerCount_;
 }
 
 PointF App::GetMousePosition() {
@@ -364,13 +417,23 @@ PointF App::GetMousePosition() {
 }
 
 void App::SwitchMode() {
+#ifdef _DEBUG
+    __int64 startTime = 0;
+    QueryPerformanceCounter((LARGE_INTEGER*)&startTime);
+#endif
+    imagePreloader_.Deliver( imageCache_ ); // Anything decoded since the last frame
+#ifdef _DEBUG
+    unsigned int hits = imageCache_.Hits();
+    unsigned int misses = imageCache_.Misses();
+#endif
+
     unsigned int modeNumber = gotoMode_;
     gotoMode_ = 0;
     
     switch(modeNumber){
         case TITLE:{
         delete pMode_;
-            pMode_ = new TitleScreen(gotoMode_, previousMode_, TITLE,gBackBuffer);
+            pMode_ = new TitleScreen(gotoMode_, previousMode_, TITLE, imageCache_, gBackBuffer);
             previousMode_ = TITLE;
             break;
         }
@@ -382,7 +445,7 @@ void App::SwitchMode() {
                 result = 0;
             }
             numSpellers_ = result;
-            pMode_ = new TopMenu(gotoMode_, previousMode_, MENU,gBackBuffer, numSpellers_);
+            pMode_ = new TopMenu(gotoMode_, previousMode_, MENU, imageCache_, gBackBuffer, numSpellers_);
             previousMode_ = MENU;
             break;
         }
@@ -392,20 +455,20 @@ void App::SwitchMode() {
         }
         case NEWSPELLER:{
             delete pMode_;
-            pMode_ = new NewSpeller(gotoMode_, previousMode_, NEWSPELLER, mpFont, pDBController_, pScreenPrinter_, spellerID_, tagList_);
+            pMode_ = new NewSpeller(gotoMode_, previousMode_, NEWSPELLER, imageCache_, keyboardLayouts_, mpFont, pDBController_, pScreenPrinter_, spellerID_, tagList_);
             previousMode_ = NEWSPELLER;
             break;
         }
         case SELECTSPELLER:{
             delete pMode_;
-            pMode_ = new SelectSpeller(gotoMode_, previousMode_, SELECTSPELLER, mpFont, pDBController_, spellerID_);
+            pMode_ = new SelectSpeller(gotoMode_, previousMode_, SELECTSPELLER, imageCache_, mpFont, pDBController_, spellerID_);
             previousMode_ = SELECTSPELLER;
             break;
         }
         case WORDLISTOPTIONS:{
             delete pMode_;
-            pMode_ = new WordListOptions(gotoMode_, previousMode_, WORDLISTOPTIONS, gBackBuffer,
-                                         mpFont, wordBank_, tagList_,
+            pMode_ = new WordListOptions(gotoMode_, previousMode_, WORDLISTOPTIONS, imageCache_, gBackBuffer,
+                                         mpFont, wordBank_, tagList_, substringIndex_,
                                          pSpeller_,
                                          pDBController_ );
             previousMode_ = WORDLISTOPTIONS;
@@ -420,28 +483,28 @@ void App::SwitchMode() {
         }
         case SPELLERMENU:{
             delete pMode_;
-            pMode_ = new SpellerMenu(gotoMode_, previousMode_, SPELLERMENU, mpFont, pDBController_);
+            pMode_ = new SpellerMenu(gotoMode_, previousMode_, SPELLERMENU, imageCache_, mpFont, pDBController_);
             previousMode_ = SPELLERMENU;
             break; 
         }
         case QUICKSPELL:{
             delete pMode_;
-            pMode_ = new MiniSpell(gotoMode_, previousMode_, QUICKSPELL, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
-                                    mpFont, pDBController_);
+            pMode_ = new MiniSpell(gotoMode_, previousMode_, QUICKSPELL, imageCache_, keyboardLayouts_, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
+                                    mpFont, pDBController_, random_.Split(++sessionCount_));
             previousMode_ = QUICKSPELL;
             break;
         }
         case WORDWORKOUT:{
             delete pMode_;
-            pMode_ = new MiniSpell(gotoMode_, previousMode_, WORDWORKOUT, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
-                                    mpFont, pDBController_);
+            pMode_ = new MiniSpell(gotoMode_, previousMode_, WORDWORKOUT, imageCache_, keyboardLayouts_, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
+                                    mpFont, pDBController_, random_.Split(++sessionCount_));
             previousMode_ = WORDWORKOUT;
             break;
         }
         case SPELLINGSPOTTING:{
             delete pMode_;
-            pMode_ = new MiniSpell(gotoMode_, previousMode_, SPELLINGSPOTTING, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
-                                    mpFont, pDBController_);
+            pMode_ = new MiniSpell(gotoMode_, previousMode_, SPELLINGSPOTTING, imageCache_, keyboardLayouts_, wordBank_, *pSpeller_, gBackBuffer, pScreenPrinter_,
+                                    mpFont, pDBController_, random_.Split(++sessionCount_));
             previousMode_ = SPELLINGSPOTTING;
             break;
         }
@@ -453,11 +516,66 @@ void App::SwitchMode() {
                 result = 0;
             }
             numSpellers_ = result;
-            pMode_ = new TopMenu(gotoMode_, previousMode_, MENU,gBackBuffer, numSpellers_);
+            pMode_ = new TopMenu(gotoMode_, previousMode_, MENU, imageCache_, gBackBuffer, numSpellers_);
             break;
         }
     
     }
+    
+#ifdef _DEBUG
+    // Report how long the switch took, and how many images had to be decoded for it.
+    __int64 endTime = 0, countsPerSec = 1;
+    QueryPerformanceCounter((LARGE_INTEGER*)&endTime);
+    QueryPerformanceFrequency((LARGE_INTEGER*)&countsPerSec);
+    double switchSeconds = (double)(endTime - startTime) / (double)countsPerSec;
+    wostringstream report;
+    report << L"SwitchMode " << modeNumber << L": " << switchSeconds * 1000.0 << L"ms, images "
+           << imageCache_.Hits() - hits << L" cached, " << imageCache_.Misses() - misses << L" decoded\n";
+    OutputDebugStringW( report.str().c_str() );
+#endif
+    
+    PreloadNextModes( modeNumber );
+}
+
+void App::PreloadNextModes( unsigned int mode ){
+    StringVec images;
+    switch( mode ){
+        case TITLE:
+            TopMenu::Images( images );
+            break;
+        case MENU:{
+            SelectSpeller::Images( images );
+            NewSpeller::Images( images );
+            // Avatars shown in the SelectSpeller list
+            TableData spellers;
+            RowPool rows;
+            pDBController_->GetSpellersAndAvatars( spellers, rows );
+            for( TableData::iterator iter = spellers.begin(); iter != spellers.end(); ++iter )
+                images.push_back( (*iter)->data_[0] );
+            break;
+        }
+        case NEWSPELLER:
+        case SELECTSPELLER:
+            SpellerMenu::Images( images );
+            TopMenu::Images( images );
+            break;
+        case SPELLERMENU:
+            MiniSpell::Images( images );
+            WordListOptions::Images( images );
+            TopMenu::Images( images );
+            break;
+        case WORDLISTOPTIONS:
+        case QUICKSPELL:
+        case WORDWORKOUT:
+        case SPELLINGSPOTTING:
+            SpellerMenu::Images( images );
+            MiniSpell::Images( images );
+            WordListOptions::Images( images );
+            break;
+        default:
+            break;
+    }
+    imagePreloader_.Request( images, imageCache_ );
 }
 
 void App::DeleteSpeller(){
@@ -7,6 +7,14 @@
 #include <map>
 #include "Word.h"
 #include "Definitions.h"
+#include "Random.h"
+#include "SubstringIndex.h"
+#include "PhoneticIndex.h"
+#include "ImageDecoder.h"
+#include "ImageCache.h"
+#include "ImagePreloader.h"
+#include "KeyboardLayout.h"
+#include "FrameScheduler.h"
 
 class BackBuffer;
 class Mode;
@@ -15,8 +23,18 @@ class ScreenPrinter;
 class Speller;
 
 
+// Seconds from the performance counter, for the FrameScheduler.
+class PerformanceClock : public FrameClock
+{
+public:
+    PerformanceClock();
+    double Now();
+private:
+    double secondsPerCount_;
+};
+
 // Main driver for the program
-class App
+class App : public FrameSurface
 {
 public:
 
@@ -32,6 +50,8 @@ public:
 
     void Update(double dt);             // Update based on current status
     void Display(BackBuffer& bb);    // Draw stuff based on current status
+    void Draw(const DirtyRect& rect);    // Redraws rect of the back buffer, for the FrameScheduler
+    void Present(const DirtyRect& rect); // Copies rect of the back buffer to the window
 
     void LMBDown();
     void KeyStroke( UINT key );
@@ -51,6 +71,7 @@ private: // private functions
     Gdiplus::PointF GetMousePosition();
     
     void SwitchMode();
+    void PreloadNextModes( unsigned int mode ); // Starts decoding the images of the modes likely to follow mode
     void DeleteSpeller();
 
 public: // public members
@@ -60,6 +81,12 @@ public: // public members
     Gdiplus::Font* mpFont;
     DBController* pDBController_;
     ScreenPrinter* pScreenPrinter_;
+    GdiplusDecoder imageDecoder_;
+    ImageCache imageCache_;         // Backgrounds, buttons and avatars, shared by every mode
+    ImagePreloader imagePreloader_; // Fills imageCache_ in the background, ahead of SwitchMode
+    KeyboardLayouts keyboardLayouts_; // Keyboard files, compiled the first time a mode shows a keyboard
+    PerformanceClock clock_;
+    FrameScheduler scheduler_;      // When to update and draw, and which parts of the screen to redraw
     
     Mode* pMode_; // Contains the current "mode" of the program (titlescreen, menus, game modes, etc.)
     unsigned int currentMode_; // 
@@ -72,9 +99,14 @@ public: // public members
     
     TagList tagList_;
     WordBank wordBank_;
+    SubstringIndex substringIndex_; // Letter searches over wordBank_, for the word list options
+    PhoneticIndex phoneticIndex_;   // Words in wordBank_ that sound alike
     
     double timeElapsed_;
     
+    RandomStream random_;        // Master stream; each game session gets its own stream split from this.
+    unsigned int sessionCount_;  // Number of game sessions started - used as the session stream ID.
+    
 
 private:
 
@@ -74,6 +74,16 @@ void BackBuffer::present()
     ReleaseDC(mhWnd, hWndDC);
 }
 
+void BackBuffer::present(const RECT& rect)
+{
+    HDC hWndDC = GetDC(mhWnd);
+
+    BitBlt(hWndDC, rect.left + mOffX, rect.top + mOffY, rect.right - rect.left, rect.bottom - rect.top,
+           mhDC, rect.left + mOffX, rect.top + mOffY, SRCCOPY);
+
+    ReleaseDC(mhWnd, hWndDC);
+}
+
 void BackBuffer::Clear()
 {
     //Rectangle(mhDC, mOffX-1, mOffY-1, mOffX + mWidth+1, mOffY + mHeight+1);
@@ -86,4 +96,16 @@ void BackBuffer::Clear()
 
     // restore the original brush.
     SelectObject(mhDC, oldBrush);
+}
+
+void BackBuffer::Clip(const RECT* rect)
+{
+    if( !rect )
+    {
+        SelectClipRgn(mhDC, NULL);
+        return;
+    }
+    HRGN region = CreateRectRgn(rect->left + mOffX, rect->top + mOffY, rect->right + mOffX, rect->bottom + mOffY);
+    SelectClipRgn(mhDC, region); // The DC keeps its own copy
+    DeleteObject(region);
 }
\ No newline at end of file
@@ -20,7 +20,9 @@ public:
     int height();
 
     void present();
+    void present(const RECT& rect); // Copies just rect, given without the offsets
     void Clear();
+    void Clip(const RECT* rect);    // Limits drawing to rect, given without the offsets.  0 lifts the limit.
 
 private:
     // Prevent copy and assignment operators being automatically generated.
@@ -180,6 +180,12 @@ int Button::GetState() const {
     return state_;
 }
 
+Gdiplus::RectF Button::Bounds() const {
+    // The highlight pen is centred on a rectangle highlightThickness_ out from the button.
+    float edge = 2.0f * highlightThickness_;
+    return RectF(position_.X - edge, position_.Y - edge, displayWidth_ + 2.0f * edge, displayHeight_ + 2.0f * edge);
+}
+
 // ToggleButton
 
 ToggleButton::ToggleButton() {}
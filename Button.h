@@ -60,6 +60,7 @@ public:
     virtual float Height() const; // Returns DISPLAYED height
     virtual float Width() const;  // Returns DISPLAYED width
     virtual int   GetState() const; // Returns state of button
+    virtual Gdiplus::RectF Bounds() const; // Area the button draws in, highlight included
 
 private:
     //Button(const Button& b); // Copy Constructor
@@ -3,21 +3,24 @@
 #include "DBController.h"
 #include <string>
 #include "ScrollBox.h"
+#include "ObjectPool.h"
 #include "Speller.h"
 #include "Range.h"
 #include <algorithm>
 #include "Convert.h"
+#include "Utility.h"
 //#include "Word.h"
 
 using namespace std;
 
-DBController::DBController()
-: pDatabase_(0), dbLocation_("Data/spellephant.db"), dbStatus_(dbCLOSED) {
+DBController::DBController( const char* location )
+: pDatabase_(0), dbLocation_(location), dbStatus_(dbCLOSED) {
     
     // This is dangerous - potential infinite loop!
     while( dbStatus_ != dbOPEN ){
         OpenConnection();
     }
+    UpgradeSchema();
 }
 
 DBController::~DBController(){
@@ -49,6 +52,42 @@ void DBController::CloseConnection(){
     dbStatus_ = dbCLOSED;
 }
 
+void DBController::UpgradeSchema(){
+    // Spaced repetition scheduling, stored per record.
+    if( !ColumnExists( L"SpellerRecords", L"LastSeen" ) )
+        Execute( L"ALTER TABLE SpellerRecords ADD COLUMN LastSeen NUMERIC DEFAULT 0;" );
+    if( !ColumnExists( L"SpellerRecords", L"Interval" ) )
+        Execute( L"ALTER TABLE SpellerRecords ADD COLUMN Interval NUMERIC DEFAULT 0;" );
+    // Packed letter analysis of each wrong spelling, for replaying feedback.
+    if( !ColumnExists( L"WrongSpellings", L"Analysis" ) )
+        Execute( L"ALTER TABLE WrongSpellings ADD COLUMN Analysis BLOB;" );
+}
+
+bool DBController::ColumnExists( const std::wstring& table, const std::wstring& column ){
+    sqlite3_stmt* sql;
+    wstring cmd = L"PRAGMA table_info(" + table + L");";
+    int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
+    result = sqlite3_step(sql);
+    bool found = false;
+    while( result == SQLITE_ROW ){
+        if( ToLower( GetWString(sql, 1) ) == ToLower( column ) ) // column 1 is the name
+            found = true;
+        result = sqlite3_step(sql);
+    }
+    sqlite3_finalize(sql);
+    return found;
+}
+
+void DBController::Execute( const std::wstring& cmd ){
+    sqlite3_stmt* sql;
+    int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
+    result = sqlite3_step(sql);
+    while( result == SQLITE_ROW ){
+        result = sqlite3_step(sql);
+    }
+    sqlite3_finalize(sql);
+}
+
 inline
 wstring DBController::GetWString(sqlite3_stmt *sql, int col){
     return std::wstring(reinterpret_cast<const wchar_t*>(sqlite3_column_text16(sql,col)));
@@ -74,6 +113,21 @@ double DBController::GetDouble(sqlite3_stmt* sql, int col){
     return sqlite3_column_double(sql, col);
 }
 
+inline
+long long DBController::GetInt64(sqlite3_stmt* sql, int col){
+    return sqlite3_column_int64(sql, col);
+}
+
+inline
+void DBController::GetBlob(sqlite3_stmt* sql, int col, std::vector<unsigned char>& blob){
+    const unsigned char* data = static_cast<const unsigned char*>( sqlite3_column_blob(sql, col) );
+    int bytes = sqlite3_column_bytes(sql, col); // Must come after sqlite3_column_blob
+    if( data )
+        blob.assign( data, data + bytes );
+    else
+        blob.clear();
+}
+
 // Getting data
 int DBController::GetNumSpellers(){    
     sqlite3_stmt* sql;
@@ -131,7 +185,7 @@ std::wstring DBController::GetAvatarFilenameFromID(int id){
     return fileName;
 }
 
-void DBController::GetSpellersAndAvatars(TableData& data){
+void DBController::GetSpellersAndAvatars(TableData& data, RowPool& rows){
     sqlite3_stmt* sql;
     wstring cmd = L"SELECT Spellers.ID, Filename, Name FROM Spellers JOIN Avatars ON AvatarID = Avatars.ID;";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
@@ -141,7 +195,7 @@ void DBController::GetSpellersAndAvatars(TableData& data){
         rd.dataID_ = GetInt(sql, 0);
         rd.data_.push_back(L"Images/avatars/" + GetWString(sql, 1));
         rd.data_.push_back(GetWString(sql,2));
-        data.push_back(new RowData(rd.dataID_, rd.data_));  //Here's where it will go belly up...
+        data.push_back(rows.Make(rd));
         result = sqlite3_step(sql);
     }
     sqlite3_finalize(sql);
@@ -326,17 +380,19 @@ IDList DBController::GetSpellerTags(unsigned int spellerID){
 void DBController::GetSpellerRecords(Speller &speller){
     // Get all records from SpellerRecords
     sqlite3_stmt* sql;
-    wstring cmd = L"SELECT * FROM SpellerRecords WHERE spellerID = @id;";
+    wstring cmd = L"SELECT WordID, Attempts, Level, LastSeen, Interval FROM SpellerRecords WHERE spellerID = @id;";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
     result = sqlite3_bind_int(sql, 1, speller.GetID());
     result = sqlite3_step(sql);
 
     // Process
     while( result == SQLITE_ROW ){
-        unsigned int wordID = GetUInt(sql, 1);
-        unsigned int attempts = GetUInt(sql, 2);
-        int level = GetInt(sql, 3);
-        speller.AddRecord( wordID, attempts, level );
+        unsigned int wordID = GetUInt(sql, 0);
+        unsigned int attempts = GetUInt(sql, 1);
+        int level = GetInt(sql, 2);
+        long long lastSeen = GetInt64(sql, 3); // NULL reads as 0
+        long long interval = GetInt64(sql, 4);
+        speller.AddRecord( wordID, attempts, level, lastSeen, interval );
         result = sqlite3_step(sql);
     }
     sqlite3_finalize(sql);
@@ -345,7 +401,7 @@ void DBController::GetSpellerRecords(Speller &speller){
 void DBController::GetWrongSpellings( Speller& speller ){
     // Get all wrong spellings for speller's records
     sqlite3_stmt* sql;
-    wstring cmd = L"SELECT WordID, Spelling, Score, AverageLinkLength, LongestLink, LengthDifference FROM WrongSpellings WHERE spellerID = @id;";
+    wstring cmd = L"SELECT WordID, Spelling, Score, AverageLinkLength, LongestLink, LengthDifference, Analysis FROM WrongSpellings WHERE spellerID = @id;";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
     result = sqlite3_bind_int(sql, 1, speller.GetID());
     result = sqlite3_step(sql);
@@ -357,7 +413,9 @@ void DBController::GetWrongSpellings( Speller& speller ){
         double aveLinkLength= GetDouble(sql, 3);
         unsigned int longestLink = GetUInt( sql, 4);
         unsigned int lengthDiff  = GetUInt( sql, 5);
-        WrongSpelling ws( spelling, score, aveLinkLength, longestLink, lengthDiff);
+        PackedAnalysis analysis;
+        GetBlob( sql, 6, analysis );
+        WrongSpelling ws( spelling, score, aveLinkLength, longestLink, lengthDiff, analysis );
         speller.AddWrongSpelling( wordID, ws );
         result = sqlite3_step(sql);
     }
@@ -417,7 +475,7 @@ void DBController::AddSpellerRecord( unsigned int spellerID,
                                      unsigned int attempts,
                                      int level){
     sqlite3_stmt* sql;
-    wstring cmd = L"INSERT INTO SpellerRecords VALUES (@spellerId, @wordId, @attempts, @level);";
+    wstring cmd = L"INSERT INTO SpellerRecords (SpellerID, WordID, Attempts, Level) VALUES (@spellerId, @wordId, @attempts, @level);";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1, &sql, 0);
     result = sqlite3_bind_int(sql, 1, spellerID);
     result = sqlite3_bind_int(sql, 2, wordID);
@@ -434,7 +492,7 @@ void DBController::AddWrongSpelling( unsigned int spellerID,
                                      unsigned int wordID,
                                      WrongSpelling &ws){
     sqlite3_stmt* sql;
-    wstring cmd = L"INSERT INTO WrongSpellings (SpellerID, WordID, Spelling, Score, AverageLinkLength, LongestLink, LengthDifference) VALUES (@spellerId, @wordId, @spelling, @score, @averageLinkLength, @longestLink, @lengthDifference);";
+    wstring cmd = L"INSERT INTO WrongSpellings (SpellerID, WordID, Spelling, Score, AverageLinkLength, LongestLink, LengthDifference, Analysis) VALUES (@spellerId, @wordId, @spelling, @score, @averageLinkLength, @longestLink, @lengthDifference, @analysis);";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1, &sql, 0);
     result = sqlite3_bind_int(sql, 1, spellerID);
     result = sqlite3_bind_int(sql, 2, wordID);
@@ -443,6 +501,10 @@ void DBController::AddWrongSpelling( unsigned int spellerID,
     result = sqlite3_bind_double(sql, 5, ws.aveLinkLength_);
     result = sqlite3_bind_int(sql, 6, ws.longestLink_);
     result = sqlite3_bind_int(sql, 7, ws.lengthDifference_);
+    if( ws.analysis_.empty() )
+        result = sqlite3_bind_null(sql, 8);
+    else
+        result = sqlite3_bind_blob(sql, 8, &ws.analysis_[0], static_cast<int>( ws.analysis_.size() ), SQLITE_STATIC);
     result = sqlite3_step(sql);
     while( result == SQLITE_ROW ){
         result = sqlite3_step(sql);
@@ -477,12 +539,14 @@ void DBController::UpdateDifficulty(unsigned int spellerID, int low, int high){
 
 void DBController::UpdateSpellerRecord(Speller& speller, unsigned int wordID ){
     sqlite3_stmt* sql;
-    wstring cmd = L"UPDATE SpellerRecords SET Attempts = @attempts, Level = @level WHERE SpellerID = @spellerid AND WordID = @wordid;";
+    wstring cmd = L"UPDATE SpellerRecords SET Attempts = @attempts, Level = @level, LastSeen = @lastseen, Interval = @interval WHERE SpellerID = @spellerid AND WordID = @wordid;";
     int result = sqlite3_prepare16_v2(pDatabase_, cmd.c_str(), -1,&sql,0);
     result = sqlite3_bind_int(sql, 1, speller.GetWordAttempts( wordID ));
     result = sqlite3_bind_int(sql, 2, speller.GetWordLevel( wordID ));
-    result = sqlite3_bind_int(sql, 3, speller.GetID() );
-    result = sqlite3_bind_int(sql, 4, wordID );
+    result = sqlite3_bind_int64(sql, 3, speller.GetWordLastSeen( wordID ));
+    result = sqlite3_bind_int64(sql, 4, speller.GetWordInterval( wordID ));
+    result = sqlite3_bind_int(sql, 5, speller.GetID() );
+    result = sqlite3_bind_int(sql, 6, wordID );
     result = sqlite3_step(sql);
     while( result == SQLITE_ROW ){
         result = sqlite3_step(sql);
@@ -14,7 +14,7 @@ This class deals with all the interactions with the SQLite3 database.
 class DBController{
 public:
     enum{dbERROR,dbCLOSED,dbOPEN};
-    DBController();
+    DBController( const char* location = "Data/spellephant.db" ); // location must outlive the controller
     ~DBController();
 
     // Status checks
@@ -27,7 +27,7 @@ public:
     void GetAvatarList(ImageList& imageList); 
     void GetAvatarIDList(IDList& idList);
     std::wstring GetAvatarFilenameFromID(int id);
-    void GetSpellersAndAvatars(TableData& data);
+    void GetSpellersAndAvatars(TableData& data, RowPool& rows); // Rows are made in rows
     Speller* LoadSpeller(int id);
     void GetTagList(TagList& tagList); // tagList will be cleared first
     void GetWordBank(WordBank& wordBank); // wordList will be cleared first
@@ -60,12 +60,17 @@ public:
 private:
     void OpenConnection();
     void CloseConnection();
+    void UpgradeSchema();   // Adds any columns missing from databases created by older versions.
+    bool ColumnExists( const std::wstring& table, const std::wstring& column );
+    void Execute( const std::wstring& cmd ); // Runs a statement that returns no data.
     
     std::wstring GetWString(sqlite3_stmt* sql, int col);
     int          GetInt    (sqlite3_stmt* sql, int col);
     unsigned int GetUInt   (sqlite3_stmt* sql, int col);
     bool         GetBool   (sqlite3_stmt* sql, int col);
     double       GetDouble (sqlite3_stmt* sql, int col);
+    long long    GetInt64  (sqlite3_stmt* sql, int col);
+    void         GetBlob   (sqlite3_stmt* sql, int col, std::vector<unsigned char>& blob); // NULL gives an empty blob
 
 private:
     sqlite3* pDatabase_;         // set by call to sqlite3_open_v2
@@ -34,6 +34,8 @@ const unsigned int TOP_LEVEL_RANK_4 = 15;
 
 struct RowData; //forward declaration
 typedef std::vector<RowData*> TableData;    // Used by ScrollBox.
+template <typename T> class ObjectPool;
+typedef ObjectPool<RowData> RowPool;        // Where a screen's TableData rows are made
 
 enum ProgModes{
     TITLE=1,
@@ -0,0 +1,34 @@
+// DueQueue.cpp
+
+#include "DueQueue.h"
+#include "Speller.h"
+
+using namespace std;
+
+void DueQueue::Build( const WorkingList& list, const Speller& speller ){
+    vector<Entry> entries;
+    entries.reserve( list.size() );
+    for( size_t i = 0; i < list.size(); ++i ){
+        entries.push_back( Entry( speller.GetWordDue( list[i].id_ ), i ) );
+    }
+    // Building from the whole range heapifies in O(n).
+    queue_ = priority_queue< Entry, vector<Entry>, greater<Entry> >( greater<Entry>(), entries );
+}
+
+void DueQueue::Clear(){
+    queue_ = priority_queue< Entry, vector<Entry>, greater<Entry> >();
+}
+
+bool DueQueue::Empty() const{
+    return queue_.empty();
+}
+
+size_t DueQueue::Pop(){
+    size_t index = queue_.top().second;
+    queue_.pop();
+    return index;
+}
+
+void DueQueue::Schedule( size_t index, long long due ){
+    queue_.push( Entry( due, index ) );
+}
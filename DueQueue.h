@@ -0,0 +1,31 @@
+// DueQueue.h
+// Spaced repetition scheduling for MiniSpell: a priority queue of working list indices ordered by
+// when each word is next due, so the most overdue word can be taken in O(log n).
+
+#ifndef DUEQUEUE_H
+#define DUEQUEUE_H
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <utility>
+#include <cstddef>
+#include "Utility.h"
+
+class Speller;
+
+class DueQueue{
+public:
+    void Build( const WorkingList& list, const Speller& speller ); // Queues every word by its due time.
+    void Clear();
+    bool Empty() const;
+    
+    std::size_t Pop();   // Removes and returns the index of the most overdue word.  Queue must not be empty.
+    void Schedule( std::size_t index, long long due ); // (Re)queues a popped word.
+
+private:
+    typedef std::pair<long long, std::size_t> Entry; // due time, index into working list
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > queue_;
+};
+
+#endif // DUEQUEUE_H
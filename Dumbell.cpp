@@ -113,7 +113,9 @@ void Dumbell::Display(BackBuffer& bb)
 }
 
 //Updates ball positions (if grabbed) to follow mouse position
-void Dumbell::Update(const Gdiplus::PointF& mousePos) {
+bool Dumbell::Update(const Gdiplus::PointF& mousePos) {
+    double left = leftBall_;
+    double right = rightBall_;
     // Set moving end to current mouse x pos.
     if( isLeftBallGrabbed_ ) leftBall_ = (mousePos.X - (0.5 * ballDiameter_));    
     if( leftBall_ > rightBall_ ) rightBall_ = leftBall_;
@@ -137,6 +139,12 @@ void Dumbell::Update(const Gdiplus::PointF& mousePos) {
         isLeftBallGrabbed_ = true;
         isRightBallGrabbed_ = false;
     }
+    return leftBall_ != left || rightBall_ != right;
+}
+
+Gdiplus::RectF Dumbell::Bounds() const {
+    return RectF(static_cast<REAL>( leftLimit_ ), static_cast<REAL>( yPosition_ ),
+                 static_cast<REAL>( rightLimit_ - leftLimit_ + ballDiameter_ ), static_cast<REAL>( ballDiameter_ ));
 }
 
 
@@ -43,7 +43,8 @@ public:
     bool Grab(const Gdiplus::PointF& mousePos); // returns false if neither ball grabbed
     bool Release(); // Returns false if nothing to release.
     void Display(BackBuffer& bb);
-    void Update(const Gdiplus::PointF& mousePos);
+    bool Update(const Gdiplus::PointF& mousePos); // Returns true if a ball moved
+    Gdiplus::RectF Bounds() const; // Everywhere the balls can go
 
 private:
     void SnapPosition(double& ballPos);
@@ -0,0 +1,413 @@
+// FeedbackTimeline.cpp
+
+#include "FeedbackTimeline.h"
+#include "TextLayout.h"
+#include <algorithm>
+
+using namespace std;
+
+FeedbackPalette::FeedbackPalette()
+: pen_(0), correct_(0), wrong_(0), missing_(0), swapped_(0)
+{}
+
+FeedbackTimings::FeedbackTimings()
+: pause0_(0.0), stage1_(1.0), pause1_(0.0), stage2_(1.0), pause2_(0.0), stage3_(1.0),
+  drop_(150.0), jump_(0.07)
+{}
+
+FeedbackTimeline::FeedbackTimeline()
+: length_(0.0)
+{}
+
+void FeedbackTimeline::Compile( const std::wstring& letters, const std::vector<LetterStatus>& statuses, TextLayout& layout,
+                                const Gdiplus::Font& font, const FeedbackPalette& palette, const FeedbackTimings& timings ){
+    letters_ = letters;
+    statuses_ = statuses;
+    statuses_.resize( letters_.size(), Correct ); // In case they don't match up
+    layout.Advances( font, letters_, advances_ ); // The only measuring
+    palette_ = palette;
+    timings_ = timings;
+
+    starts_.clear();
+    lengths_.clear();
+    flyers_.clear();
+    lifts_.clear();
+    keys_.clear();
+    length_ = 0.0;
+
+    KeyList start, end;
+    // Stage 1, and the pauses either side
+    Stage1( 0.0, start );
+    AddStep( timings_.pause0_, start, start );
+    Stage1( 1.0, end );
+    AddStep( timings_.stage1_, start, end );
+    AddStep( timings_.pause1_, end, end );
+
+    // Stage 2
+    GroupList groups;
+    FindWrongAndMissing( groups );
+    for( GroupList::const_iterator group = groups.begin(); group != groups.end(); ++group ){
+        Stage2( *group, 0.0, start );
+        Stage2( *group, 1.0, end );
+        AddStep( timings_.stage2_, start, end );
+    }
+    AddStep( timings_.pause2_, end, end );
+
+    // Stage 3
+    groups.clear();
+    FindMisplaced( groups );
+    for( GroupList::const_iterator group = groups.begin(); group != groups.end(); ++group ){
+        float lift = 0.0f;
+        Stage3( *group, 0.0, start, lift );
+        Stage3( *group, 1.0, end, lift );
+        AddStep( timings_.stage3_, start, end, group->second == SWAP ? -1 : group->first, lift );
+    }
+
+    // The finished word stays put
+    Complete( start );
+    starts_.push_back( length_ );
+    lengths_.push_back( 0.0 );
+    flyers_.push_back( -1 );
+    lifts_.push_back( 0.0f );
+    for( size_t i = 0; i < start.size(); ++i ){
+        keys_.push_back( start[i] );
+        keys_.push_back( start[i] );
+    }
+}
+
+double FeedbackTimeline::Length() const{
+    return length_;
+}
+
+std::size_t FeedbackTimeline::Steps() const{
+    return starts_.size();
+}
+
+void FeedbackTimeline::Sample( double t, LetterFrameList& frames ) const{
+    size_t letters = letters_.size();
+    frames.resize( letters );
+    if( starts_.empty() )
+        return;
+    t = max( 0.0, min( t, length_ ) );
+    size_t step = ( upper_bound( starts_.begin(), starts_.end(), t ) - starts_.begin() ) - 1;
+    double ratio = lengths_[step] > 0.0 ? ( t - starts_[step] ) / lengths_[step] : 1.0;
+    float r = static_cast<float>( ratio );
+
+    const Key* key = &keys_[2 * step * letters];
+    for( size_t i = 0; i < letters; ++i, key += 2 ){
+        const Key& from = key[0];
+        const Key& to   = key[1];
+        LetterFrame& frame = frames[i];
+        frame.letter_  = letters_[i];
+        frame.visible_ = from.visible_;
+        frame.x_       = from.x_ + ( to.x_ - from.x_ ) * r;
+        frame.y_       = from.y_ + ( to.y_ - from.y_ ) * r;
+        frame.colour_  = Fade( from.colour_, to.colour_, ratio );
+    }
+    if( flyers_[step] >= 0 ) // Up and over, landing where it took off from if it hadn't moved
+        frames[flyers_[step]].y_ -= lifts_[step] * r * ( 1.0f - r );
+}
+
+void FeedbackTimeline::Extent( float& left, float& top, float& right, float& bottom ) const{
+    left = top = right = bottom = 0.0f;
+    bool found = false;
+    size_t letters = letters_.size();
+    for( size_t step = 0; step < starts_.size(); ++step ){
+        const Key* key = &keys_[2 * step * letters];
+        for( size_t i = 0; i < letters; ++i, key += 2 ){
+            if( !key[0].visible_ )
+                continue;
+            float stepLeft   = min( key[0].x_, key[1].x_ );
+            float stepRight  = max( key[0].x_, key[1].x_ ) + advances_[i];
+            float stepTop    = min( key[0].y_, key[1].y_ );
+            float stepBottom = max( key[0].y_, key[1].y_ );
+            if( flyers_[step] == static_cast<int>( i ) )
+                stepTop -= 0.25f * lifts_[step]; // The top of its arc, half way
+            if( !found ){
+                left = stepLeft;
+                top = stepTop;
+                right = stepRight;
+                bottom = stepBottom;
+                found = true;
+            }
+            else{
+                left   = min( left, stepLeft );
+                top    = min( top, stepTop );
+                right  = max( right, stepRight );
+                bottom = max( bottom, stepBottom );
+            }
+        }
+    }
+}
+
+void FeedbackTimeline::FindWrongAndMissing( GroupList& groups ) const{
+    int size = static_cast<int>( statuses_.size() );
+    int i = 0;
+    while( i < size ){
+        while( i < size && statuses_[i] != Wrong && statuses_[i] != Missing )
+            ++i;
+        if( i == size )
+            break;
+        int groupStart = i;
+        while( i < size && ( statuses_[i] == Wrong || statuses_[i] == Missing ) )
+            ++i;
+        groups.push_back( make_pair( groupStart, i - groupStart ) );
+    }
+}
+
+void FeedbackTimeline::FindMisplaced( GroupList& groups ) const{
+    int size = static_cast<int>( statuses_.size() );
+    for( int i = 0; i < size; ++i ){
+        if( statuses_[i] == ThreeAwayWrongF )
+            groups.push_back( make_pair( i, static_cast<int>( ARCFORWARD ) ) ); // A letter jumping forward
+        else if( statuses_[i] == ThreeAwayMissingF )
+            groups.push_back( make_pair( i, static_cast<int>( ARCBACK ) ) );    // A letter jumping back
+        else if( statuses_[i] == Swapped ){
+            groups.push_back( make_pair( i, static_cast<int>( SWAP ) ) );
+            ++i;
+        }
+    }
+}
+
+void FeedbackTimeline::AddStep( double length, const KeyList& start, const KeyList& end, int flyer, float lift ){
+    if( length <= 0.0 )
+        return;
+    starts_.push_back( length_ );
+    lengths_.push_back( length );
+    flyers_.push_back( flyer );
+    lifts_.push_back( lift );
+    for( size_t i = 0; i < start.size(); ++i ){
+        keys_.push_back( start[i] );
+        keys_.push_back( end[i] );
+    }
+    length_ += length;
+}
+
+void FeedbackTimeline::Stage1( double ratio, KeyList& keys ) const{
+    Key hidden = { false, 0.0f, 0.0f, 0 };
+    keys.assign( letters_.size(), hidden );
+    // Correct and Wrong fade in, Swapped and ThreeAwayWrong stay in Pen.  Missing aren't there yet.
+    float x = 0.0f;
+    for( int i = 0; i < static_cast<int>( statuses_.size() ); ++i ){
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, Fade( palette_.pen_, palette_.correct_, ratio ) );
+                break;
+            case Wrong:
+                x = Place( keys, i, x, 0.0f, Fade( palette_.pen_, palette_.wrong_, ratio ) );
+                break;
+            case Swapped:
+            case ThreeAwayWrongF:
+            case ThreeAwayWrongB:
+                x = Place( keys, i, x, 0.0f, palette_.pen_ );
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void FeedbackTimeline::Stage2( const Group& group, double ratio, KeyList& keys ) const{
+    Key hidden = { false, 0.0f, 0.0f, 0 };
+    keys.assign( letters_.size(), hidden );
+    int size = static_cast<int>( statuses_.size() );
+    int first = group.first, last = group.first + group.second;
+    float r = static_cast<float>( ratio );
+
+    // Letters before the group, earlier groups done
+    float x = 0.0f;
+    for( int i = 0; i < first; ++i ){
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, palette_.correct_ );
+                break;
+            case Missing:
+                x = Place( keys, i, x, 0.0f, palette_.missing_ );
+                break;
+            case Swapped:
+            case ThreeAwayWrongF:
+            case ThreeAwayWrongB:
+                x = Place( keys, i, x, 0.0f, palette_.pen_ );
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Missing letters drop in from above, over the wrong letters dropping out below
+    float drop = static_cast<float>( timings_.drop_ );
+    float missingX = x, wrongX = x;
+    for( int i = first; i < last; ++i ){
+        if( statuses_[i] == Missing )
+            missingX = Place( keys, i, missingX, -drop * ( 1.0f - r ), Alpha( palette_.missing_, ratio ) );
+        else if( statuses_[i] == Wrong )
+            wrongX = Place( keys, i, wrongX, drop * r, Alpha( palette_.wrong_, 1.0 - ratio ) );
+    }
+    // The rest of the word closes up, or opens out, to fit
+    float wrongWidth = wrongX - x, missingWidth = missingX - x;
+    x += wrongWidth - ( wrongWidth - missingWidth ) * r;
+
+    for( int i = last; i < size; ++i ){
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, palette_.correct_ );
+                break;
+            case Wrong:
+                x = Place( keys, i, x, 0.0f, palette_.wrong_ );
+                break;
+            case Swapped:
+            case ThreeAwayWrongF:
+            case ThreeAwayWrongB:
+                x = Place( keys, i, x, 0.0f, palette_.pen_ );
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void FeedbackTimeline::Stage3( const Group& group, double ratio, KeyList& keys, float& lift ) const{
+    Key hidden = { false, 0.0f, 0.0f, 0 };
+    keys.assign( letters_.size(), hidden );
+    int size = static_cast<int>( statuses_.size() );
+    int first = group.first;
+    Misplaced type = static_cast<Misplaced>( group.second );
+    float r = static_cast<float>( ratio );
+
+    // Letters before the group, earlier groups done
+    float x = 0.0f;
+    for( int i = 0; i < first; ++i ){
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, palette_.correct_ );
+                break;
+            case Missing:
+                x = Place( keys, i, x, 0.0f, palette_.missing_ );
+                break;
+            case Swapped:
+                x = Place( keys, i + 1, x, 0.0f, palette_.swapped_ );
+                x = Place( keys, i, x, 0.0f, palette_.swapped_ );
+                ++i;
+                break;
+            case ThreeAwayMissingF:
+            case ThreeAwayMissingB:
+                x = Place( keys, i, x, 0.0f, palette_.swapped_ );
+                break;
+            default:
+                break;
+        }
+    }
+
+    unsigned int moving = Fade( palette_.pen_, palette_.swapped_, ratio );
+    int groupSize = 2;
+    float spacer = 0.0f;
+    lift = 0.0f;
+    if( type == SWAP ){
+        // The pair slide past each other
+        float left = Width( first, 1 ), right = Width( first + 1, 1 );
+        Place( keys, first, x + right * r, 0.0f, moving );
+        Place( keys, first + 1, x + left * ( 1.0f - r ), 0.0f, moving );
+        spacer = left + right;
+    } else {
+        // One letter jumps over the next two, as they slide into its place
+        groupSize = 4; // The letter's other place is part of the group
+        float jumper = Width( first, 1 ), jumped = Width( first + 1, 2 );
+        float jumpedX = x + ( type == ARCFORWARD ? jumper * ( 1.0f - r ) : jumper * r );
+        for( int i = first + 1; i < first + 3 && i < size; ++i ){
+            if( statuses_[i] == Correct )
+                jumpedX = Place( keys, i, jumpedX, 0.0f, palette_.correct_ );
+            else if( statuses_[i] == Swapped )
+                jumpedX = Place( keys, i, jumpedX, 0.0f, palette_.pen_ );
+        }
+        Place( keys, first, x + ( type == ARCFORWARD ? jumped * r : jumped * ( 1.0f - r ) ), 0.0f, moving );
+        lift = static_cast<float>( timings_.jump_ ) * jumped * jumped;
+        spacer = jumper + jumped;
+    }
+    x += spacer;
+
+    for( int i = first + groupSize; i < size; ++i ){
+        bool afterSwap = i == first + groupSize && type == SWAP;
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, palette_.correct_ );
+                break;
+            case Missing:
+                x = Place( keys, i, x, 0.0f, palette_.missing_ );
+                break;
+            case Swapped:
+            case ThreeAwayWrongF:
+                x = Place( keys, i, x, 0.0f, palette_.pen_ );
+                break;
+            case ThreeAwayWrongB: // Not straight after a pair being swapped
+                if( !afterSwap )
+                    x = Place( keys, i, x, 0.0f, palette_.pen_ );
+                break;
+            case ThreeAwayMissingB: // Only straight after a pair being swapped, where it ends an earlier group
+                if( afterSwap )
+                    x = Place( keys, i, x, 0.0f, palette_.swapped_ );
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void FeedbackTimeline::Complete( KeyList& keys ) const{
+    Key hidden = { false, 0.0f, 0.0f, 0 };
+    keys.assign( letters_.size(), hidden );
+    float x = 0.0f;
+    for( int i = 0; i < static_cast<int>( statuses_.size() ); ++i ){
+        switch( statuses_[i] ){
+            case Correct:
+                x = Place( keys, i, x, 0.0f, palette_.correct_ );
+                break;
+            case Missing:
+                x = Place( keys, i, x, 0.0f, palette_.missing_ );
+                break;
+            case Swapped:
+                x = Place( keys, i + 1, x, 0.0f, palette_.swapped_ );
+                x = Place( keys, i, x, 0.0f, palette_.swapped_ );
+                ++i;
+                break;
+            case ThreeAwayMissingF:
+            case ThreeAwayMissingB:
+                x = Place( keys, i, x, 0.0f, palette_.swapped_ );
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+float FeedbackTimeline::Place( KeyList& keys, int i, float x, float y, unsigned int colour ) const{
+    if( i >= static_cast<int>( keys.size() ) )
+        return x;
+    Key& key = keys[i];
+    key.visible_ = true;
+    key.x_ = x;
+    key.y_ = y;
+    key.colour_ = colour;
+    return x + advances_[i];
+}
+
+float FeedbackTimeline::Width( int first, int count ) const{
+    float width = 0.0f;
+    for( int i = first; i < first + count && i < static_cast<int>( advances_.size() ); ++i )
+        width += advances_[i];
+    return width;
+}
+
+unsigned int FeedbackTimeline::Fade( unsigned int from, unsigned int to, double ratio ){
+    ratio = max( 0.0, min( ratio, 1.0 ) );
+    unsigned int colour = 0;
+    for( int shift = 0; shift < 32; shift += 8 ){
+        int start = ( from >> shift ) & 0xFF;
+        int end   = ( to >> shift ) & 0xFF;
+        colour |= static_cast<unsigned int>( start + static_cast<int>( ( end - start ) * ratio ) ) << shift;
+    }
+    return colour;
+}
+
+unsigned int FeedbackTimeline::Alpha( unsigned int colour, double alpha ){
+    return ( colour & 0x00FFFFFF ) | ( static_cast<unsigned int>( 255.0 * alpha ) << 24 );
+}
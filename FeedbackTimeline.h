@@ -0,0 +1,104 @@
+// FeedbackTimeline.h
+/*
+The animated feedback for one attempt, compiled to keyframes.
+Stage 1 fades the correct and wrong letters in.  Stage 2 takes each group of wrong and missing letters in
+turn, dropping the wrong ones out as the missing ones drop in.  Stage 3 takes each misplaced group in
+turn, swapping a pair or jumping a letter over two others.
+Compile works out where every letter is, and its colour, at the start and end of each step - measuring
+each letter once, through a TextLayout.  Sample then interpolates between them for any time, forwards,
+backwards or jumping about, with no measuring at all.
+*/
+
+#ifndef FEEDBACKTIMELINE_H
+#define FEEDBACKTIMELINE_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "LetterStatus.h"
+
+namespace Gdiplus{
+    class Font;
+}
+class TextLayout;
+
+struct FeedbackPalette{ // ARGB
+    FeedbackPalette();
+    unsigned int pen_, correct_, wrong_, missing_, swapped_;
+};
+
+struct FeedbackTimings{
+    FeedbackTimings();
+    double pause0_, stage1_, pause1_, stage2_, pause2_, stage3_; // Seconds.  Stages 2 and 3 take theirs per group.
+    double drop_; // How far wrong and missing letters drop
+    double jump_; // How high a jumping letter goes, for the distance it travels
+};
+
+// One letter of the attempt at one moment.
+struct LetterFrame{
+    wchar_t letter_;
+    bool visible_;
+    float x_, y_;         // From the top left of the word
+    unsigned int colour_; // ARGB
+};
+typedef std::vector<LetterFrame> LetterFrameList;
+
+class FeedbackTimeline{
+public:
+    FeedbackTimeline();
+
+    // letters is the analysed attempt, with each letter's status at the same index in statuses.
+    void Compile( const std::wstring& letters, const std::vector<LetterStatus>& statuses, TextLayout& layout,
+                  const Gdiplus::Font& font, const FeedbackPalette& palette, const FeedbackTimings& timings );
+
+    double Length() const;      // Time the animation is complete
+    std::size_t Steps() const;  // Keyframed steps, the final still included
+    // Fills frames with each letter of the attempt, in order, at time t (limited to 0 to Length()).
+    void Sample( double t, LetterFrameList& frames ) const;
+    // Where any letter is drawn at any time, from the top left of the word.  Right and bottom take in each
+    // letter's advance but not its height, which the layout doesn't know.  All 0 for no letters.
+    void Extent( float& left, float& top, float& right, float& bottom ) const;
+
+private:
+    enum Misplaced{ SWAP, ARCFORWARD, ARCBACK };
+    typedef std::pair<int, int> Group; // First letter, then the number of letters (stage 2) or a Misplaced (stage 3)
+    typedef std::vector<Group> GroupList;
+
+    struct Key{
+        bool visible_;
+        float x_, y_;
+        unsigned int colour_;
+    };
+    typedef std::vector<Key> KeyList; // A Key for each letter
+
+    void FindWrongAndMissing( GroupList& groups ) const;
+    void FindMisplaced( GroupList& groups ) const; // ThreeAways have to be found in order
+    void AddStep( double length, const KeyList& start, const KeyList& end, int flyer = -1, float lift = 0.0f );
+
+    // Where the letters are at ratio (0 to 1) of the way through each stage.
+    void Stage1( double ratio, KeyList& keys ) const;
+    void Stage2( const Group& group, double ratio, KeyList& keys ) const;
+    void Stage3( const Group& group, double ratio, KeyList& keys, float& lift ) const;
+    void Complete( KeyList& keys ) const;
+
+    float Place( KeyList& keys, int i, float x, float y, unsigned int colour ) const; // Returns x after letter i
+    float Width( int first, int count ) const;
+
+    static unsigned int Fade( unsigned int from, unsigned int to, double ratio );
+    static unsigned int Alpha( unsigned int colour, double alpha );
+
+private:
+    std::wstring letters_;
+    std::vector<LetterStatus> statuses_;
+    std::vector<float> advances_;
+    FeedbackPalette palette_;
+    FeedbackTimings timings_;
+
+    std::vector<double> starts_, lengths_; // Of each step
+    std::vector<int> flyers_;              // Letter jumping in each step, or -1
+    std::vector<float> lifts_;             // Height of its arc
+    KeyList keys_;                         // Step s, letter i: start key at 2*(s*letters + i), end key next
+    double length_;
+};
+
+#endif // FEEDBACKTIMELINE_H
@@ -0,0 +1,195 @@
+// FrameScheduler.cpp
+
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+// DIRTYRECT
+DirtyRect::DirtyRect()
+: left_(0), top_(0), right_(0), bottom_(0)
+{}
+
+DirtyRect::DirtyRect( int left, int top, int right, int bottom )
+: left_(left), top_(top), right_(right), bottom_(bottom)
+{}
+
+bool DirtyRect::Empty() const{
+    return right_ <= left_ || bottom_ <= top_;
+}
+
+bool DirtyRect::Touches( const DirtyRect& rhs ) const{
+    return left_ <= rhs.right_ && rhs.left_ <= right_ &&
+           top_ <= rhs.bottom_ && rhs.top_ <= bottom_;
+}
+
+void DirtyRect::Merge( const DirtyRect& rhs ){
+    if( rhs.Empty() )
+        return;
+    if( Empty() ){
+        *this = rhs;
+        return;
+    }
+    left_   = min( left_, rhs.left_ );
+    top_    = min( top_, rhs.top_ );
+    right_  = max( right_, rhs.right_ );
+    bottom_ = max( bottom_, rhs.bottom_ );
+}
+
+void DirtyRect::Clip( const DirtyRect& bounds ){
+    left_   = max( left_, bounds.left_ );
+    top_    = max( top_, bounds.top_ );
+    right_  = min( right_, bounds.right_ );
+    bottom_ = min( bottom_, bounds.bottom_ );
+}
+
+// DIRTYREGION
+DirtyRegion::DirtyRegion()
+: all_(false)
+{}
+
+void DirtyRegion::Add( const DirtyRect& rect ){
+    if( all_ || rect.Empty() )
+        return;
+    // Swallow every rectangle the new one touches, and anything those bring into reach.
+    DirtyRect merged = rect;
+    DirtyRectList::iterator iter = rects_.begin();
+    while( iter != rects_.end() ){
+        if( iter->Touches( merged ) ){
+            merged.Merge( *iter );
+            rects_.erase( iter );
+            iter = rects_.begin();
+        }
+        else
+            ++iter;
+    }
+    rects_.push_back( merged );
+
+    if( rects_.size() > MAX_RECTS ){
+        DirtyRect bounds;
+        for( iter = rects_.begin(); iter != rects_.end(); ++iter )
+            bounds.Merge( *iter );
+        rects_.assign( 1, bounds );
+    }
+}
+
+void DirtyRegion::Add( const DirtyRegion& region ){
+    if( region.all_ ){
+        AddAll();
+        return;
+    }
+    for( DirtyRectList::const_iterator iter = region.rects_.begin(); iter != region.rects_.end(); ++iter )
+        Add( *iter );
+}
+
+void DirtyRegion::AddAll(){
+    all_ = true;
+    rects_.clear();
+}
+
+void DirtyRegion::Clear(){
+    all_ = false;
+    rects_.clear();
+}
+
+bool DirtyRegion::Empty() const{
+    return !all_ && rects_.empty();
+}
+
+bool DirtyRegion::All() const{
+    return all_;
+}
+
+const DirtyRectList& DirtyRegion::Rects() const{
+    return rects_;
+}
+
+// FRAMESCHEDULER
+const double FrameScheduler::MAX_STEP = 0.1;
+
+FrameScheduler::FrameScheduler( FrameClock& clock, const DirtyRect& screen, double framePeriod )
+: clock_(clock), screen_(screen), framePeriod_(framePeriod), animating_(false), frames_(0)
+{
+    lastStep_ = clock_.Now();
+    lastFrame_ = -numeric_limits<double>::max(); // The first frame can be drawn straight away, whatever the period
+    dirty_.AddAll();
+}
+
+void FrameScheduler::SetFramePeriod( double seconds ){
+    framePeriod_ = seconds;
+}
+
+void FrameScheduler::SetAnimating( bool animating ){
+    animating_ = animating;
+}
+
+void FrameScheduler::Invalidate( const DirtyRegion& region ){
+    dirty_.Add( region );
+}
+
+void FrameScheduler::InvalidateAll(){
+    dirty_.AddAll();
+}
+
+double FrameScheduler::Step(){
+    double now = clock_.Now();
+    double step = animating_ ? now - lastStep_ : 0.0;
+    lastStep_ = now;
+    return min( step, MAX_STEP );
+}
+
+bool FrameScheduler::UpdateDue(){
+    return animating_ && clock_.Now() - lastStep_ >= framePeriod_;
+}
+
+bool FrameScheduler::Frame( FrameSurface& surface ){
+    if( dirty_.Empty() )
+        return false;
+    double now = clock_.Now();
+    if( now - lastFrame_ < framePeriod_ )
+        return false;
+
+    if( dirty_.All() ){
+        surface.Draw( screen_ );
+        surface.Present( screen_ );
+    }
+    else{
+        DirtyRectList rects;
+        for( DirtyRectList::const_iterator iter = dirty_.Rects().begin(); iter != dirty_.Rects().end(); ++iter ){
+            DirtyRect rect = *iter;
+            rect.Clip( screen_ );
+            if( !rect.Empty() )
+                rects.push_back( rect );
+        }
+        // Draw everything before presenting any of it, so the screen never shows half a frame.
+        for( DirtyRectList::const_iterator iter = rects.begin(); iter != rects.end(); ++iter )
+            surface.Draw( *iter );
+        for( DirtyRectList::const_iterator iter = rects.begin(); iter != rects.end(); ++iter )
+            surface.Present( *iter );
+    }
+    dirty_.Clear();
+    lastFrame_ = now;
+    ++frames_;
+    return true;
+}
+
+double FrameScheduler::Wait(){
+    double now = clock_.Now();
+    double wait = -1.0;
+    if( !dirty_.Empty() )
+        wait = max( 0.0, lastFrame_ + framePeriod_ - now );
+    if( animating_ ){
+        double untilUpdate = max( 0.0, lastStep_ + framePeriod_ - now );
+        wait = wait < 0.0 ? untilUpdate : min( wait, untilUpdate );
+    }
+    return wait;
+}
+
+bool FrameScheduler::Animating() const{
+    return animating_;
+}
+
+unsigned int FrameScheduler::Frames() const{
+    return frames_;
+}
@@ -0,0 +1,93 @@
+// FrameScheduler.h
+// Decides when App updates and draws, and which parts of the screen it redraws.  Modes mark what they
+// change as dirty and say whether they are animating: an idle screen waits for input, an animating one
+// is updated at the display's rate, and only the dirty parts are ever redrawn and presented.
+// Time and drawing come in through FrameClock and FrameSurface, so none of this needs a window.
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <vector>
+
+// A rectangle of the screen, in the coordinates modes draw in.  Right and bottom are just outside it.
+struct DirtyRect{
+    DirtyRect();
+    DirtyRect( int left, int top, int right, int bottom );
+
+    bool Empty() const;
+    bool Touches( const DirtyRect& rhs ) const; // Overlaps or shares an edge
+    void Merge( const DirtyRect& rhs );         // Grows to cover rhs too
+    void Clip( const DirtyRect& bounds );       // Shrinks to fit inside bounds
+
+    int left_, top_, right_, bottom_;
+};
+typedef std::vector<DirtyRect> DirtyRectList;
+
+// The parts of the screen waiting to be redrawn, kept to a few rectangles that don't touch.
+class DirtyRegion{
+public:
+    DirtyRegion();
+
+    void Add( const DirtyRect& rect );
+    void Add( const DirtyRegion& region );
+    void AddAll(); // The whole screen
+    void Clear();
+
+    bool Empty() const;
+    bool All() const;
+    const DirtyRectList& Rects() const; // Only meaningful when not All()
+
+private:
+    enum{ MAX_RECTS = 8 }; // Any more, and they are merged into one
+
+    DirtyRectList rects_;
+    bool all_;
+};
+
+class FrameClock{
+public:
+    virtual ~FrameClock() {}
+    virtual double Now() = 0; // Seconds since any fixed point
+};
+
+class FrameSurface{
+public:
+    virtual ~FrameSurface() {}
+    virtual void Draw( const DirtyRect& rect ) = 0;    // Redraws rect of the back buffer
+    virtual void Present( const DirtyRect& rect ) = 0; // Copies rect of the back buffer to the screen
+};
+
+class FrameScheduler{
+public:
+    FrameScheduler( FrameClock& clock, const DirtyRect& screen, double framePeriod );
+
+    void SetFramePeriod( double seconds ); // Normally the display's refresh period
+    void SetAnimating( bool animating );   // Animations are updated every frame period, input or not
+    void Invalidate( const DirtyRegion& region );
+    void InvalidateAll();
+
+    // Seconds since the last Step, for passing to Update.  0 if nothing was animating then, so an
+    // animation started by input after the screen has been idle doesn't jump ahead; capped at MAX_STEP.
+    double Step();
+    bool UpdateDue();      // True when animating and a frame period has passed since the last Step
+    // Draws and presents whatever is dirty, at most once per frame period.  Returns true if it drew.
+    bool Frame( FrameSurface& surface );
+    // Seconds until an update or frame is due - 0 for now - or negative if nothing is due until input.
+    double Wait();
+
+    bool Animating() const;
+    unsigned int Frames() const; // Frames drawn so far
+
+private:
+    static const double MAX_STEP;
+
+    FrameClock& clock_;
+    DirtyRect screen_;
+    double framePeriod_;
+    DirtyRegion dirty_;
+    bool animating_;
+    double lastStep_, lastFrame_;
+    unsigned int frames_;
+};
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,116 @@
+// HitGrid.cpp
+
+#include "HitGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+bool HitGrid::Rect::Contains( float x, float y ) const{
+    return x >= left_ && x <= right_ && y >= top_ && y <= bottom_;
+}
+
+HitGrid::HitGrid()
+: left_(0.0f), top_(0.0f), right_(0.0f), bottom_(0.0f), cellWidth_(1.0f), cellHeight_(1.0f), columns_(0), rows_(0)
+{}
+
+void HitGrid::Clear(){
+    rects_.clear();
+    cellStarts_.clear();
+    cellItems_.clear();
+    columns_ = rows_ = 0;
+}
+
+int HitGrid::Add( float x, float y, float width, float height ){
+    Rect rect = { x, y, x + width, y + height };
+    rects_.push_back( rect );
+    return static_cast<int>( rects_.size() ) - 1;
+}
+
+void HitGrid::Build(){
+    cellStarts_.clear();
+    cellItems_.clear();
+    columns_ = rows_ = 0;
+    if( rects_.empty() )
+        return;
+
+    left_ = top_ = 1e30f;
+    right_ = bottom_ = -1e30f;
+    float totalWidth = 0.0f, totalHeight = 0.0f;
+    for( vector<Rect>::const_iterator iter = rects_.begin(); iter != rects_.end(); ++iter ){
+        left_   = min( left_, iter->left_ );
+        top_    = min( top_, iter->top_ );
+        right_  = max( right_, iter->right_ );
+        bottom_ = max( bottom_, iter->bottom_ );
+        totalWidth  += iter->right_ - iter->left_;
+        totalHeight += iter->bottom_ - iter->top_;
+    }
+
+    // Cells about the size of an average rectangle, but not too many of them for stragglers far apart.
+    float count = static_cast<float>( rects_.size() );
+    float averageWidth  = max( 1.0f, totalWidth / count );
+    float averageHeight = max( 1.0f, totalHeight / count );
+    float columns = max( 1.0f, ceil( ( right_ - left_ ) / averageWidth ) );
+    float rows    = max( 1.0f, ceil( ( bottom_ - top_ ) / averageHeight ) );
+    float maxCells = MAX_CELLS_PER_RECT * count;
+    if( columns * rows > maxCells ){
+        float scale = sqrt( maxCells / ( columns * rows ) );
+        columns = max( 1.0f, floor( columns * scale ) );
+        rows    = max( 1.0f, floor( rows * scale ) );
+    }
+    columns_ = static_cast<int>( columns );
+    rows_    = static_cast<int>( rows );
+    cellWidth_  = right_ > left_ ? ( right_ - left_ ) / columns : 1.0f;
+    cellHeight_ = bottom_ > top_ ? ( bottom_ - top_ ) / rows : 1.0f;
+
+    // Count each cell's rectangles, then fill them in, in index order.
+    vector<unsigned int> counts( columns_ * rows_ + 1, 0 );
+    for( int pass = 0; pass < 2; ++pass ){
+        for( size_t i = 0; i < rects_.size(); ++i ){
+            const Rect& rect = rects_[i];
+            int firstColumn = Cell( rect.left_, left_, cellWidth_, columns_ );
+            int lastColumn  = Cell( rect.right_, left_, cellWidth_, columns_ );
+            int firstRow    = Cell( rect.top_, top_, cellHeight_, rows_ );
+            int lastRow     = Cell( rect.bottom_, top_, cellHeight_, rows_ );
+            for( int row = firstRow; row <= lastRow; ++row ){
+                for( int column = firstColumn; column <= lastColumn; ++column ){
+                    int cell = row * columns_ + column;
+                    if( pass == 0 )
+                        ++counts[cell];
+                    else
+                        cellItems_[counts[cell]++] = static_cast<int>( i );
+                }
+            }
+        }
+        if( pass == 0 ){
+            cellStarts_.resize( counts.size() );
+            unsigned int start = 0;
+            for( size_t cell = 0; cell < counts.size(); ++cell ){
+                cellStarts_[cell] = start;
+                start += counts[cell];
+                counts[cell] = cellStarts_[cell]; // Now the next free place in the cell
+            }
+            cellItems_.resize( start );
+        }
+    }
+}
+
+int HitGrid::Find( float x, float y ) const{
+    if( columns_ == 0 || x < left_ || x > right_ || y < top_ || y > bottom_ )
+        return -1;
+    int cell = Cell( y, top_, cellHeight_, rows_ ) * columns_ + Cell( x, left_, cellWidth_, columns_ );
+    for( unsigned int i = cellStarts_[cell]; i < cellStarts_[cell + 1]; ++i ){
+        if( rects_[cellItems_[i]].Contains( x, y ) )
+            return cellItems_[i];
+    }
+    return -1;
+}
+
+std::size_t HitGrid::Size() const{
+    return rects_.size();
+}
+
+int HitGrid::Cell( float value, float origin, float size, int cells ) const{
+    int cell = static_cast<int>( floor( ( value - origin ) / size ) );
+    return max( 0, min( cell, cells - 1 ) );
+}
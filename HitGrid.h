@@ -0,0 +1,45 @@
+// HitGrid.h
+// Finds which of a set of rectangles a point is in, without testing them all.  The rectangles' bounds are
+// cut into a uniform grid of cells about the size of an average rectangle, and each cell lists the
+// rectangles overlapping it - so a point only needs testing against the one or two in its cell.
+// Built once for a layout (Keyboard::CalculateKeys), then queried on every hover and click.
+
+#ifndef HITGRID_H
+#define HITGRID_H
+
+#include <vector>
+#include <cstddef>
+
+class HitGrid{
+public:
+    HitGrid();
+
+    void Clear();
+    // Adds a rectangle, edges included, and returns its index.  Build before finding.
+    int  Add( float x, float y, float width, float height );
+    void Build();
+
+    // Index of the first rectangle added that contains the point, or -1.
+    int Find( float x, float y ) const;
+    std::size_t Size() const;
+
+private:
+    struct Rect{
+        float left_, top_, right_, bottom_;
+        bool Contains( float x, float y ) const;
+    };
+
+    int Cell( float value, float origin, float size, int cells ) const; // Clamped to the grid
+
+private:
+    enum{ MAX_CELLS_PER_RECT = 4 }; // The grid never has more than this many cells per rectangle
+
+    std::vector<Rect> rects_;
+    float left_, top_, right_, bottom_; // Bounds of every rectangle
+    float cellWidth_, cellHeight_;
+    int columns_, rows_;
+    std::vector<unsigned int> cellStarts_; // Cell c lists cellItems_[cellStarts_[c]] up to cellStarts_[c+1]
+    std::vector<int> cellItems_;           // Rectangle indices, lowest first within each cell
+};
+
+#endif // HITGRID_H
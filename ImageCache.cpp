@@ -0,0 +1,117 @@
+// ImageCache.cpp
+
+#include "ImageCache.h"
+
+using namespace std;
+
+ImageCache::ImageCache( ImageDecoder& decoder, std::size_t budget )
+: decoder_(decoder), budget_(budget), bytes_(0), hits_(0), misses_(0), evictions_(0)
+{}
+
+ImageCache::~ImageCache(){
+    for( EntryMap::iterator iter = entries_.begin(); iter != entries_.end(); ++iter )
+        decoder_.Free( iter->second.bitmap_ );
+}
+
+Gdiplus::Bitmap* ImageCache::Acquire( const std::wstring& path ){
+    EntryMap::iterator found = entries_.find( path );
+    if( found != entries_.end() ){
+        ++hits_;
+        Entry& entry = found->second;
+        if( entry.references_++ == 0 )
+            unused_.erase( entry.unused_ );
+        return entry.bitmap_;
+    }
+
+    ++misses_;
+    Gdiplus::Bitmap* bitmap = decoder_.Decode( path );
+    if( !bitmap )
+        return 0; // Not cached, so a later Acquire tries again.
+    Entry entry;
+    entry.bitmap_ = bitmap;
+    entry.bytes_ = decoder_.Bytes( bitmap );
+    entry.references_ = 1;
+    EntryMap::iterator added = entries_.insert( EntryMap::value_type( path, entry ) ).first;
+    bitmaps_[bitmap] = added;
+    bytes_ += entry.bytes_;
+    Evict();
+    return bitmap;
+}
+
+void ImageCache::Release( Gdiplus::Bitmap* bitmap ){
+    BitmapMap::iterator found = bitmaps_.find( bitmap );
+    if( found == bitmaps_.end() )
+        return;
+    Entry& entry = found->second->second;
+    if( entry.references_ == 0 || --entry.references_ > 0 )
+        return;
+    entry.unused_ = unused_.insert( unused_.begin(), found->second->first );
+    Evict();
+}
+
+void ImageCache::Release( std::vector<Gdiplus::Bitmap*>& bitmaps ){
+    for( vector<Gdiplus::Bitmap*>::iterator iter = bitmaps.begin(); iter != bitmaps.end(); ++iter )
+        Release( *iter );
+    bitmaps.clear();
+}
+
+bool ImageCache::Contains( const std::wstring& path ) const{
+    return entries_.find( path ) != entries_.end();
+}
+
+void ImageCache::Adopt( const std::wstring& path, Gdiplus::Bitmap* bitmap ){
+    if( Contains( path ) ){
+        decoder_.Free( bitmap );
+        return;
+    }
+    Entry entry;
+    entry.bitmap_ = bitmap;
+    entry.bytes_ = decoder_.Bytes( bitmap );
+    entry.references_ = 0;
+    EntryMap::iterator added = entries_.insert( EntryMap::value_type( path, entry ) ).first;
+    added->second.unused_ = unused_.insert( unused_.begin(), path );
+    bitmaps_[bitmap] = added;
+    bytes_ += entry.bytes_;
+    Evict();
+}
+
+void ImageCache::SetBudget( std::size_t budget ){
+    budget_ = budget;
+    Evict();
+}
+
+std::size_t ImageCache::Budget() const{
+    return budget_;
+}
+
+std::size_t ImageCache::Bytes() const{
+    return bytes_;
+}
+
+std::size_t ImageCache::Size() const{
+    return entries_.size();
+}
+
+unsigned int ImageCache::Hits() const{
+    return hits_;
+}
+
+unsigned int ImageCache::Misses() const{
+    return misses_;
+}
+
+unsigned int ImageCache::Evictions() const{
+    return evictions_;
+}
+
+void ImageCache::Evict(){
+    while( bytes_ > budget_ && !unused_.empty() ){
+        EntryMap::iterator oldest = entries_.find( unused_.back() );
+        unused_.pop_back();
+        bytes_ -= oldest->second.bytes_;
+        bitmaps_.erase( oldest->second.bitmap_ );
+        decoder_.Free( oldest->second.bitmap_ );
+        entries_.erase( oldest );
+        ++evictions_;
+    }
+}
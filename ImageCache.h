@@ -0,0 +1,66 @@
+// ImageCache.h
+// Decodes each image file once, and shares it between everything that shows it - modes, buttons and
+// ScrollBox cells.  Images are reference counted: Acquire one, and Release it when finished with.
+// Images nobody is using stay decoded, so going back to a mode costs nothing, until together they
+// take more than the memory budget; then the least recently used are freed first.  Images in use
+// are never freed, even over budget.
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <cstddef>
+#include "ImageDecoder.h"
+
+class ImageCache{
+public:
+    ImageCache( ImageDecoder& decoder, std::size_t budget );
+    ~ImageCache(); // Frees every image, in use or not.
+
+    // Returns the image at path, decoding it if it isn't cached.  0 if the decoder can't load it.
+    Gdiplus::Bitmap* Acquire( const std::wstring& path );
+    void Release( Gdiplus::Bitmap* bitmap );                // Ignores 0, and bitmaps from elsewhere.
+    void Release( std::vector<Gdiplus::Bitmap*>& bitmaps ); // Releases each, then empties bitmaps.
+    bool Contains( const std::wstring& path ) const;
+    // Takes ownership of a bitmap decoded elsewhere (see ImagePreloader), cached as not in use.
+    // Frees it instead if path is already cached.
+    void Adopt( const std::wstring& path, Gdiplus::Bitmap* bitmap );
+
+    void SetBudget( std::size_t budget ); // Frees unused images at once if over the new budget.
+    std::size_t Budget() const;
+    std::size_t Bytes() const;            // Held by every decoded image, in use or not.
+    std::size_t Size() const;             // Number of images decoded
+    unsigned int Hits() const;            // Acquires of images already decoded
+    unsigned int Misses() const;          // Acquires that had to decode
+    unsigned int Evictions() const;       // Unused images freed to stay within budget
+
+private:
+    typedef std::list<std::wstring> UnusedList; // Paths of images with no references, most recently used first
+    struct Entry{
+        Gdiplus::Bitmap* bitmap_;
+        std::size_t bytes_;
+        unsigned int references_;
+        UnusedList::iterator unused_; // Only valid while references_ is 0
+    };
+    typedef std::map<std::wstring, Entry> EntryMap;
+    typedef std::map<const Gdiplus::Bitmap*, EntryMap::iterator> BitmapMap;
+
+    void Evict(); // Frees unused images, least recently used first, until within budget
+
+    ImageCache( const ImageCache& );            // Not copyable
+    ImageCache& operator=( const ImageCache& );
+
+private:
+    ImageDecoder& decoder_;
+    std::size_t budget_;
+    std::size_t bytes_;
+    EntryMap entries_;
+    BitmapMap bitmaps_; // Finds an entry from its bitmap, for Release
+    UnusedList unused_;
+    unsigned int hits_, misses_, evictions_;
+};
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,35 @@
+// ImageDecoder.cpp
+
+#include <windows.h>
+#include <gdiplus.h>
+#include "ImageDecoder.h"
+
+using namespace std;
+using namespace Gdiplus;
+
+Gdiplus::Bitmap* GdiplusDecoder::Decode( const std::wstring& path ){
+    Bitmap* file = new Bitmap( path.c_str() );
+    if( file->GetLastStatus() != Ok )
+        return file;
+    INT width = static_cast<INT>( file->GetWidth() ), height = static_cast<INT>( file->GetHeight() );
+    Bitmap* decoded = new Bitmap( width, height, PixelFormat32bppPARGB );
+    if( decoded->GetLastStatus() != Ok ){
+        delete decoded;
+        return file;
+    }
+    decoded->SetResolution( file->GetHorizontalResolution(), file->GetVerticalResolution() ); // Keeps drawn sizes the same
+    {
+        Graphics graphics( decoded );
+        graphics.DrawImage( file, 0, 0, width, height );
+    }
+    delete file;
+    return decoded;
+}
+
+std::size_t GdiplusDecoder::Bytes( Gdiplus::Bitmap* bitmap ){
+    return static_cast<size_t>( bitmap->GetWidth() ) * bitmap->GetHeight() * 4;
+}
+
+void GdiplusDecoder::Free( Gdiplus::Bitmap* bitmap ){
+    delete bitmap;
+}
@@ -0,0 +1,35 @@
+// ImageDecoder.h
+// Loads image files for an ImageCache.  GdiplusDecoder is the one the program uses; the cache only
+// sees this interface, so it can be run with any decoder that hands back distinct pointers.
+
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+#include <string>
+#include <cstddef>
+
+namespace Gdiplus{
+    class Bitmap;
+}
+
+class ImageDecoder{
+public:
+    virtual ~ImageDecoder() {}
+
+    virtual Gdiplus::Bitmap* Decode( const std::wstring& path ) = 0;  // 0 if path can't be loaded
+    virtual std::size_t Bytes( Gdiplus::Bitmap* bitmap ) = 0;         // Memory held by a decoded bitmap
+    virtual void Free( Gdiplus::Bitmap* bitmap ) = 0;
+};
+
+// Safe to use from more than one thread, as each call works on its own bitmaps.
+class GdiplusDecoder : public ImageDecoder{
+public:
+    // GDI+ only decodes a file when it is first drawn, so Decode draws it once into a bitmap of its own;
+    // the work is done here, where a preloading thread can do it, and the file is not held open.
+    // A file GDI+ can't read still gives a Bitmap, with an error status and no size, as new Bitmap did.
+    virtual Gdiplus::Bitmap* Decode( const std::wstring& path );
+    virtual std::size_t Bytes( Gdiplus::Bitmap* bitmap ); // 4 bytes a pixel, as GDI+ holds them once drawn
+    virtual void Free( Gdiplus::Bitmap* bitmap );
+};
+
+#endif // IMAGEDECODER_H
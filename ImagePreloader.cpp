@@ -0,0 +1,81 @@
+// ImagePreloader.cpp
+
+#include "ImagePreloader.h"
+#include "ImageDecoder.h"
+#include "ImageCache.h"
+#include <algorithm>
+
+using namespace std;
+
+ImagePreloader::ImagePreloader( ImageDecoder& decoder )
+: decoder_(decoder), stopping_(false), thread_( &ImagePreloader::Run, this )
+{}
+
+ImagePreloader::~ImagePreloader(){
+    {
+        lock_guard<mutex> lock( mutex_ );
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    for( DecodedList::iterator iter = decoded_.begin(); iter != decoded_.end(); ++iter )
+        decoder_.Free( iter->second );
+}
+
+void ImagePreloader::Request( const StringVec& paths, const ImageCache& cache ){
+    {
+        lock_guard<mutex> lock( mutex_ );
+        queue_.clear();
+        for( StringVec::const_iterator iter = paths.begin(); iter != paths.end(); ++iter ){
+            if( cache.Contains( *iter ) || *iter == decoding_ )
+                continue;
+            if( find( queue_.begin(), queue_.end(), *iter ) != queue_.end() )
+                continue;
+            bool decoded = false;
+            for( DecodedList::iterator done = decoded_.begin(); done != decoded_.end() && !decoded; ++done )
+                decoded = done->first == *iter;
+            if( !decoded )
+                queue_.push_back( *iter );
+        }
+    }
+    wake_.notify_one();
+}
+
+void ImagePreloader::Deliver( ImageCache& cache ){
+    DecodedList decoded;
+    {
+        lock_guard<mutex> lock( mutex_ );
+        decoded.swap( decoded_ );
+    }
+    for( DecodedList::iterator iter = decoded.begin(); iter != decoded.end(); ++iter )
+        cache.Adopt( iter->first, iter->second );
+}
+
+bool ImagePreloader::Busy(){
+    lock_guard<mutex> lock( mutex_ );
+    return !queue_.empty() || !decoding_.empty();
+}
+
+void ImagePreloader::Run( ImagePreloader* preloader ){
+    preloader->Decode();
+}
+
+void ImagePreloader::Decode(){
+    unique_lock<mutex> lock( mutex_ );
+    while( true ){
+        while( queue_.empty() && !stopping_ )
+            wake_.wait( lock );
+        if( stopping_ )
+            return;
+        decoding_ = queue_.front();
+        queue_.pop_front();
+
+        lock.unlock(); // Decoding is the slow part; Request and Deliver can go ahead meanwhile.
+        Gdiplus::Bitmap* bitmap = decoder_.Decode( decoding_ );
+        lock.lock();
+
+        if( bitmap )
+            decoded_.push_back( make_pair( decoding_, bitmap ) );
+        decoding_.clear();
+    }
+}
@@ -0,0 +1,51 @@
+// ImagePreloader.h
+// Decodes images on a background thread before they are needed - the images of the modes the
+// speller is likely to go to next - so switching mode finds them already in the ImageCache.
+// The cache itself is only touched by Deliver, on the thread that owns it.
+
+#ifndef IMAGEPRELOADER_H
+#define IMAGEPRELOADER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Definitions.h"
+
+class ImageDecoder;
+class ImageCache;
+
+class ImagePreloader{
+public:
+    explicit ImagePreloader( ImageDecoder& decoder ); // decoder must be safe to use from two threads at once
+    ~ImagePreloader(); // Stops the thread, and frees anything decoded but not delivered.
+
+    // Queues each path not already in cache or queued.  Earlier requests still waiting are dropped.
+    void Request( const StringVec& paths, const ImageCache& cache );
+    // Hands every image decoded so far to cache.  Call from the thread that uses the cache.
+    void Deliver( ImageCache& cache );
+    bool Busy(); // True while requests are waiting or being decoded
+
+private:
+    typedef std::vector<std::pair<std::wstring, Gdiplus::Bitmap*> > DecodedList;
+    static void Run( ImagePreloader* preloader ); // Thread entry point
+    void Decode();                                // Works through queue_ until stopping_
+
+    ImagePreloader( const ImagePreloader& );
+    ImagePreloader& operator=( const ImagePreloader& );
+
+private:
+    ImageDecoder& decoder_;
+    std::mutex mutex_;                // Guards everything below
+    std::condition_variable wake_;
+    std::deque<std::wstring> queue_;
+    std::wstring decoding_;           // Path being decoded now, or empty
+    DecodedList decoded_;             // Waiting for Deliver
+    bool stopping_;
+    std::thread thread_;              // Last, so it starts after everything it uses
+};
+
+#endif // IMAGEPRELOADER_H
@@ -0,0 +1,130 @@
+// InlineVector.h
+// A vector that keeps up to N elements inside itself, and only uses the heap beyond that.
+// For short, often-copied lists, such as the letters of an analysed word.
+// T must be safe to copy with memcpy and need no destructor (plain structs of numbers and enums).
+
+#ifndef INLINEVECTOR_H
+#define INLINEVECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+template <typename T, std::size_t N>
+class InlineVector{
+public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::size_t size_type;
+
+    InlineVector() : data_(Inline()), size_(0), capacity_(N) {}
+
+    InlineVector( const InlineVector& rhs ) : data_(Inline()), size_(0), capacity_(N) {
+        Assign( rhs.data_, rhs.size_ );
+    }
+
+    // Takes rhs's heap storage, if it has any, leaving rhs empty.
+    InlineVector( InlineVector&& rhs ) : data_(Inline()), size_(0), capacity_(N) {
+        Take( rhs );
+    }
+
+    ~InlineVector(){
+        Release();
+    }
+
+    InlineVector& operator=( const InlineVector& rhs ){
+        if( this != &rhs )
+            Assign( rhs.data_, rhs.size_ );
+        return *this;
+    }
+
+    InlineVector& operator=( InlineVector&& rhs ){
+        if( this != &rhs ){
+            Release();
+            Take( rhs );
+        }
+        return *this;
+    }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    bool OnHeap() const { return data_ != Inline(); }
+
+    T& operator[]( size_type i ) { return data_[i]; }
+    const T& operator[]( size_type i ) const { return data_[i]; }
+
+    void push_back( const T& value ){
+        if( size_ == capacity_ )
+            Grow( capacity_ * 2 );
+        data_[size_++] = value;
+    }
+
+    void clear(){
+        size_ = 0; // Keeps any heap storage for reuse
+    }
+
+    iterator erase( iterator first, iterator last ){
+        std::memmove( first, last, ( end() - last ) * sizeof(T) );
+        size_ -= last - first;
+        return first;
+    }
+
+private:
+    T* Inline() { return reinterpret_cast<T*>( &buffer_ ); }
+    const T* Inline() const { return reinterpret_cast<const T*>( &buffer_ ); }
+
+    void Assign( const T* data, size_type size ){
+        if( size > capacity_ )
+            Grow( size );
+        std::memcpy( data_, data, size * sizeof(T) );
+        size_ = size;
+    }
+
+    void Take( InlineVector& rhs ){
+        if( rhs.OnHeap() ){
+            data_ = rhs.data_;
+            capacity_ = rhs.capacity_;
+            rhs.data_ = rhs.Inline();
+            rhs.capacity_ = N;
+        }
+        else{
+            data_ = Inline();
+            capacity_ = N;
+            std::memcpy( data_, rhs.data_, rhs.size_ * sizeof(T) );
+        }
+        size_ = rhs.size_;
+        rhs.size_ = 0;
+    }
+
+    void Grow( size_type capacity ){
+        T* data = static_cast<T*>( ::operator new( capacity * sizeof(T) ) );
+        std::memcpy( data, data_, size_ * sizeof(T) );
+        Release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void Release(){
+        if( OnHeap() )
+            ::operator delete( data_ );
+        data_ = Inline();
+        capacity_ = N;
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T) * N, std::alignment_of<T>::value>::type buffer_;
+    T* data_;          // buffer_, or heap storage once more than N elements have been needed
+    size_type size_;
+    size_type capacity_;
+};
+
+#endif // INLINEVECTOR_H
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <sstream>
 #include "Definitions.h"
+#include "KeyboardLayout.h"
 
 
 
@@ -110,7 +111,7 @@ Keyboard::Keyboard()
   mBrushY(0.0f), mBrushWidth(19.0f), mBrushHeight(19.0f), mHighlightThickness(0.0f),
   mTextNormal(Color(0,0,0)), mTextDisable(Color(200,200,200)), mTextClick(Color(255,255,0)),
   mHighlight(Color(0,0,0)),
-  mShiftHeld(false)
+  mShiftHeld(false), mHoverKey(0), mHoverStale(true)
   {}
  
  Keyboard::~Keyboard() {
@@ -199,12 +200,20 @@ void Keyboard::AddKey(int row, int col,
                 KeyStatus status, std::wstring text, bool displayIsChar,
                 int scaleWidth, int scaleHeight) {
     mKeys[current] = Key(row, col, current, alternate,  status, text, displayIsChar, scaleWidth, scaleHeight);
+    mUpdated = false;
 }
 
 void Keyboard::Update(const Gdiplus::PointF* mousePos) {
-    KeyList::iterator iter;
-    for(iter = mKeys.begin(); iter != mKeys.end(); ++iter ) {
-        iter->second.Update(mousePos);
+    // Hover can only change when the cursor moves, or the keys do.
+    if( mHoverStale || !mUpdated || !mLastMouse.Equals(*mousePos) ) {
+        Key* hit = HitKey(*mousePos);
+        if( mHoverKey && mHoverKey != hit && mHoverKey->mStatus == Hover )
+            mHoverKey->mStatus = Normal;
+        if( hit )
+            hit->Update(mousePos);
+        mHoverKey = hit;
+        mLastMouse = *mousePos;
+        mHoverStale = false;
     }
     
     // Checks keyboard case matches caps lock and shift positions
@@ -213,6 +222,15 @@ void Keyboard::Update(const Gdiplus::PointF* mousePos) {
     }
 }
 
+Gdiplus::RectF Keyboard::HoverBounds() const {
+    if( !mHoverKey || mHoverKey->mStatus != Hover )
+        return RectF();
+    // As Button::Bounds: the highlight pen is centred on a rectangle mHighlightThickness out from the key.
+    float edge = 2.0f * mHighlightThickness;
+    return RectF(mHoverKey->mPos.X - edge, mHoverKey->mPos.Y - edge,
+                 mHoverKey->mWidth + 2.0f * edge, mHoverKey->mHeight + 2.0f * edge);
+}
+
 void Keyboard::Display(BackBuffer *bb) {
     if( !mKeyGfx || !mVisible || !mFont ) return;
     // Ensure keys size and position are up to date
@@ -271,6 +289,16 @@ void Keyboard::CalculateKeys() {
                            mKeyGap, mRowGap, offset, mPosition);
     }
 
+    // Index the key rectangles for hit-testing
+    mHitGrid.Clear();
+    mHitKeys.clear();
+    for(keyIter = mKeys.begin(); keyIter != mKeys.end(); ++keyIter) {
+        mHitGrid.Add(keyIter->second.mPos.X, keyIter->second.mPos.Y, keyIter->second.mWidth, keyIter->second.mHeight);
+        mHitKeys.push_back(&keyIter->second);
+    }
+    mHitGrid.Build();
+    mHoverStale = true;
+
     // Update the highlight thickness - this is half the width of the row or key gap,
     // whichever is the smaller.
     mHighlightThickness = ( (mKeyGap * mStandardKeyWidth) <= (mRowGap * mStandardKeyHeight) ? 
@@ -293,12 +321,9 @@ bool Keyboard::IsUpper() { return mUppercase; }
 
 wchar_t Keyboard::KeyClick(const Gdiplus::PointF* mousePos) {
     wchar_t key = '\0';
-    KeyList::iterator keyIter;
-    for(keyIter = mKeys.begin(); keyIter != mKeys.end(); ++keyIter) {
-        keyIter->second.Click(mousePos, key);
-        if( key != '\0' )
-            return key;
-    }
+    Key* hit = HitKey(*mousePos);
+    if( hit )
+        hit->Click(mousePos, key);
     return key;
 }
 
@@ -313,6 +338,7 @@ void Keyboard::KeyRelease() {
     for(keyIter = mKeys.begin(); keyIter != mKeys.end(); ++keyIter) {
         keyIter->second.Release();
     }
+    mHoverStale = true; // The released key may be under the cursor
 }
 
 void Keyboard::Keystroke(unsigned int key) {
@@ -341,6 +367,7 @@ void Keyboard::DisableAllKeys() {
     for(iter = mKeys.begin(); iter != mKeys.end(); ++iter ) {
         iter->second.Disable();
     }
+    mHoverStale = true;
 }
 
 void Keyboard::EnableAllKeys() {
@@ -348,6 +375,7 @@ void Keyboard::EnableAllKeys() {
     for(iter = mKeys.begin(); iter != mKeys.end(); ++iter ) {
         iter->second.Enable();
     }
+    mHoverStale = true;
 }
 
 void Keyboard::ResetKeys() {
@@ -355,11 +383,13 @@ void Keyboard::ResetKeys() {
     for(iter = mKeys.begin(); iter != mKeys.end(); ++iter ) {
         iter->second.ResetStatus();
     }
+    mHoverStale = true;
 }
 
 bool Keyboard::DisableKey( wchar_t keyChar ) {
     if ( KeyExists( keyChar ) ) {
         mKeys[keyChar].Disable();
+        mHoverStale = true;
         return true;
     }
     return false;
@@ -368,6 +398,7 @@ bool Keyboard::DisableKey( wchar_t keyChar ) {
 bool Keyboard::EnableKey( wchar_t keyChar ) {
     if( KeyExists( keyChar ) ) {
         mKeys[keyChar].Enable();
+        mHoverStale = true;
         return true;
     }
     return false;
@@ -376,12 +407,49 @@ bool Keyboard::EnableKey( wchar_t keyChar ) {
 bool Keyboard::ResetKey(wchar_t keyChar) {
     if( KeyExists( keyChar ) ) {
         mKeys[keyChar].ResetStatus();
+        mHoverStale = true;
         return true;
     }
     return false;
 }
 
+std::size_t Keyboard::KeyCount() const {
+    return mKeys.size();
+}
+
+int Keyboard::KeyIndex( wchar_t keyChar ) {
+    if( !KeyExists( keyChar ) )
+        return -1;
+    return static_cast<int>( distance( mKeys.begin(), mKeys.find( keyChar ) ) );
+}
+
+void Keyboard::EnableKeys( const KeyMask& enabled ) {
+    if( enabled.size() != mKeys.size() ) return;
+    
+    KeyMask::const_iterator flag = enabled.begin();
+    for( KeyList::iterator iter = mKeys.begin(); iter != mKeys.end(); ++iter, ++flag ) {
+        if( *flag )
+            iter->second.Enable();
+        else
+            iter->second.Disable();
+    }
+    mHoverStale = true;
+}
+
+void Keyboard::EnabledKeys( KeyMask& enabled ) const {
+    enabled.clear();
+    for( KeyList::const_iterator iter = mKeys.begin(); iter != mKeys.end(); ++iter )
+        enabled.push_back( iter->second.mStatus != Disabled );
+}
+
 // Private Functions
+Key* Keyboard::HitKey( const Gdiplus::PointF& pos ) {
+    if( !mUpdated )
+        CalculateKeys();
+    int index = mHitGrid.Find(pos.X, pos.Y);
+    return index < 0 ? 0 : mHitKeys[index];
+}
+
 bool Keyboard::KeyExists( wchar_t& keyChar ) {
     size_t check = mKeys.count(keyChar); // see if there's a (map) key with this character
     
@@ -402,131 +470,21 @@ bool Keyboard::KeyExists( wchar_t& keyChar ) {
 }
 
 bool Keyboard::LoadKeyboard( const std::string fileName ) {
-    // Get text file
-    ifstream inFile(fileName.c_str());
-    if( !inFile ) return false; // Couldn't load file.
-    
-    // Extract unicode text and store in wstring
-    stringstream ss;
-    ss << inFile.rdbuf() << '\0';
-    wstring ws = wstring((wchar_t *)ss.str().c_str());
-    
-    if( ws.length() <= 1 ) return false; // not enough content for a meaningful keyboard!
-    
-    // Remove BOM marker from first position
-    ws = ws.substr(1);
-    
-    // Set up key location variables
-    int row, col;
-    row = 0;
-    col = 1;
-    
-    while( !ws.empty() ) {
-        // Get a complete line from the text
-        size_t eol = ws.find(L'\n');
-        //if( eol == string::npos ) return false; // End of line not found.
-        wstring sub = ws.substr(0,eol-1); //  copy everything except the carriage return
-        ws = ws.substr(eol+1);      // Cut off this line (doesn't work for last line, hence the check below)
-        if( ws == sub ) ws.clear(); // Last line has been read.
-        // Check for "newrow"
-        if ( sub.length() >= 6 && sub.substr(0,6) == L"newrow") {
-            ++row;
-            if( sub.length() >= 7 )
-                sub = sub.substr(7);
-            else
-                sub.clear();
-            float f = static_cast<float>( _wtof( sub.c_str() ) );
-            AddRow(f);
-            col = 1; // reset col to first position
-        }
-        else if( !sub.empty() ) { // Create a key
-            if( row == 0 ) { ++row; AddRow(); } // Insert the first row, if the text file omits it.
-            
-            // Set up default Key variables
-            wchar_t current =  L'';
-            wchar_t alternate = L'';
-            KeyStatus status = Normal;
-            wstring displayText = L"";
-            bool displayIsChar = true;
-            int scaleWidth = 1;
-            int scaleHeight = 1;
-            if( BuildKey(current, alternate, status, displayText, displayIsChar, scaleWidth, scaleHeight, sub) ) {
-                AddKey(row, col, current, alternate, status, displayText, displayIsChar, scaleWidth, scaleHeight);
-                col = col + scaleHeight; // Advance col counter.
-            }
-        }   
-    }
-    return true;
+    KeyboardLayout layout;
+    return layout.Compile(fileName) && LoadKeyboard(&layout);
 }
 
-wstring Keyboard::GetNextValue(std::wstring &str) {
-    if( str.empty() ) return L"\0";
+bool Keyboard::LoadKeyboard( const KeyboardLayout* layout ) {
+    if( !layout ) return false;
     
-    size_t cutPos = str.find(L',');
-    wstring value = str.substr(0, cutPos);
-    if( cutPos == string.npos ) {
-        str.clear();
-    }
-    else {
-        str = str.substr(cutPos+1);
-    }
-    return value;
-}
-
-bool Keyboard::BuildKey( wchar_t& current, wchar_t& alternate,
-                         KeyStatus& status, wstring& displayText, bool& displayIsChar,
-                         int& scaleWidth, int& scaleHeight, wstring& str ) {
-
-    // Find current character
-    wstring temp = GetNextValue(str);
-    if( temp.empty() ) return false; // No data found, so no key to build.
-    if( temp[0] == '\'' || temp[0] == '\"' ) {// Quotes mean the character is explicitly given
-        current = temp[1];
-        displayText = current; // Set display text, in case there isn't one later.
-    }
-    else {
-        current = (wchar_t)(_wtoi(temp.c_str()));  // Lack of quotes means a control character
-    }
+    const vector<float>& rowOffsets = layout->RowOffsets();
+    for( vector<float>::const_iterator iter = rowOffsets.begin(); iter != rowOffsets.end(); ++iter )
+        AddRow(*iter);
     
-    // Find alternate character
-    temp = GetNextValue(str);
-    if( temp.empty() ) {
-        alternate = toupper(current);
-        return true; // Key only contains "current character"
+    const vector<KeyboardLayout::KeyRecord>& keys = layout->Keys();
+    for( vector<KeyboardLayout::KeyRecord>::const_iterator iter = keys.begin(); iter != keys.end(); ++iter ) {
+        AddKey(iter->row_, iter->col_, iter->current_, iter->alternate_, iter->disabled_ ? Disabled : Normal,
+               layout->DisplayText(*iter), iter->displayIsChar_, iter->scaleWidth_, iter->scaleHeight_);
     }
-    if( temp[0] == '\'' || temp[0] == '\"' )
-        alternate = temp[1];
-    else
-        alternate = (wchar_t)(_wtoi(temp.c_str() ) );
- 
-    //Find KeyStatus
-    temp = GetNextValue(str);
-    if( temp.empty() ) return true; // No more data found.
-    if( temp == L"Disabled" )
-        status = Disabled;
-
-    //Find Display Text (and set displayIsChar)
-    temp = GetNextValue(str);
-    if( temp.empty() ) return true; // No more data found;
-    displayText = temp;
-    // Strip any quote marks.
-    displayText.erase( remove( displayText.begin(), displayText.end(), L'\"'), displayText.end() );
-    displayText.erase( remove( displayText.begin(), displayText.end(), L'\''), displayText.end() );
-    // Check if display text matches current character
-    wstring check = L"";
-    check = current; 
-    if( check != displayText )
-        displayIsChar = false; // If not, the display text is not the character.
-    
-    // Find width
-    temp = GetNextValue(str);
-    if( temp.empty() ) return true; // No more data found;
-    scaleWidth = _wtoi(temp.c_str());
-    
-    // Find height
-    temp = GetNextValue(str);
-    if( temp.empty() ) return true; // No more data found;
-    scaleHeight = _wtoi(temp.c_str());
-
     return true;
-}
\ No newline at end of file
+}
@@ -10,6 +10,7 @@
 #include <map>
 #include <fstream>
 #include "BackBuffer.h"
+#include "HitGrid.h"
 
 // class Key
 
@@ -58,6 +59,9 @@ protected:
 };
 
 typedef std::map<char,Key> KeyList;
+typedef std::vector<bool> KeyMask; // One flag per key, in KeyList order
+
+class KeyboardLayout;
 
 class Keyboard {
 
@@ -98,6 +102,7 @@ public:
     // "In loop" functions
     void Update (const Gdiplus::PointF* mousePos);
     void Display( BackBuffer* bb );
+    Gdiplus::RectF HoverBounds() const; // Area the key highlighted under the cursor draws in.  Empty if none.
     
     
     void CalculateKeys();   // (Re)calculates all key positions.
@@ -117,6 +122,13 @@ public:
     bool DisableKey( wchar_t keyChar ); // These functions check if a key exists,
     bool EnableKey ( wchar_t keyChar ); // returning true if found, as well as changing the status.
     bool ResetKey  ( wchar_t keyChar ); // Return false if key isn't found.
+
+    // Key masks, for setting every key's status in one pass.  KeyIndex finds a character's flag the way
+    // EnableKey finds its key, and returns -1 if there is no key for it.
+    std::size_t KeyCount() const;
+    int  KeyIndex( wchar_t keyChar );
+    void EnableKeys( const KeyMask& enabled ); // Enables the flagged keys, disables the rest.  Ignores masks of the wrong size.
+    void EnabledKeys( KeyMask& enabled ) const; // Flags the keys that aren't disabled
     
     /* Load Keyboard from text file
         The txt file must be saved in "Unicode - Codepage 1200" encoding.
@@ -138,13 +150,11 @@ public:
         "a","A",Disabled,"a",1,1    
     */
     bool LoadKeyboard( const std::string fileName );
+    bool LoadKeyboard( const KeyboardLayout* layout ); // A layout already compiled from a file, see KeyboardLayouts.  False if 0.
     
 private:
+    Key* HitKey( const Gdiplus::PointF& pos ); // The key at pos, or 0
     bool KeyExists ( wchar_t& keyChar ); // Used to check if a key exists.
-    std::wstring GetNextValue( std::wstring& str ); // Extracts information from a keyboard textfile
-    bool Keyboard::BuildKey( wchar_t& current, wchar_t& alternate,
-                         KeyStatus& status, std::wstring& displayText, bool& displayIsChar,
-                         int& scaleWidth, int& scaleHeight, std::wstring& str );
     
 public:
     KeyList mKeys; // stores each key
@@ -171,6 +181,12 @@ private:
     
     bool mShiftHeld;
 
+    HitGrid mHitGrid;               // Key rectangles, made by CalculateKeys
+    std::vector<Key*> mHitKeys;     // The key for each mHitGrid rectangle
+    Key* mHoverKey;                 // The key the cursor was last over, or 0
+    Gdiplus::PointF mLastMouse;     // Where the cursor was at the last hover test
+    bool mHoverStale;               // Key statuses changed, so hover needs testing even if the cursor hasn't moved
+
 };
 
 #endif // KEYBOARD_H
\ No newline at end of file
@@ -0,0 +1,178 @@
+// KeyboardLayout.cpp
+
+#include "KeyboardLayout.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+bool KeyboardLayout::Compile( const std::string& fileName ){
+    rowOffsets_.clear();
+    keys_.clear();
+    texts_.clear();
+
+    // Get text file
+    ifstream inFile(fileName.c_str());
+    if( !inFile ) return false; // Couldn't load file.
+    
+    // Extract unicode text and store in wstring
+    stringstream ss;
+    ss << inFile.rdbuf() << '\0';
+    wstring ws = wstring((wchar_t *)ss.str().c_str());
+    
+    if( ws.length() <= 1 ) return false; // not enough content for a meaningful keyboard!
+    
+    // Remove BOM marker from first position
+    ws = ws.substr(1);
+    
+    // Set up key location variables
+    int row, col;
+    row = 0;
+    col = 1;
+    
+    while( !ws.empty() ) {
+        // Get a complete line from the text
+        size_t eol = ws.find(L'\n');
+        //if( eol == string::npos ) return false; // End of line not found.
+        wstring sub = ws.substr(0,eol-1); //  copy everything except the carriage return
+        ws = ws.substr(eol+1);      // Cut off this line (doesn't work for last line, hence the check below)
+        if( ws == sub ) ws.clear(); // Last line has been read.
+        // Check for "newrow"
+        if ( sub.length() >= 6 && sub.substr(0,6) == L"newrow") {
+            ++row;
+            if( sub.length() >= 7 )
+                sub = sub.substr(7);
+            else
+                sub.clear();
+            float f = static_cast<float>( _wtof( sub.c_str() ) );
+            rowOffsets_.push_back(f);
+            col = 1; // reset col to first position
+        }
+        else if( !sub.empty() ) { // Create a key
+            if( row == 0 ) { ++row; rowOffsets_.push_back(0.0f); } // Insert the first row, if the text file omits it.
+            
+            // Set up default Key variables
+            wchar_t current =  L'';
+            wchar_t alternate = L'';
+            bool disabled = false;
+            wstring displayText = L"";
+            bool displayIsChar = true;
+            int scaleWidth = 1;
+            int scaleHeight = 1;
+            if( BuildKey(current, alternate, disabled, displayText, displayIsChar, scaleWidth, scaleHeight, sub) ) {
+                KeyRecord key = { static_cast<short>(row), static_cast<short>(col), current, alternate, disabled, displayIsChar,
+                                  static_cast<short>(scaleWidth), static_cast<short>(scaleHeight),
+                                  static_cast<unsigned int>(texts_.size()), static_cast<unsigned int>(displayText.size()) };
+                keys_.push_back(key);
+                texts_ += displayText;
+                col = col + scaleHeight; // Advance col counter.
+            }
+        }   
+    }
+    return true;
+}
+
+wstring KeyboardLayout::GetNextValue(std::wstring &str) {
+    if( str.empty() ) return L"\0";
+    
+    size_t cutPos = str.find(L',');
+    wstring value = str.substr(0, cutPos);
+    if( cutPos == wstring::npos ) {
+        str.clear();
+    }
+    else {
+        str = str.substr(cutPos+1);
+    }
+    return value;
+}
+
+bool KeyboardLayout::BuildKey( wchar_t& current, wchar_t& alternate,
+                               bool& disabled, wstring& displayText, bool& displayIsChar,
+                               int& scaleWidth, int& scaleHeight, wstring& str ) {
+
+    // Find current character
+    wstring temp = GetNextValue(str);
+    if( temp.empty() ) return false; // No data found, so no key to build.
+    if( temp[0] == '\'' || temp[0] == '\"' ) {// Quotes mean the character is explicitly given
+        current = temp[1];
+        displayText = current; // Set display text, in case there isn't one later.
+    }
+    else {
+        current = (wchar_t)(_wtoi(temp.c_str()));  // Lack of quotes means a control character
+    }
+    
+    // Find alternate character
+    temp = GetNextValue(str);
+    if( temp.empty() ) {
+        alternate = toupper(current);
+        return true; // Key only contains "current character"
+    }
+    if( temp[0] == '\'' || temp[0] == '\"' )
+        alternate = temp[1];
+    else
+        alternate = (wchar_t)(_wtoi(temp.c_str() ) );
+ 
+    //Find KeyStatus
+    temp = GetNextValue(str);
+    if( temp.empty() ) return true; // No more data found.
+    if( temp == L"Disabled" )
+        disabled = true;
+
+    //Find Display Text (and set displayIsChar)
+    temp = GetNextValue(str);
+    if( temp.empty() ) return true; // No more data found;
+    displayText = temp;
+    // Strip any quote marks.
+    displayText.erase( remove( displayText.begin(), displayText.end(), L'\"'), displayText.end() );
+    displayText.erase( remove( displayText.begin(), displayText.end(), L'\''), displayText.end() );
+    // Check if display text matches current character
+    wstring check = L"";
+    check = current; 
+    if( check != displayText )
+        displayIsChar = false; // If not, the display text is not the character.
+    
+    // Find width
+    temp = GetNextValue(str);
+    if( temp.empty() ) return true; // No more data found;
+    scaleWidth = _wtoi(temp.c_str());
+    
+    // Find height
+    temp = GetNextValue(str);
+    if( temp.empty() ) return true; // No more data found;
+    scaleHeight = _wtoi(temp.c_str());
+
+    return true;
+}
+
+const std::vector<float>& KeyboardLayout::RowOffsets() const{
+    return rowOffsets_;
+}
+
+const std::vector<KeyboardLayout::KeyRecord>& KeyboardLayout::Keys() const{
+    return keys_;
+}
+
+std::wstring KeyboardLayout::DisplayText( const KeyRecord& key ) const{
+    return texts_.substr( key.textStart_, key.textLength_ );
+}
+
+KeyboardLayouts::KeyboardLayouts()
+{}
+
+const KeyboardLayout* KeyboardLayouts::Get( const std::string& fileName ){
+    LayoutMap::iterator iter = layouts_.find( fileName );
+    if( iter != layouts_.end() )
+        return &iter->second;
+
+    KeyboardLayout layout;
+    if( !layout.Compile( fileName ) )
+        return 0;
+    return &layouts_.insert( make_pair( fileName, layout ) ).first->second;
+}
+
+std::size_t KeyboardLayouts::Size() const{
+    return layouts_.size();
+}
@@ -0,0 +1,63 @@
+// KeyboardLayout.h
+// A keyboard layout text file (see Keyboard::LoadKeyboard) compiled into flat key records, so a Keyboard
+// can be loaded from it without parsing the text again.
+// KeyboardLayouts compiles each file the first time it's asked for and keeps it, so only the first
+// MiniSpell or NewSpeller reads the files - the rest load their keyboards from memory.
+
+#ifndef KEYBOARDLAYOUT_H
+#define KEYBOARDLAYOUT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+class KeyboardLayout{
+public:
+    struct KeyRecord{
+        short row_, col_;
+        wchar_t current_, alternate_;
+        bool disabled_;
+        bool displayIsChar_;
+        short scaleWidth_, scaleHeight_;
+        unsigned int textStart_, textLength_; // Display text, in texts_
+    };
+
+    // Returns false if the file can't be read, or has too little in it to be a keyboard.
+    bool Compile( const std::string& fileName );
+
+    const std::vector<float>& RowOffsets() const;   // One per row, in order
+    const std::vector<KeyRecord>& Keys() const;      // In file order
+    std::wstring DisplayText( const KeyRecord& key ) const;
+
+private:
+    static std::wstring GetNextValue( std::wstring& str ); // Cuts the next comma separated value from str
+    static bool BuildKey( wchar_t& current, wchar_t& alternate,
+                          bool& disabled, std::wstring& displayText, bool& displayIsChar,
+                          int& scaleWidth, int& scaleHeight, std::wstring& str );
+
+private:
+    std::vector<float> rowOffsets_;
+    std::vector<KeyRecord> keys_;
+    std::wstring texts_;             // Every key's display text, end to end
+};
+
+class KeyboardLayouts{
+public:
+    KeyboardLayouts();
+
+    // The layout compiled from fileName, compiling it first if it hasn't been asked for before.
+    // 0 if it can't be compiled; the file is tried again next time.
+    const KeyboardLayout* Get( const std::string& fileName );
+    std::size_t Size() const;
+
+private:
+    KeyboardLayouts( const KeyboardLayouts& );            // Not copyable
+    KeyboardLayouts& operator=( const KeyboardLayouts& );
+
+private:
+    typedef std::map<std::string, KeyboardLayout> LayoutMap;
+    LayoutMap layouts_;
+};
+
+#endif // KEYBOARDLAYOUT_H
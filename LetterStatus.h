@@ -0,0 +1,17 @@
+// LetterStatus.h
+// How each letter of an attempt compares with the spelling.  Kept apart from Word.h, so code that only
+// works with statuses (FeedbackTimeline) needs nothing from Windows.
+
+#ifndef LETTERSTATUS_H
+#define LETTERSTATUS_H
+
+enum LetterStatus{ Null, Correct, Missing, Wrong, Swapped,
+                 ThreeAwayMissingF, ThreeAwayMissingB, ThreeAwayWrongF, ThreeAwayWrongB };
+// NOTE: the ThreeAwayMissing F and B are required for the animated feedback.
+// The F and B denote Front and Back of the threeaway group.  If the missing letter is first in the analysed letters
+// container, it gets an F(ront); if the ThreeAwayWrong appears first in the order, it gets a B(ack).
+// This aids the AnimatedFeedback object to know whether a particular ThreeAwayMissing letter has already been
+// animated, and should therefore be displayed in appropriate colours.
+// IMPORTANT - this means the ThreeAwaySearch MUST be done in forward (not reverse) order.
+
+#endif // LETTERSTATUS_H
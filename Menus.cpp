@@ -9,6 +9,8 @@
 #include "ScreenPrinter.h"
 #include "ScrollBox.h"
 #include "Utility.h"
+#include "ImageCache.h"
+#include "KeyboardLayout.h"
 
 using namespace Gdiplus;
 using namespace std;
@@ -16,17 +18,15 @@ using namespace std;
 //template <typename T>
 //static bool deleteAll( T* theElement ) { delete theElement; return true; }
 
-TopMenu::TopMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, BackBuffer* bb,
+TopMenu::TopMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, BackBuffer* bb,
                  const unsigned int numSpellers):
-    Mode(nextMode, previousMode, id),
+    Mode(nextMode, previousMode, id, images),
     numSpellers_(numSpellers) 
 {
-    pBackground_ = new Image(L"Images/MainMenu.jpg");
-    
-    // Get button images
-    pButtonImages_.push_back(new Bitmap(L"Images/btnSelectSpeller.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnNewSpeller.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnQuit.jpg"));
+    // Get background and button images
+    StringVec paths;
+    Images( paths );
+    AcquireImages( paths, pBackground_, pButtonImages_ );
     
     // Create buttons
     buttons_.push_back(Button(pButtonImages_[SELECT], PointF(113.0, 313.0)));
@@ -38,16 +38,22 @@ TopMenu::TopMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int
 
 
 
-TopMenu::~TopMenu(){
+void TopMenu::Images( StringVec& paths ){
+    paths.push_back(L"Images/MainMenu.jpg");
+    paths.push_back(L"Images/btnSelectSpeller.jpg");
+    paths.push_back(L"Images/btnNewSpeller.jpg");
+    paths.push_back(L"Images/btnQuit.jpg");
+}
 
-delete pBackground_;
-pBackground_ = 0;
+TopMenu::~TopMenu(){
 
-remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>);
+images_.Release( pBackground_ );
+images_.Release( pButtonImages_ );
 }
 
 void TopMenu::Update( double dt, const Gdiplus::PointF* cursorPos){
-    for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun_ref( &Button::Update ), cursorPos));
+    for( vector<Button>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( *iter, cursorPos );
 }
 
 
@@ -99,20 +105,19 @@ void TopMenu::Wheel(short zDelta, Gdiplus::PointF* mousePos){}
     Allows the creation of a new speller account
 */
 
-NewSpeller::NewSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, Font* font,
-                        DBController* db, ScreenPrinter* sp, unsigned int& spellerID,
+NewSpeller::NewSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
+                        KeyboardLayouts& layouts, Font* font, DBController* db, ScreenPrinter* sp, unsigned int& spellerID,
                         TagList& tagList):
-    Mode(nextMode, previousMode, id), mpFont_(font), keyboard_(0), pDB_(db), pScreenPrinter_(sp), pAvatar_(0),
+    Mode(nextMode, previousMode, id, images), mpFont_(font), keyboardLayouts_(layouts), keyboard_(0), pDB_(db), pScreenPrinter_(sp), pAvatar_(0),
     spellerName_(L""), avatarZone_(212.0, 186.0,128.0f, 128.0f), maxCharacters_(20),
     showNameExistsWarning_(false), spellerID_(spellerID), tagList_(tagList)
 {
-    pBackground_ = new Image(L"Images/NewSpeller.jpg");
-    pNameExists_ = new Image(L"Images/NameExists.png");
-    
-    // Get button images
-    pButtonImages_.push_back(new Bitmap(L"Images/btnOK.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnCancel.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnKeyboards.jpg"));
+    // Get background, button and warning images
+    StringVec paths;
+    Images( paths );
+    pNameExists_ = images_.Acquire( paths.back() );
+    paths.pop_back();
+    AcquireImages( paths, pBackground_, pButtonImages_ );
     
     // Create buttons
     buttons_.push_back(new Button(pButtonImages_[OK], PointF(250.0, 340.0)));
@@ -136,24 +141,29 @@ NewSpeller::NewSpeller(unsigned int& nextMode, unsigned int previousMode, unsign
     pDB_->GetSpellerNames(existingNames_);
 }
 
-NewSpeller::~NewSpeller(){
-
-delete pBackground_;
-pBackground_ = 0;
+void NewSpeller::Images( StringVec& paths ){
+    paths.push_back(L"Images/NewSpeller.jpg");
+    paths.push_back(L"Images/btnOK.jpg");
+    paths.push_back(L"Images/btnCancel.jpg");
+    paths.push_back(L"Images/btnKeyboards.jpg");
+    paths.push_back(L"Images/NameExists.png");
+}
 
-delete pNameExists_;
-pNameExists_ = 0;
+NewSpeller::~NewSpeller(){
 
-remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>);
+images_.Release( pBackground_ );
+images_.Release( pNameExists_ );
+images_.Release( pButtonImages_ );
 remove_if(buttons_.begin(), buttons_.end(), deleteAll<Button>);
 
-delete pAvatar_;
+images_.Release( pAvatar_ );
 }
 
 void NewSpeller::Update( double dt, const Gdiplus::PointF* cursorPos){
-    for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun( &Button::Update ), cursorPos));
+    for( vector<Button*>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( **iter, cursorPos );
     if( keyboard_ )
-        keyboard_->Update(cursorPos);
+        UpdateKeyboard( *keyboard_, cursorPos );
 }
 
 
@@ -225,14 +235,13 @@ void NewSpeller::GetNextAvatar(){
         if( iteratorCopy == idList_.end() )  // wraparound
             iteratorCopy = idList_.begin();
             
-        delete pAvatar_; // delete previous image
-        // Create new image
-        pAvatar_ = new Image((L"Images/avatars/"+pDB_->GetAvatarFilenameFromID(*iteratorCopy)).c_str());
+        images_.Release( pAvatar_ ); // release previous image
+        pAvatar_ = images_.Acquire( L"Images/avatars/"+pDB_->GetAvatarFilenameFromID(*iteratorCopy) );
         
         if( iteratorCopy == displayedAvatar_ ) // Prevents infinite loop
             break;
             
-    } while( pAvatar_->GetLastStatus() != Gdiplus::Ok );
+    } while( !pAvatar_ || pAvatar_->GetWidth() == 0 ); // Unreadable files have no size; their status is only reported once
     
     displayedAvatar_ = iteratorCopy; // copy back
 }
@@ -290,7 +299,7 @@ void NewSpeller::RMBDown(const Gdiplus::PointF* cursorPos){}
 void NewSpeller::Wheel(short zDelta, Gdiplus::PointF* mousePos){}
 
 void NewSpeller::KeyboardSetup(){
-    qwerty_.LoadKeyboard("Data/Keyboards/qwerty.txt");
+    qwerty_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/qwerty.txt"));
     qwerty_.SetFont(&FontFamily(L"Impact"),26.0);//mpFont_);
     qwerty_.SetKeySize(50.0f, 50.0f);
     qwerty_.SetPosition(PointF(150.0, 480.0));
@@ -298,7 +307,7 @@ void NewSpeller::KeyboardSetup(){
                         Color(0,0,0), Color(200,200,200), Color(200,200,0),
                         Color(200,200,0));
                         
-    abc_.LoadKeyboard("Data/Keyboards/abc.txt");
+    abc_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/abc.txt"));
     abc_.SetFont(&FontFamily(L"Impact"),26.0);//mpFont_);
     abc_.SetKeySize(50.0f, 50.0f);
     abc_.SetPosition(PointF(200.0, 450.0));
@@ -306,7 +315,7 @@ void NewSpeller::KeyboardSetup(){
                         Color(0,0,0), Color(200,200,200), Color(200,200,0),
                         Color(200,200,0));
 
-    special_.LoadKeyboard("Data/Keyboards/special.txt");
+    special_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/special.txt"));
     special_.SetFont(&FontFamily(L"Impact"),26.0);//mpFont_);
     special_.SetKeySize(50.0f, 45.0f);
     special_.SetPosition(PointF(400.0, 430.0));
@@ -382,15 +391,14 @@ void NewSpeller::SetDefaultDifficulty(){
     Allows the selection of an existing account
 */
 
-SelectSpeller::SelectSpeller(unsigned int &nextMode, unsigned int previousMode, unsigned int id, Gdiplus::Font *font,
+SelectSpeller::SelectSpeller(unsigned int &nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, Gdiplus::Font *font,
                              DBController *db, unsigned int& spellerID)
-: Mode(nextMode, previousMode, id), mpFont_(font), pDB_(db), spellerID_(spellerID)
+: Mode(nextMode, previousMode, id, images), mpFont_(font), pDB_(db), spellerID_(spellerID)
 {
-    pBackground_ = new Image(L"Images/MainMenu.jpg");
-    
-    // Get button images
-    pButtonImages_.push_back(new Bitmap(L"Images/btnOK.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnCancel.jpg"));
+    // Get background and button images
+    StringVec paths;
+    Images( paths );
+    AcquireImages( paths, pBackground_, pButtonImages_ );
     
     // Create buttons
     buttons_.push_back(new Button(pButtonImages_[OK], PointF(250.0, 670.0)));
@@ -400,23 +408,30 @@ SelectSpeller::SelectSpeller(unsigned int &nextMode, unsigned int previousMode,
     SetUpScrollBox();
 }
 
-SelectSpeller::~SelectSpeller(){
-    delete pBackground_;
-    pBackground_ = 0;
+void SelectSpeller::Images( StringVec& paths ){
+    paths.push_back(L"Images/MainMenu.jpg");
+    paths.push_back(L"Images/btnOK.jpg");
+    paths.push_back(L"Images/btnCancel.jpg");
+}
 
-    remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>);
+SelectSpeller::~SelectSpeller(){
+    images_.Release( pBackground_ );
+    images_.Release( pButtonImages_ );
     remove_if(buttons_.begin(), buttons_.end(), deleteAll<Button>);
 
     delete sbSpellerList_;
     sbSpellerList_ = 0;
-    
-    remove_if(spellerData_.begin(), spellerData_.end(), deleteAll<RowData>);
 }
 
 void SelectSpeller::Update( double dt, const Gdiplus::PointF* cursorPos){
-   for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun( &Button::Update ), cursorPos));
-   sbSpellerList_->Update(dt, *cursorPos);
+    for( vector<Button*>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( **iter, cursorPos );
+    if( sbSpellerList_->Update(dt, *cursorPos) )
+        Invalidate( sbSpellerList_->Bounds() );
+}
 
+bool SelectSpeller::Animating() const{
+    return sbSpellerList_->Scrolling();
 }
 
 void SelectSpeller::Display(BackBuffer* bb){
@@ -477,7 +492,7 @@ void SelectSpeller::SetUpScrollBox(){
     GetData();
     
     sbSpellerList_ = new ScrollBox(&spellerData_, PointF(160.0f, 160.0f), 75, 6);
-    sbSpellerList_->AddColumn(Column::Centre, 75, 70, 70);
+    sbSpellerList_->AddColumn(Column::Centre, 75, 70, 70, images_);
     sbSpellerList_->AddColumn(Column::Left, 500, mpFont_);
     
     sbSpellerList_->SetSelectedColour(Color(100,30,30));
@@ -485,7 +500,8 @@ void SelectSpeller::SetUpScrollBox(){
 
 void SelectSpeller::GetData(){
     spellerData_.clear();
-    pDB_->GetSpellersAndAvatars( spellerData_ );
+    spellerRows_.Clear();
+    pDB_->GetSpellersAndAvatars( spellerData_, spellerRows_ );
 }
 
 void SelectSpeller::LoadSpeller(int rowID){
@@ -497,16 +513,14 @@ void SelectSpeller::LoadSpeller(int rowID){
     The launch page for Game Modes and options
 */
 
-SpellerMenu::SpellerMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, Gdiplus::Font* font,
+SpellerMenu::SpellerMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, Gdiplus::Font* font,
                DBController* db)
-: Mode(nextMode, previousMode, id), mpFont_(font), pDB_(db)
+: Mode(nextMode, previousMode, id, images), mpFont_(font), pDB_(db)
 {
-    pBackground_ = new Image(L"Images/MainMenu.jpg");
-    
-    // Get button images
-    pButtonImages_.push_back(new Bitmap(L"Images/btnMainMenu.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnWordOptions.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnQuickSpell.jpg"));
+    // Get background and button images
+    StringVec paths;
+    Images( paths );
+    AcquireImages( paths, pBackground_, pButtonImages_ );
     
     // Create buttons
     buttons_.push_back(new Button(pButtonImages_[MAIN], PointF(50.0, 600.0)));
@@ -515,17 +529,23 @@ SpellerMenu::SpellerMenu(unsigned int& nextMode, unsigned int previousMode, unsi
 
 }
 
-SpellerMenu::~SpellerMenu(){
-    delete pBackground_;
-    pBackground_ = 0;
+void SpellerMenu::Images( StringVec& paths ){
+    paths.push_back(L"Images/MainMenu.jpg");
+    paths.push_back(L"Images/btnMainMenu.jpg");
+    paths.push_back(L"Images/btnWordOptions.jpg");
+    paths.push_back(L"Images/btnQuickSpell.jpg");
+}
 
-    remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>);
+SpellerMenu::~SpellerMenu(){
+    images_.Release( pBackground_ );
+    images_.Release( pButtonImages_ );
     remove_if(buttons_.begin(), buttons_.end(), deleteAll<Button>);
     
 }
 
 void SpellerMenu::Update(double dt, const Gdiplus::PointF *cursorPos){
-    for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun( &Button::Update ), cursorPos));
+    for( vector<Button*>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( **iter, cursorPos );
 }
 
 void SpellerMenu::Display(BackBuffer *bb){
@@ -12,6 +12,7 @@
 #include <vector>
 #include "Keyboard.h"
 #include "Definitions.h"
+#include "ObjectPool.h"
 
 
 // Forward Declarations
@@ -27,9 +28,10 @@ public:
 
     enum{SELECT,NEW,QUIT};
 
-    TopMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, BackBuffer* bb,
+    TopMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, BackBuffer* bb,
             const unsigned int numSpellers);
     virtual ~TopMenu();
+    static void Images( StringVec& paths ); // Background, then button images in button order
     
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
@@ -43,7 +45,7 @@ public:
     virtual void Wheel(short zDelta, Gdiplus::PointF* mousePos);
 
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
     const unsigned int numSpellers_; // How many user accounts are there?  Determines which buttons are active.
@@ -57,10 +59,11 @@ public:
 
     enum{OK,CANCEL,KEYBOARDS};
 
-    NewSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, Gdiplus::Font* font,
-               DBController* db, ScreenPrinter* sp, unsigned int& spellerID,
+    NewSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
+               KeyboardLayouts& layouts, Gdiplus::Font* font, DBController* db, ScreenPrinter* sp, unsigned int& spellerID,
                TagList& tagList);
     virtual ~NewSpeller();
+    static void Images( StringVec& paths ); // Background, then button images in button order, then the name exists warning
     
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
@@ -84,20 +87,21 @@ private:
     void SetDefaultDifficulty(); // Sets up default difficulty in DB
 
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button*> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
-    Gdiplus::Image* pNameExists_;   // Name exists warning.
+    Gdiplus::Bitmap* pNameExists_;  // Name exists warning.
     
     // Avatar information
     IDList idList_;                     // IDs from database
     IDList::iterator displayedAvatar_;  // ID for current avatar
-    Gdiplus::Image* pAvatar_;           // Image for current avatar
+    Gdiplus::Bitmap* pAvatar_;          // Image for current avatar
     const Gdiplus::RectF avatarZone_;   // Print location (Also sets size of avatar)
     
 
     
     // Keyboards
+    KeyboardLayouts& keyboardLayouts_; // Compiled layout files, shared by every mode
     Keyboard* keyboard_;    // Pointer to current keyboard
     Keyboard qwerty_;       // standard qwerty
     Keyboard abc_;          // alphabetical order
@@ -120,12 +124,14 @@ class SelectSpeller : public Mode {
 public:
     enum{OK,CANCEL};
     
-    SelectSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, Gdiplus::Font* font,
+    SelectSpeller(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, Gdiplus::Font* font,
                DBController* db, unsigned int& spellerID);
     virtual ~SelectSpeller();
+    static void Images( StringVec& paths ); // Background, then button images in button order
     
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
+    virtual bool Animating() const;
 
     virtual void LMBUp(const Gdiplus::PointF* cursorPos);
     virtual void LMBDown(const Gdiplus::PointF* cursorPos, const double time=0.0);
@@ -141,7 +147,7 @@ private:
     void LoadSpeller(int rowID);
     
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button*> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
 
@@ -152,6 +158,7 @@ private:
     //ScrollBox
     ScrollBox* sbSpellerList_;          // Pointer to scrollbox for spellers
     TableData spellerData_;               // Speller data
+    RowPool spellerRows_;                 // Where spellerData_'s rows are made
     
     Gdiplus::Font* mpFont_;         
     DBController* pDB_;             // Database access
@@ -163,9 +170,10 @@ class SpellerMenu : public Mode {
 public:
     enum{MAIN, WORDOPTIONS, QUICKSPELL};
     
-    SpellerMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, Gdiplus::Font* font,
+    SpellerMenu(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, Gdiplus::Font* font,
                DBController* db);
     virtual ~SpellerMenu();
+    static void Images( StringVec& paths ); // Background, then button images in button order
     
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
@@ -179,7 +187,7 @@ public:
     virtual void Wheel(short zDelta, Gdiplus::PointF* mousePos);
     
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button*> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
     
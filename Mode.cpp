@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <functional>
 #include <vector>
+#include <cmath>
 #include "Button.h"
 #include "Definitions.h"
 #include "Speller.h"
@@ -13,18 +14,61 @@
 #include "DBController.h"
 #include "AnimatedFeedback.h"
 #include "SpellingSpotter.h"
+#include "ImageCache.h"
+#include "KeyboardLayout.h"
 using namespace Gdiplus;
 using namespace std;
 
-MiniSpell::MiniSpell(unsigned int& nextMode, unsigned int previousMode, unsigned int id,
-                     WordBank &wordbank, Speller &speller, BackBuffer* bb, ScreenPrinter* sp, Font* font,
-                     DBController* db,
+void Mode::AcquireImages( const StringVec& paths, Gdiplus::Bitmap*& background, std::vector<Gdiplus::Bitmap*>& buttons ){
+    StringVec::const_iterator iter = paths.begin();
+    background = images_.Acquire( *iter );
+    for( ++iter; iter != paths.end(); ++iter )
+        buttons.push_back( images_.Acquire( *iter ) );
+}
+
+void Mode::TakeDirty( DirtyRegion& region ){
+    region.Add( dirty_ );
+    dirty_.Clear();
+}
+
+void Mode::Invalidate( const Gdiplus::RectF& rect ){
+    dirty_.Add( DirtyRect( static_cast<int>( floor( rect.X ) ), static_cast<int>( floor( rect.Y ) ),
+                           static_cast<int>( ceil( rect.GetRight() ) ), static_cast<int>( ceil( rect.GetBottom() ) ) ) );
+}
+
+void Mode::InvalidateAll(){
+    dirty_.AddAll();
+}
+
+void Mode::UpdateButton( Button& button, const Gdiplus::PointF* cursorPos ){
+    int state = button.GetState();
+    button.Update( cursorPos );
+    if( button.GetState() != state )
+        Invalidate( button.Bounds() );
+}
+
+void Mode::UpdateKeyboard( Keyboard& keyboard, const Gdiplus::PointF* cursorPos ){
+    RectF before = keyboard.HoverBounds();
+    keyboard.Update( cursorPos );
+    RectF after = keyboard.HoverBounds();
+    if( !after.Equals( before ) ){
+        Invalidate( before ); // Empty if no key was highlighted
+        Invalidate( after );
+    }
+}
+
+MiniSpell::MiniSpell(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
+                     KeyboardLayouts& layouts, WordBank &wordbank, Speller &speller, BackBuffer* bb, ScreenPrinter* sp, Font* font,
+                     DBController* db, const RandomStream& random,
                      Game game )
-: Mode(nextMode, previousMode, id), wordBank_(wordbank), speller_(speller), bb_(bb), pScreenPrinter_(sp),
+: Mode(nextMode, previousMode, id, images), wordBank_(wordbank), speller_(speller), bb_(bb), pScreenPrinter_(sp),
     mpFont_(font), pDB_(db), FADE_SPEED(1.00), lengthLimit_(WORD_LENGTH_LIMIT),
-    game_(SPELLINGSPOTTING), usedWords_(0), state_(WAIT), pWord_(0), keyboard_(0), pAF_(0), pSSRegion_(0)
+    game_(SPELLINGSPOTTING), state_(WAIT), pWord_(0), keyboardLayouts_(layouts), keyboard_(0), pAF_(0), pSSRegion_(0),
+    session_(wordbank, speller, db, random.Split(WORDSTREAM)), layoutRandom_(random.Split(LAYOUTSTREAM))
 {
-    pBackground_ = new Image(L"Images/background.jpg");
+    StringVec paths;
+    Images( paths );
+    AcquireImages( paths, pBackground_, pButtonImages_ );
     CreateButtons();
     
     SetUp(); // Adjusts for different Game settings.
@@ -33,41 +77,57 @@ MiniSpell::MiniSpell(unsigned int& nextMode, unsigned int previousMode, unsigned
 }
 
 MiniSpell::~MiniSpell(){
-    if( pBackground_ )
-        delete pBackground_;
+    images_.Release( pBackground_ );
     if( pAF_ )
         delete pAF_;
     if( pSSRegion_)
         delete pSSRegion_;
         
-    pButtonImages_.erase(remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>),
-                         pButtonImages_.end() );
+    images_.Release( pButtonImages_ );
     buttons_.erase(remove_if(buttons_.begin(), buttons_.end(), deleteAll<Button>),
                    buttons_.end() );
 }
 
 void MiniSpell::Update(double dt, const Gdiplus::PointF *cursorPos){
-    for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun( &Button::Update ), cursorPos));
+    for( vector<Button*>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( **iter, cursorPos );
     if( keyboard_ )
-        keyboard_->Update(cursorPos);
+        UpdateKeyboard( *keyboard_, cursorPos );
     
     
     if( game_ == WORDWORKOUT ){ // Update instant word analysis variables   
-        UpdateLetterTimings(dt);
+        if( UpdateLetterTimings(dt) )
+            Invalidate( AttemptBounds() );
         UpdateLetterAnalysis();
         UpdateLetterColours();
     }
     
     if( game_ == QUICKSPELL && state_ == CHECK && pAF_){ // Update Animated Feedback
-        pAF_->Update( dt, *cursorPos );
+        if( pAF_->Update( dt, *cursorPos ) )
+            Invalidate( pAF_->Bounds() );
     }
     
     if( game_ == SPELLINGSPOTTING && pSSRegion_ ){// Update highlight or colour animation
-        pSSRegion_->Update( dt, cursorPos );
+        if( pSSRegion_->Update( dt, cursorPos ) )
+            Invalidate( pSSRegion_->Bounds() );
     }
     
 }
 
+bool MiniSpell::Animating() const{
+    if( game_ == WORDWORKOUT ){
+        for( TimingsList::const_iterator iter = timings_.begin(); iter != timings_.end(); ++iter ){
+            if( *iter < FADE_SPEED )
+                return true;
+        }
+    }
+    if( game_ == QUICKSPELL && state_ == CHECK && pAF_ )
+        return pAF_->Animating();
+    if( game_ == SPELLINGSPOTTING && pSSRegion_ )
+        return pSSRegion_->Fading();
+    return false;
+}
+
 void MiniSpell::Display(BackBuffer *bb){
     Graphics graphics(bb->getDC());
     graphics.DrawImage(pBackground_,RectF(static_cast<float>( bb->mOffX ),
@@ -224,7 +284,7 @@ void MiniSpell::SetUp(){
     readOption_   = READORSOUND;
     coverOption_  = TOTAL;
     writeOption_  = NOHELP;
-    weightingOption_ = NOWEIGHTING;
+    weightingOption_ = SpellingSession::NOWEIGHTING; // No button chooses weighting yet
 
     switch (game_){
         case QUICKSPELL:{
@@ -252,9 +312,6 @@ void MiniSpell::SetUp(){
 }
 
 void MiniSpell::SetUpWorkingList(){
-    workingList_.clear(); // Clear any previous list
-    //TODO: if list is changed with usedwords in use, might there be a problem reactivating a word that is no longer in the current list?
-    totalWeighting_ = 0;  // Stores the total weighting of all available words.
     IDList tempList;      // This stores valid IDs ready for copying to Working List
     
     // Determine which base list to copy.
@@ -288,49 +345,21 @@ void MiniSpell::SetUpWorkingList(){
         }
     }
 
-    // Weighting
-    // As IDs copied into Working List, set the Weighting if required by speller's weighting Option.
-    if( weightingOption_ == WEIGHTING ){
-        WeightingCalculator(tempList, speller_, workingList_, totalWeighting_);
-    } else {
-        IDList::iterator iter;
-        for(iter = tempList.begin(); iter != tempList.end(); ++iter ){
-            SelectionID sid;
-            sid.id_ = *iter;
-            sid.enabled_ = true;
-            sid.weighting_ = 1;  // No separate weight required.
-            workingList_.push_back(sid);
-        }
-        totalWeighting_ = workingList_.size();
-    }
+    session_.SetWordList( tempList, weightingOption_ );
     
-    //Update fixed queue size
-    if( workingList_.size() < 2 ){
-        usedWords_.ChangeSize(0);
-    } else {
-        usedWords_.ChangeSize(workingList_.size()/2);
-    }
-    
-    if( workingList_.empty() )
+    if( session_.IsEmpty() )
         buttons_[NEWWORD]->Disable(); // No words available, so disable New Word button.
     else
         buttons_[NEWWORD]->Enable();
 }
 
 void MiniSpell::SetUpRead(){
-    if( workingList_.empty() ) { return; }
+    if( session_.IsEmpty() ) { return; }
     
-    unsigned int selectedID = 0;
-    do{
-        selectedID = GetNewWord();
-    } while( selectedID == 0 ); // TODO: Infinite loop?
-    unsigned int id = usedWords_.Add(selectedID);
-    pWord_ = &(*(wordBank_.find(selectedID))).second; // TODO: Ouch, this looks clumsy.
-    if( id > 0 )
-        ReenableID(id);
+    pWord_ = session_.NextWord();
 
     if( game_ == SPELLINGSPOTTING ){
-        SetUpSSRegion(selectedID);
+        SetUpSSRegion(pWord_->GetID());
     }
     
     //buttons_[COVEROPTION]->Enable();  // Not needed.
@@ -338,34 +367,13 @@ void MiniSpell::SetUpRead(){
     state_ = READ;
 }
 
-unsigned int MiniSpell::GetNewWord(){
-    int select = Random(1, totalWeighting_);
-    WorkingList::iterator iter = workingList_.begin();
-    for( ; iter != workingList_.end(); ++iter){
-        select -= iter->weighting_;
-        if( select <= 0 ) break;
-    }
-    
-    if( iter == workingList_.end() || !(iter->enabled_) )
-        return 0;
-    
-    if (workingList_.size() > 1) // Only disable if using fixed queue (when more than one word available)
-        iter->enabled_ = false;
-    return iter->id_;
-}
-
 void MiniSpell::SetUpSSRegion(unsigned int id){
     if( pSSRegion_ ) delete pSSRegion_;
     
     StringVec tempWrong = speller_.GetWrongWords( id );
     // todo randomise wrong spellings (perhaps do in SSRegion)
-    pSSRegion_ = new SSRegion(pWord_->GetMainSpellingString(), tempWrong, PointF(12.0f, 130.0f), bb_, mpFont_, speller_);
-}
-
-void MiniSpell::ReenableID(unsigned int id){
-    WorkingList::iterator iter = find(workingList_.begin(), workingList_.end(), id);
-    if( iter != workingList_.end() )
-        iter->enabled_ = true;    
+    pSSRegion_ = new SSRegion(pWord_->GetMainSpellingString(), tempWrong, PointF(12.0f, 130.0f), bb_, mpFont_, pScreenPrinter_, speller_,
+                             layoutRandom_);
 }
 
 void MiniSpell::ChangeSelectedList(){
@@ -488,10 +496,12 @@ void MiniSpell::DisplayAttempt(BackBuffer* bb, wstring printString ){
         wp.PrintAttempt( printString, &speller_, pScreenPrinter_, bb, mpFont_, PointF(250.0f, 250.0f));
     }
     if( game_ == WORDWORKOUT ){
-        PointF pos(250.0f, 250.0f);
+        vector<Color> colours;
+        colours.reserve(printString.size());
         for( int i = 0; i < printString.size(); ++i ){
-            pos = pScreenPrinter_->PrintLetter(printString[i], pos, *mpFont_, GetFadeColour(i));
+            colours.push_back(GetFadeColour(i));
         }
+        pScreenPrinter_->PrintLetters(printString, PointF(250.0f, 250.0f), *mpFont_, colours);
     } 
 }
 
@@ -502,18 +512,22 @@ void MiniSpell::ShowWord(BackBuffer* bb){
     wp.PrintWord(pWord_, &speller_, pScreenPrinter_, bb, mpFont_, PointF(250.0f, 250.0f));
 }
 
+void MiniSpell::Images( StringVec& paths ){
+    paths.push_back(L"Images/background.jpg");
+    paths.push_back(L"Images/btnSpellerOptionsS.jpg");
+    paths.push_back(L"Images/btnWordOptionsS.jpg");
+    paths.push_back(L"Images/btnListTypeS.jpg");
+    paths.push_back(L"Images/btnReadOptionS.jpg");
+    paths.push_back(L"Images/btnCoverOptionS.jpg");
+    paths.push_back(L"Images/btnWriteOptionS.jpg");
+    paths.push_back(L"Images/btnCheckOptionS.jpg");
+    paths.push_back(L"Images/btnExitS.jpg");
+    paths.push_back(L"Images/btnNewWord.jpg");
+    paths.push_back(L"Images/btnKeyboardsNoSymbols.jpg");
+    paths.push_back(L"Images/btnSymbols.jpg");
+}
+
 void MiniSpell::CreateButtons(){
-    pButtonImages_.push_back( new Bitmap(L"Images/btnSpellerOptionsS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnWordOptionsS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnListTypeS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnReadOptionS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnCoverOptionS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnWriteOptionS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnCheckOptionS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnExitS.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnNewWord.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnKeyboardsNoSymbols.jpg") );
-    pButtonImages_.push_back( new Bitmap(L"Images/btnSymbols.jpg") );
     buttons_.push_back( new Button(pButtonImages_[SPELLEROPTION], PointF(0.0f, 640.0f),
                                     128.0f, 128.0f) );
     buttons_.push_back( new Button(pButtonImages_[WORDOPTION], PointF(128.0f, 640.0f),
@@ -564,8 +578,7 @@ bool MiniSpell::CharacterAccepted(const wchar_t character){
     // Convert Character 
     wchar_t convertedCharacter = ConvertCharacter( character );
     
-    wstring tempSpelling = ConvertSpelling( pWord_->GetMainSpellingString() );
-    wstring tempAttempt  = ConvertSpelling( attempt_ );
+    const wstring& tempSpelling = pWord_->GetMainSpelling().GetNormalised( speller_.UseAutoDiacritics(), true );
     int charCountS = count(tempSpelling.begin(), tempSpelling.end(), convertedCharacter );
     if( writeOption_ == LETTERS )
         if( charCountS )
@@ -573,6 +586,7 @@ bool MiniSpell::CharacterAccepted(const wchar_t character){
         else
             return false;
     if( writeOption_ == LETTERSONCE ){
+        wstring tempAttempt = ConvertSpelling( attempt_ );
         int charCountA = count( tempAttempt.begin(), tempAttempt.end(), convertedCharacter );
             return charCountS > charCountA;
     }
@@ -582,18 +596,11 @@ bool MiniSpell::CharacterAccepted(const wchar_t character){
 }
 
 wstring MiniSpell::ConvertSpelling( const wstring& original ){
-    if( speller_.UseAutoDiacritics() ){
-        return ToLower( original, true ); // Replace diacritics and capitals
-    } else {
-        return ToLower( original ); // Replace capitals
-    }
+    return ApplySpellingOptions( original, speller_.UseAutoDiacritics(), true ); // Replace capitals, and diacritics if auto
 }
 
 wchar_t MiniSpell::ConvertCharacter(const wchar_t &original){
-    wstring temp = L"";
-    temp.assign(1, original);
-    temp = ConvertSpelling( temp );
-    return *(temp.begin());
+    return ToLower( original, speller_.UseAutoDiacritics() ); // As ConvertSpelling, without building a string
 }
 
 void MiniSpell::EditAttempt( unsigned int key ){
@@ -651,7 +658,7 @@ void MiniSpell::EditAttempt( unsigned int key ){
 }
 
 void MiniSpell::KeyboardSetup(){
-    qwerty_.LoadKeyboard("Data/Keyboards/qwerty.txt");
+    qwerty_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/qwerty.txt"));
     qwerty_.SetFont(&FontFamily(L"Impact"),26.0);
     qwerty_.SetKeySize(50.0f, 50.0f);
     qwerty_.SetPosition(PointF(150.0, 350.0));
@@ -659,7 +666,7 @@ void MiniSpell::KeyboardSetup(){
                         Color(0,0,0), Color(200,200,200), Color(200,200,0),
                         Color(200,200,0));
                         
-    abc_.LoadKeyboard("Data/Keyboards/abc.txt");
+    abc_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/abc.txt"));
     abc_.SetFont(&FontFamily(L"Impact"),26.0);
     abc_.SetKeySize(50.0f, 50.0f);
     abc_.SetPosition(PointF(150.0, 350.0));
@@ -667,7 +674,7 @@ void MiniSpell::KeyboardSetup(){
                         Color(0,0,0), Color(200,200,200), Color(200,200,0),
                         Color(200,200,0));
 
-    special_.LoadKeyboard("Data/Keyboards/special.txt");
+    special_.LoadKeyboard(keyboardLayouts_.Get("Data/Keyboards/special.txt"));
     special_.SetFont(&FontFamily(L"Impact"),26.0);
     special_.SetKeySize(50.0f, 45.0f);
     special_.SetPosition(PointF(150.0, 350.0));
@@ -707,29 +714,16 @@ void MiniSpell::WriteOptionAllKeys(){
     // If no keyboard, wrong writeOption or wrong state, do nothing.
     if( !keyboard_ || writeOption_ == NOHELP || state_ != WRITE ) return;
 
-    keyboard_->DisableAllKeys();
-    
-
-    keyboard_->EnableKey(static_cast<wchar_t>(8)); // enable delete
-        
-    keyboard_->EnableKey(static_cast<wchar_t>(13)); // enable enter
-
-    // Cycle through each letter/character in spelling
-    wstring spelling = pWord_->GetMainSpellingString();
-    for( wstring::iterator iter = spelling.begin();
-         iter != spelling.end();
-         ++iter ){
-        wchar_t character = ConvertCharacter(*iter);
-        if( writeOption_ == LETTERS ){ // This option doesn't care if the letters are already in the attempt
-            keyboard_->EnableKey( character ); // enable the key based on the converted character
-            keyboard_->EnableKey( *iter );     // but also based on the original character
-        } else { // Check the required letters are not already in the attempt
-            if( CharacterAccepted( character ) )
-                keyboard_->EnableKey( character );
-            if( CharacterAccepted( *iter ) )
-                keyboard_->EnableKey( *iter );
-        }
+    wordKeys_.Update( *keyboard_, *pWord_, speller_.UseAutoDiacritics() );
+    if( writeOption_ == LETTERS ){ // This option doesn't care if the letters are already in the attempt
+        keyboard_->EnableKeys( wordKeys_.Uses() );
+        return;
     }
+    
+    // Only the letters the attempt hasn't used up
+    KeyMask enabled;
+    wordKeys_.Unused( ConvertSpelling( attempt_ ), enabled );
+    keyboard_->EnableKeys( enabled );
 }
 
 void MiniSpell::WriteOptionSingleKey( unsigned int key ){
@@ -738,15 +732,23 @@ void MiniSpell::WriteOptionSingleKey( unsigned int key ){
     WriteOptionAllKeys();   
 }
 
-void MiniSpell::UpdateLetterTimings( double dt ){
+bool MiniSpell::UpdateLetterTimings( double dt ){
     // Update existing timings.
+    bool fading = false;
     for( TimingsList::iterator iter = timings_.begin();
          iter != timings_.end();
          ++iter ){
          if( *iter < FADE_SPEED ){
             *iter += dt;
+            fading = true;
          }
     }
+    return fading;
+}
+
+Gdiplus::RectF MiniSpell::AttemptBounds() const{
+    // The strip Display fills in the PAPER colour, which DisplayAttempt prints on at (250, 250)
+    return RectF( 0.0f, 250.0f, static_cast<float>( bb_->width() ), 100.0f );
 }
 
 void MiniSpell::UpdateLetterAnalysis(){
@@ -906,55 +908,19 @@ void MiniSpell::CreateLetterData(){
 void MiniSpell::SetUpCheck(){
     // TODO: trim extra spaces?? Or restrict multiple spaces and spaces from ends?
     
-    // See if there is an existing record for this word, and create one if there isn't.
-    if( speller_.RecordExists( pWord_->GetID() ) ){
-        // If so, increase the number of attempts.
-        speller_.IncreaseAttempts( pWord_->GetID() );        
-    } else {
-        // If not, create a record and set attempts to 1.
-        speller_.CreateRecord( pWord_->GetID() );
-        // Add to database
-        pDB_->AddSpellerRecord( speller_.GetID(), pWord_->GetID(), 1, 0);
-    }
-    
-    // Sort out levels and wrong spellings, where appropriate.
-    if( game_ == WORDWORKOUT ){ // Getting it correct is the only option in Word Workout
-        IncreaseLevel(); // CONSIDER: ignoring changes to level in either direction in practice modes.
-    }
-    // Word analysis for QUICKSPELL - also adds a wrong spelling, if appropriate, and ups the level if word correct
-    if( game_ == QUICKSPELL ){
+    // Updates the record, level and wrong spellings, where appropriate.
+    // Spelling Spotting goes to CHECK straight from its region click (LMBUp), without a record.
+    if( game_ == WORDWORKOUT ){ // Getting it correct is the only option in Word Workout, so it's only practice
+        session_.Check( true, true );
+    } else if( game_ == QUICKSPELL ){
         AnalysedWord aw( pWord_->GetMainSpellingString().length() );
-        SpellingAnalyser sp( attempt_, pWord_, speller_, aw );
-        if( !( aw.IsCorrect() || aw.IsBeyondWrong() ) ){
-            WrongSpelling ws(aw);
-            speller_.AddWrongSpelling( pWord_->GetID(), ws, pDB_ );
-        }
-        if( aw.IsCorrect() )
-            IncreaseLevel();
+        session_.Check( attempt_, aw );
         SetUpAnimatedFeedback( aw );
     }
-    
-    // Update attempts and level in DB
-    pDB_->UpdateSpellerRecord( speller_, pWord_->GetID() ); 
 
     state_ = CHECK;
 }
 
-void MiniSpell::IncreaseLevel(){
-    int level = speller_.GetWordLevel( pWord_->GetID() );
-    if( level == 0 ) return; // no change if not got a level yet.
-    
-    if( level < TOP_LEVEL_RANK_1 ){
-        level = TOP_LEVEL_RANK_1;
-    } else if( level < TOP_LEVEL_RANK_2 ){
-        level = TOP_LEVEL_RANK_2;
-    } else if ( level < TOP_LEVEL_RANK_3 ){
-        level = TOP_LEVEL_RANK_3;
-    }
-    if( level != speller_.GetWordLevel( pWord_->GetID() ) )
-        speller_.SetLevel( pWord_->GetID(), level );
-}
-
 void MiniSpell::SetUpAnimatedFeedback( AnalysedWord& aw ){
     // Delete any previous one
     if( pAF_ ){
@@ -971,7 +937,7 @@ void MiniSpell::SetUpAnimatedFeedback( AnalysedWord& aw ){
         ( aw.NumCorrect() < 1 || aw.NumErrors() > 1 ) )
         return;
         
-    pAF_ = new AnimatedFeedback(speller_, mpFont_, aw.GetAnalysis(), bb_ );
+    pAF_ = new AnimatedFeedback(speller_, mpFont_, pScreenPrinter_, aw.GetAnalysis(), bb_ );
     pAF_->WordPosition( PointF(250.0f, 250.0f) );
     
 }
\ No newline at end of file
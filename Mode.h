@@ -13,6 +13,10 @@
 #include "Utility.h"
 #include "Word.h"
 #include "Keyboard.h"
+#include "WordKeys.h"
+#include "Random.h"
+#include "SpellingSession.h"
+#include "FrameScheduler.h"
 
 class BackBuffer;
 class Button;
@@ -22,14 +26,17 @@ class Word;
 class DBController;
 class AnimatedFeedback;
 class SSRegion;
+class ImageCache;
+class KeyboardLayouts;
 
 class Mode {
 public:
 
-Mode(unsigned int& nextMode, unsigned int previousMode, unsigned int id = 0)
+Mode(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images)
 : nextMode_(nextMode),
   previousMode_(previousMode),
-  modeID_(id) {}
+  modeID_(id),
+  images_(images) {}
 virtual ~Mode() {};
 
 virtual void Update( double dt, const Gdiplus::PointF* cursorPos)=0;
@@ -43,10 +50,23 @@ virtual void RMBUp(const Gdiplus::PointF* cursorPos)=0;
 virtual void RMBDown(const Gdiplus::PointF* cursorPos)=0;
 virtual void Wheel(short zDelta, Gdiplus::PointF* mousePos)=0;
 
+virtual bool Animating() const { return false; } // True while the mode changes without any input
+void TakeDirty(DirtyRegion& region);             // Adds what needs redrawing to region, then forgets it
+
 protected:
+    void Invalidate( const Gdiplus::RectF& rect ); // rect has changed, and needs redrawing
+    void InvalidateAll();
+    void UpdateButton( Button& button, const Gdiplus::PointF* cursorPos ); // Invalidates button if its look changes
+    void UpdateKeyboard( Keyboard& keyboard, const Gdiplus::PointF* cursorPos ); // Invalidates keys whose highlight changes
+
+    // Takes each of paths from images_: the first as background, the rest as buttons, in order.
+    void AcquireImages( const StringVec& paths, Gdiplus::Bitmap*& background, std::vector<Gdiplus::Bitmap*>& buttons );
+
     unsigned int modeID_;    // Is this needed?!
     unsigned int& nextMode_; // This has to be a reference, as it is passed a value as a reference.
     unsigned int previousMode_;  // The "return to" mode, if required.
+    ImageCache& images_;         // Shared by every mode, so images survive switching between them.
+    DirtyRegion dirty_;          // Changed since App last drew
 
 };
 
@@ -62,19 +82,22 @@ public:
     enum ReadOption {READALWAYS, READORSOUND, SOUNDONLY};
     enum CoverOption {TOTAL, SPACES};
     enum WriteOption {NOHELP, LETTERS, LETTERSONCE};
-    enum WeightingOption { NOWEIGHTING, WEIGHTING };
     enum WWAnalysis { NONE, CORRECT, WRONG, SWAPL, SWAPR }; // Word Workout analysis
+    enum RandomStreamID { WORDSTREAM, LAYOUTSTREAM }; // Subsystem streams split from the session stream
     
     
-    MiniSpell(unsigned int& nextMode, unsigned int previousMode, unsigned int id,
-              WordBank &wordbank, Speller &speller, BackBuffer* bb, ScreenPrinter* sp, Gdiplus::Font* font,
-              DBController* db,
+    MiniSpell(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
+              KeyboardLayouts& layouts, WordBank &wordbank, Speller &speller, BackBuffer* bb, ScreenPrinter* sp, Gdiplus::Font* font,
+              DBController* db, const RandomStream& random,
               Game game = QUICKSPELL);
     
     virtual ~MiniSpell();
     
+    static void Images( StringVec& paths ); // Background, then button images in button order
+    
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
+    virtual bool Animating() const; // Feedback, fading letters or fading words
 
     virtual void LMBUp(const Gdiplus::PointF* cursorPos);
     virtual void LMBDown(const Gdiplus::PointF* cursorPos, const double time=0.0);
@@ -89,9 +112,7 @@ private:
     void SetUp();
     void SetUpWorkingList();
     void SetUpRead();
-    unsigned int GetNewWord();
     void SetUpSSRegion(unsigned int id); // spelling spotting
-    void ReenableID( unsigned int id );
     void SetUpWrite();
     void SetUpCheck();
     
@@ -108,7 +129,7 @@ private:
     
     bool CharacterAccepted( const wchar_t character ); // Checks if a character can be added to the attempt, based on options.
     std::wstring ConvertSpelling( const std::wstring& original ); // Depending on options, removes capitals and/or diacritics
-    wchar_t ConvertCharacter( const wchar_t& original ); // Uses ConvertSpelling to affect a single character only.
+    wchar_t ConvertCharacter( const wchar_t& original ); // As ConvertSpelling, for a single character only.
     
     void EditAttempt( unsigned int key ); // edits speller's attempt
     
@@ -123,7 +144,8 @@ private:
     void SetUpAnimatedFeedback(AnalysedWord& aw);
     
     // Word Workout stuff
-    void UpdateLetterTimings( double dt ); // Updates timing of fading colours
+    bool UpdateLetterTimings( double dt ); // Updates timing of fading colours.  Returns true if any are still fading.
+    Gdiplus::RectF AttemptBounds() const;  // Where the attempt is printed
     void UpdateLetterAnalysis();           // Checks and updates analysis of attempt
     void UpdateLetterColours();            // Updates fading colours
     bool LettersEqual( wchar_t c1, wchar_t c2 ) const; // Sees if two letters are equal under current settings (caps and diacritics)
@@ -134,10 +156,8 @@ private:
     void CreateLetterData();
     void DeleteLetterData(); // Strips last entry for each of timings, analysis and colours.
 
-    void IncreaseLevel(); // If word spelt/chosen correctly, adjust level to top level of the current rank.
-
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button*> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
     
@@ -156,22 +176,24 @@ private:
     ReadOption readOption_;
     CoverOption coverOption_;
     WriteOption writeOption_;
-    WeightingOption weightingOption_;
+    SpellingSession::WeightingOption weightingOption_;
     
-    WorkingList workingList_; // Active list used to select words.
-    unsigned int totalWeighting_; // Stores total weight of words in workingList.
+    SpellingSession session_; // Word selection and recording of attempts.
     Word* pWord_;
-    FixedQueue usedWords_;
+    RandomStream layoutRandom_; // Used for Spelling Spotting layout.
     
     std::wstring attempt_;
     unsigned int lengthLimit_; // either global limit or length of current word.
     
     // Keyboards
+    KeyboardLayouts& keyboardLayouts_; // Compiled layout files, shared by every mode
     Keyboard* keyboard_;    // Pointer to current keyboard
     Keyboard qwerty_;       // standard qwerty
     Keyboard abc_;          // alphabetical order
     Keyboard special_;      // special characters
 
+    WordKeys wordKeys_;     // The keys the word's spelling uses on keyboard_
+
     // QuickSpell stuff
     AnimatedFeedback* pAF_; // Pointer to Animated Feedback object.
 
@@ -0,0 +1,77 @@
+// ObjectPool.h
+// Makes objects of one type in blocks, and destroys them all together when the pool is cleared or goes out
+// of scope.  For objects that live as long as a screen - table rows, spelling spotting words - so the screen
+// makes a few block allocations instead of one per object, and nothing it made can be left behind.
+// Clear keeps the blocks for the next lot of objects.
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+
+template <typename T>
+class ObjectPool{
+public:
+    explicit ObjectPool( std::size_t blockSize = 64 )
+    : blockSize_(blockSize > 0 ? blockSize : 1), block_(0), used_(0), size_(0), allocations_(0)
+    {}
+
+    ~ObjectPool(){
+        Clear();
+        for( typename std::vector<T*>::iterator iter = blocks_.begin(); iter != blocks_.end(); ++iter )
+            allocator_.deallocate( *iter, blockSize_ );
+    }
+
+    // A copy of value, in the pool.
+    T* Make( const T& value ){
+        if( used_ == blockSize_ || blocks_.empty() ){
+            if( !blocks_.empty() )
+                ++block_;
+            if( block_ == blocks_.size() ){
+                blocks_.push_back( allocator_.allocate( blockSize_ ) );
+                ++allocations_;
+            }
+            used_ = 0;
+        }
+        T* object = blocks_[block_] + used_;
+        new( object ) T( value );
+        ++used_;
+        ++size_;
+        return object;
+    }
+
+    // Destroys every object made, newest first.  Pointers to them are no longer valid.
+    void Clear(){
+        while( size_ > 0 ){
+            if( used_ == 0 ){
+                --block_;
+                used_ = blockSize_;
+            }
+            --used_;
+            --size_;
+            blocks_[block_][used_].~T();
+        }
+        block_ = 0;
+        used_ = 0;
+    }
+
+    std::size_t Size() const { return size_; }               // Objects in the pool
+    std::size_t Allocations() const { return allocations_; } // Blocks allocated over the pool's life
+
+private:
+    ObjectPool( const ObjectPool& );
+    ObjectPool& operator=( const ObjectPool& );
+
+    std::allocator<T> allocator_;
+    std::vector<T*> blocks_;
+    std::size_t blockSize_;
+    std::size_t block_;       // The block being filled
+    std::size_t used_;        // Objects made in it
+    std::size_t size_;
+    std::size_t allocations_;
+};
+
+#endif // OBJECTPOOL_H
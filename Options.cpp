@@ -10,6 +10,7 @@
 #include "Dumbell.h"
 #include "DBController.h"
 #include "Speller.h"
+#include "ImageCache.h"
 
 using namespace Gdiplus;
 using namespace std;
@@ -24,19 +25,126 @@ using namespace std;
 //extern std::wstring stringify(const unsigned int& x);
 
 
-WordListOptions::WordListOptions(unsigned int &nextMode, unsigned int previousMode, unsigned int id,
+namespace{
+    // Orders word indices by a key made once for each word, rather than at every comparison.
+    template <typename Key>
+    class KeyLess{
+    public:
+        KeyLess( const std::vector<Key>& keys ) : keys_(keys) {}
+        bool operator()( unsigned int lhs, unsigned int rhs ) const { return keys_[lhs] < keys_[rhs]; }
+    private:
+        const std::vector<Key>& keys_;
+    };
+}
+
+// WORDROWS
+WordRows::WordRows( const WordBank& wordBank, const IDList& stars )
+: hideInactive_(false), stars_(stars)
+{
+    words_.reserve( wordBank.size() );
+    for( WordBank::const_iterator iter = wordBank.begin(); iter != wordBank.end(); ++iter ){
+        Entry entry = { &iter->second, iter->first, true };
+        words_.push_back( entry );
+    }
+    order_.resize( words_.size() );
+    for( unsigned int i = 0; i < order_.size(); ++i )
+        order_[i] = i;
+    Show();
+    row_.data_.resize( 3 );
+}
+
+int WordRows::Rows(){
+    return static_cast<int>( shown_.size() );
+}
+
+const RowData& WordRows::Row( int row ){
+    const Entry& entry = words_[shown_[row]];
+    row_.dataID_ = entry.id_;
+    row_.active_ = entry.active_;
+    row_.data_[0] = stringify( entry.word_->GetDifficulty() );
+    row_.data_[1] = entry.word_->GetMainSpellingString();
+    row_.data_[2] = stars_.count( entry.id_ ) ? L"1On" : L"2Off";
+    return row_;
+}
+
+unsigned int WordRows::WordID( int row ) const{
+    return words_[shown_[row]].id_;
+}
+
+void WordRows::SetActive( unsigned int wordID, bool active ){
+    // words_ is in ID order, as the word bank is.
+    size_t low = 0, high = words_.size();
+    while( low < high ){
+        size_t mid = low + ( high - low ) / 2;
+        if( words_[mid].id_ < wordID )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if( low < words_.size() && words_[low].id_ == wordID )
+        words_[low].active_ = active;
+}
+
+void WordRows::Filter( bool hideInactive ){
+    hideInactive_ = hideInactive;
+    Show();
+}
+
+void WordRows::SortByDifficulty(){
+    vector<unsigned int> keys( words_.size() );
+    for( size_t i = 0; i < words_.size(); ++i )
+        keys[i] = words_[i].word_->GetDifficulty();
+    stable_sort( order_.begin(), order_.end(), KeyLess<unsigned int>( keys ) );
+    Show();
+}
+
+void WordRows::SortAlphabetically(){
+    vector<wstring> keys( words_.size() ); // Only while sorting
+    for( size_t i = 0; i < words_.size(); ++i )
+        keys[i] = ToLower( words_[i].word_->GetMainSpellingString(), true );
+    stable_sort( order_.begin(), order_.end(), KeyLess<wstring>( keys ) );
+    Show();
+}
+
+void WordRows::SortByStars(){
+    vector<int> keys( words_.size() );
+    for( size_t i = 0; i < words_.size(); ++i )
+        keys[i] = stars_.count( words_[i].id_ ) ? 0 : 1;
+    stable_sort( order_.begin(), order_.end(), KeyLess<int>( keys ) );
+    Show();
+}
+
+void WordRows::Show(){
+    if( !hideInactive_ ){
+        shown_ = order_;
+        return;
+    }
+    shown_.clear();
+    for( IndexList::const_iterator iter = order_.begin(); iter != order_.end(); ++iter ){
+        if( words_[*iter].active_ )
+            shown_.push_back( *iter );
+    }
+}
+
+// WORDLISTOPTIONS
+WordListOptions::WordListOptions(unsigned int &nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
                                  BackBuffer* bb,
                                  Gdiplus::Font* font, WordBank& wordBank, TagList& tagList,
+                                 const SubstringIndex& substringIndex,
                                  Speller* speller,
                                  DBController* db)
-    : Mode(nextMode, previousMode, id),
-    mpFont_(font), wordBank_(wordBank), tagList_(tagList),
+    : Mode(nextMode, previousMode, id, images),
+    mpFont_(font), wordBank_(wordBank), tagList_(tagList), substringIndex_(substringIndex),
+    searching_(false),
     speller_(speller),
     refDifficulty_(speller->GetDifficulty()),
     refSpellerStars_(speller->GetStarList()),
+    stars_(speller->GetStarList()),
+    wordRows_(wordBank, stars_),
     refSpellerTags_(speller->GetTagList()),
     difficulty_(speller->GetDifficulty()),
     pBackground_(0),
+    starIcons_(0),
     selectedRow_(-1), 
     fState_(SHOWFILTERED),
     pDB_(db),
@@ -45,15 +153,11 @@ WordListOptions::WordListOptions(unsigned int &nextMode, unsigned int previousMo
     pTagFont_ = new Gdiplus::Font(L"Arial", 15.0);
     pWordFont_ = new Gdiplus::Font(L"Arial", 20.0);
     
-    pBackground_ = new Image(L"Images/WordListOptions.jpg");
-
-    pButtonImages_.push_back(new Bitmap(L"Images/btnOK.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnCancel.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/tagsAll.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/tagsSwap.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/wordsDiff.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/wordsAZ.jpg"));
-    pButtonImages_.push_back(new Bitmap(L"Images/btnToggleFilter.jpg"));
+    StringVec paths;
+    Images( paths );
+    starIcons_ = images_.Acquire( paths.back() ); // For the word list
+    paths.pop_back();
+    AcquireImages( paths, pBackground_, pButtonImages_ );
 
     buttons_.push_back(new Button(pButtonImages_[SAVE], PointF(600.0f, 650.0f)));
     buttons_.push_back(new Button(pButtonImages_[CANCEL], PointF(750.0f, 650.0f)));
@@ -76,12 +180,21 @@ WordListOptions::WordListOptions(unsigned int &nextMode, unsigned int previousMo
     SetUpWordScrollBox();
 }
 
-WordListOptions::~WordListOptions(){
-    if( pBackground_)
-        delete pBackground_;
-    pBackground_ = 0;
+void WordListOptions::Images( StringVec& paths ){
+    paths.push_back(L"Images/WordListOptions.jpg");
+    paths.push_back(L"Images/btnOK.jpg");
+    paths.push_back(L"Images/btnCancel.jpg");
+    paths.push_back(L"Images/tagsAll.jpg");
+    paths.push_back(L"Images/tagsSwap.jpg");
+    paths.push_back(L"Images/wordsDiff.jpg");
+    paths.push_back(L"Images/wordsAZ.jpg");
+    paths.push_back(L"Images/btnToggleFilter.jpg");
+    paths.push_back(L"Images/stars.png");
+}
 
-    remove_if(pButtonImages_.begin(), pButtonImages_.end(), deleteAll<Bitmap>);
+WordListOptions::~WordListOptions(){
+    images_.Release( pBackground_ );
+    images_.Release( pButtonImages_ );
     remove_if(buttons_.begin(), buttons_.end(), deleteAll<Button>);
     
     if( sbTagList_ )
@@ -92,8 +205,7 @@ WordListOptions::~WordListOptions(){
         delete sbWordList_;
     sbWordList_ = 0;
     
-    remove_if(wordData_.begin(), wordData_.end(), deleteAll<RowData>);
-    remove_if(tagData_.begin(), tagData_.end(), deleteAll<RowData>);
+    images_.Release( starIcons_ ); // After sbWordList_, which draws with it
     
     delete pTagFont_;
     delete pWordFont_;
@@ -103,6 +215,7 @@ WordListOptions::~WordListOptions(){
 void WordListOptions::Update( double dt, const Gdiplus::PointF* cursorPos){
     // Has the speller selected a different word since last time?  Or no word at all?
     if( selectedRow_ != sbWordList_->SelectedRow() ){
+        InvalidateAll();
         selectedRow_ = sbWordList_->SelectedRow(); // Make them equal
         if( selectedRow_ == -1 ){ // No word selected
             for_each(tagData_.begin(), tagData_.end(), mem_fun( &RowData::Show ));
@@ -110,15 +223,23 @@ void WordListOptions::Update( double dt, const Gdiplus::PointF* cursorPos){
             sbTagList_->Refresh();
         }
         else{ // Particular word selected
-            SetUpWordTagData(wordData_[selectedRow_]->dataID_);
+            SetUpWordTagData(wordRows_.WordID(selectedRow_));
         }
     }
     
-    for_each(buttons_.begin(), buttons_.end(), bind2nd( mem_fun( &Button::Update ), cursorPos));
+    for( vector<Button*>::iterator iter = buttons_.begin(); iter != buttons_.end(); ++iter )
+        UpdateButton( **iter, cursorPos );
     
-    sbTagList_->Update(dt, *cursorPos);
-    sbWordList_->Update(dt, *cursorPos);
-    dbDifficulty_->Update(*cursorPos);
+    if( sbTagList_->Update(dt, *cursorPos) )
+        Invalidate( sbTagList_->Bounds() );
+    if( sbWordList_->Update(dt, *cursorPos) )
+        Invalidate( sbWordList_->Bounds() );
+    if( dbDifficulty_->Update(*cursorPos) )
+        Invalidate( dbDifficulty_->Bounds() );
+}
+
+bool WordListOptions::Animating() const{
+    return sbTagList_->Scrolling() || sbWordList_->Scrolling();
 }
 
 void WordListOptions::Display(BackBuffer* bb){
@@ -140,6 +261,10 @@ void WordListOptions::Display(BackBuffer* bb){
         wstring n = stringify(i);
         graphics.DrawString(n.c_str(), -1, pWordFont_, PointF(720.0f+(i-1)*gap, 70.0f), &SolidBrush(Color(0,0,0)));
     }
+    
+    // Letter search
+    wstring search = L"Find: " + search_ + L"_";
+    graphics.DrawString(search.c_str(), -1, pWordFont_, PointF(600.0f, 480.0f), &SolidBrush(Color(0,0,0)));
 }
 
 void WordListOptions::LMBDown(const Gdiplus::PointF *cursorPos, const double time ){
@@ -158,7 +283,7 @@ void WordListOptions::LMBDown(const Gdiplus::PointF *cursorPos, const double tim
     if( cell.first != -2 ){
         offClick = false;
         if( cell.second == 3 ){ // TODO: Will need to be 4 if thumbs going in col 3.
-            StarChange( wordData_[sbWordList_->SelectedRow()]->dataID_);
+            StarChange( wordRows_.WordID(sbWordList_->SelectedRow()) );
             if( selectedRow_ == -1 )
                 sbWordList_->ClearSelectedRow();
         }
@@ -249,12 +374,15 @@ void WordListOptions::Wheel(short zDelta, Gdiplus::PointF *mousePos){
     sbWordList_->Wheel(zDelta, *mousePos);
 }
 
-void WordListOptions::KeyDown(unsigned int key){}
+void WordListOptions::KeyDown(unsigned int key){
+    EditSearch( static_cast<wchar_t>( key ) );
+}
 
 void WordListOptions::KeyUp(){}
 
 void WordListOptions::SetUpTagScrollBox(){
     tagData_.clear();
+    tagRows_.Clear();
     // Add actual tags
     for( TagList::iterator iter = tagList_.begin(); iter != tagList_.end(); ++iter ){
         RowData rd;
@@ -269,7 +397,7 @@ void WordListOptions::SetUpTagScrollBox(){
         
         rd.data_.push_back( iter->GetName() );
         rd.data_.push_back( stringify(iter->WordCount()) );
-        tagData_.push_back(new RowData(rd.dataID_, rd.data_, rd.active_)); //problem - local object
+        tagData_.push_back(tagRows_.Make(rd));
     }
 
     sbTagList_ = new ScrollBox(&tagData_, PointF(600.0f, 200.0f), 40, 6);
@@ -281,34 +409,14 @@ void WordListOptions::SetUpTagScrollBox(){
 }
 
 void WordListOptions::SetUpWordScrollBox(){
-    wordData_.clear();
-    
+    // Rows are only made as they are shown; here each word just gets its active state.
     for( WordBank::iterator iter = wordBank_.begin(); iter != wordBank_.end(); ++iter ){
-        RowData rd;
-        if( !WordInDifficultyRange(iter->first) )
-            rd.active_ = false;
-        else if( !WordHasActiveTags(iter->first) )
-            rd.active_ = false;
-        // Row ID (word ID)
-        rd.dataID_ = iter->first;
-        // Difficulty
-        rd.data_.push_back( stringify(iter->second.GetDifficulty()) );
-        // Current main spelling
-        rd.data_.push_back( iter->second.GetMainSpellingString() );
-        // TODO: rating.
-        // Star status
-        if( refSpellerStars_.find( iter->first) == refSpellerStars_.end() ){
-            rd.data_.push_back(L"2Off");
-        }
-        else {
-            rd.data_.push_back(L"1On");
-        }
-        wordData_.push_back(new RowData(rd.dataID_, rd.data_, rd.active_));
-        TableData::iterator iter2 = wordData_.begin();
-
+        wordRows_.SetActive( iter->first, WordInDifficultyRange(iter->first) &&
+                                          WordHasActiveTags(iter->first) &&
+                                          WordMatchesSearch(iter->first) );
     }
     
-    sbWordList_ = new ScrollBox(&wordData_, PointF(50.0f, 100.0f), 50);
+    sbWordList_ = new ScrollBox(wordRows_, PointF(50.0f, 100.0f), 50);
     sbWordList_->AddColumn(Column::Centre, 50, pWordFont_); // Difficulty
     sbWordList_->AddColumn(Column::Left, 400, pWordFont_);  // (main) Spelling
     //// Word ranking
@@ -325,7 +433,6 @@ void WordListOptions::SetUpWordScrollBox(){
     IconColumn::ValueList star;
     star.push_back(L"2Off");
     star.push_back(L"1On");
-    starIcons_ = new Image(L"Images/stars.png");
     sbWordList_->AddColumn(Column::Centre, 50, starIcons_, star);
     
     sbWordList_->SetRowColours(Color(100,50,50,100), Color(80,50,50,100) );
@@ -374,6 +481,12 @@ bool WordListOptions::WordHasActiveTags( unsigned int wordID ){
     return false;
 }
 
+bool WordListOptions::WordMatchesSearch( unsigned int wordID ){
+    if( !searching_ )
+        return true;
+    return searchMatches_.count(wordID) != 0;
+}
+
 void WordListOptions::UpdateWords( int tagID ){
     TagList::iterator tIter = find_if(tagList_.begin(), tagList_.end(),
                                         bind2nd(mem_fun_ref(&Tag::EqualToID), static_cast<unsigned int>(tagID) ));
@@ -381,70 +494,46 @@ void WordListOptions::UpdateWords( int tagID ){
         return;
     IDList& words = tIter->GetWords();
     for( IDList::iterator iter = words.begin(); iter != words.end(); ++iter ){
-        if( WordInDifficultyRange(*iter) ){ // Word must be within difficulty range to be active, regardless of tags
-            if( WordHasActiveTags(*iter) ) {
-                // Word is active (at least one tag active, and in difficulty range)
-                (*find_if( wordData_.begin(), wordData_.end(),
-                      bind2nd(mem_fun(&RowData::EqualToID), *iter)))->Activate();
-            }
-            else{
-                // Word is inactive (all tags inactive)
-                (*find_if( wordData_.begin(), wordData_.end(),
-                      bind2nd(mem_fun(&RowData::EqualToID), *iter)))->Deactivate(); 
-            }
-        }
-        else{
-            // Word is inactive (difficulty range)
-            (*find_if( wordData_.begin(), wordData_.end(),
-                bind2nd(mem_fun(&RowData::EqualToID), *iter)))->Deactivate(); 
-        }
+        // Word must be within difficulty range to be active, regardless of tags, and match the search
+        wordRows_.SetActive( *iter, WordInDifficultyRange(*iter) && WordHasActiveTags(*iter) && WordMatchesSearch(*iter) );
     }
     ToggleWordFilter( fState_ );
     SortWords( sState_ );
 }
 
 void WordListOptions::UpdateWords(){
-    for( TableData::iterator iter = wordData_.begin(); iter != wordData_.end(); ++iter ){   
-        if( !WordInDifficultyRange((*iter)->dataID_) )
-            (*iter)->Deactivate();
-        else if( !WordHasActiveTags((*iter)->dataID_) )
-            (*iter)->Deactivate();
+    for( WordBank::iterator iter = wordBank_.begin(); iter != wordBank_.end(); ++iter ){
+        if( !WordInDifficultyRange(iter->first) )
+            wordRows_.SetActive( iter->first, false );
+        else if( !WordHasActiveTags(iter->first) )
+            wordRows_.SetActive( iter->first, false );
+        else if( !WordMatchesSearch(iter->first) )
+            wordRows_.SetActive( iter->first, false );
         else
-            (*iter)->Activate();
+            wordRows_.SetActive( iter->first, true );
     }
     ToggleWordFilter( fState_ );
     SortWords( sState_ );
 }
 
 void WordListOptions::ToggleWordFilter(int state){
-    if( state == SHOWFILTERED ){ // Show all words
-      for_each(wordData_.begin(), wordData_.end(), mem_fun( &RowData::Show ));  
-    }
-    else{
-        //Hide all filtered words
-        for( TableData::iterator iter = wordData_.begin(); iter != wordData_.end(); ++iter){
-            if( (*iter)->active_ )
-                (*iter)->Show();
-            else
-                (*iter)->Hide();
-        }
-    }
+    wordRows_.Filter( state != SHOWFILTERED ); // Hide all filtered words, or show all words
 }
 
 void WordListOptions::SortWords( int state ){
     switch( state ){
         case SORTDIFFICULTY:{
-            stable_sort(wordData_.begin(), wordData_.end(), ColumnNumericSort<0>);
+            wordRows_.SortByDifficulty();
             sState_ = SORTDIFFICULTY;
             break;
         }
         case SORTALPHA:{
-            stable_sort(wordData_.begin(), wordData_.end(), ColumnAlphaSort<1>);
+            wordRows_.SortAlphabetically();
             sState_ = SORTALPHA;
             break;
         }
         case SORTSTARS:{
-            stable_sort(wordData_.begin(), wordData_.end(), ColumnAlphaSort<2>);
+            wordRows_.SortByStars();
             sState_ = SORTSTARS;
             break;
         }
@@ -463,6 +552,23 @@ void WordListOptions::ChangeDifficulty( Range newDiff ){
     UpdateWords();
 }
 
+void WordListOptions::EditSearch( wchar_t ch ){
+    if( ch == DEL ){
+        if( search_.empty() )
+            return;
+        search_ = search_.substr(0, search_.length() - 1);
+    }
+    else{
+        // Non-character key pressed, or search already as long as any word - do nothing.
+        if( ch < SPACE || search_.length() >= WORD_LENGTH_LIMIT )
+            return;
+        search_ += ch;
+    }
+    
+    searching_ = substringIndex_.Find( search_, searchMatches_ );
+    UpdateWords();
+}
+
 void WordListOptions::SaveChanges(){
 
     // Save difficulty level into current Speller object
@@ -472,12 +578,7 @@ void WordListOptions::SaveChanges(){
     pDB_->UpdateDifficulty(spellerID_, refDifficulty_.mLow, refDifficulty_.mHigh);
     
     // Stars update
-    IDList spellerStars; // Will hold new stars list
-    for(TableData::iterator iter = wordData_.begin(); iter != wordData_.end(); ++iter ){
-        if( (*iter)->data_[2] == L"1On" ){
-            spellerStars.insert((*iter)->dataID_);
-        }
-    }
+    IDList& spellerStars = stars_; // The new stars list
     
     if( !refSpellerStars_.empty() ) { // Only do this if there is an old stars list.
         // Remove stars from old list that are no longer in the new list
@@ -556,10 +657,8 @@ void WordListOptions::Cancel(){
 }
 
 void WordListOptions::StarChange(unsigned int wordID){
-    TableData::iterator iter = find_if(wordData_.begin(), wordData_.end(),
-                                        bind2nd(mem_fun( &RowData::EqualToID ), wordID ));
-    if( (*iter)->data_[2] == L"1On" )
-        (*iter)->data_[2] = L"2Off";
+    if( stars_.count( wordID ) )
+        stars_.erase( wordID );
     else
-        (*iter)->data_[2] = L"1On";
-}
\ No newline at end of file
+        stars_.insert( wordID );
+}
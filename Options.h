@@ -15,6 +15,9 @@
 #include "Definitions.h"
 #include "Word.h"
 #include "Range.h"
+#include "SubstringIndex.h"
+#include "ScrollBox.h"
+#include "ObjectPool.h"
 
 //Forward Declarations
 class BackBuffer;
@@ -24,19 +27,57 @@ class Dumbell;
 class DBController;
 class Speller;
 
+// The word list's rows, made from the word bank only as the ScrollBox shows them.
+// Sorting and filtering work on arrays of word indices, so a large bank costs a few bytes a word.
+class WordRows : public RowSource {
+public:
+    WordRows( const WordBank& wordBank, const IDList& stars );
+    
+    int Rows();
+    const RowData& Row( int row );
+    unsigned int WordID( int row ) const;
+    
+    void SetActive( unsigned int wordID, bool active );
+    void Filter( bool hideInactive ); // Inactive words are left out of the rows
+    void SortByDifficulty();          // Stable, as are the other sorts
+    void SortAlphabetically();
+    void SortByStars();               // Starred first
+    
+private:
+    struct Entry{
+        const Word* word_;
+        unsigned int id_;
+        bool active_;
+    };
+    typedef std::vector<unsigned int> IndexList; // Into words_
+    
+    void Show(); // Remakes shown_ from order_
+    
+    std::vector<Entry> words_; // Every word, in ID order
+    IndexList order_;          // Every word, sorted
+    IndexList shown_;          // The rows: order_, less inactive words if hiding them
+    bool hideInactive_;
+    const IDList& stars_;
+    RowData row_;              // The last row asked for
+};
+
 class WordListOptions : public Mode {
 public:
     enum{SAVE, CANCEL, TAGSALL, TAGSSWAP, SORTDIFF, SORTAZ, WORDFILTER};
     enum FilterState{ HIDEFILTERED = 1, SHOWFILTERED};
     enum SortState { SORTDIFFICULTY = 1, SORTALPHA, SORTRANK, SORTSTARS };
-    WordListOptions(unsigned int& nextMode, unsigned int previousMode, unsigned int id, BackBuffer* bb,
+    WordListOptions(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images,
+                    BackBuffer* bb,
                     Gdiplus::Font* font, WordBank& wordBank, TagList& tagList,
+                    const SubstringIndex& substringIndex,
                     Speller* speller,
                     DBController* db);
     virtual ~WordListOptions();
+    static void Images( StringVec& paths ); // Background, then button images in button order, then the star icons
     
     virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
     virtual void Display(BackBuffer* bb);
+    virtual bool Animating() const;
 
     virtual void LMBUp(const Gdiplus::PointF* cursorPos);
     virtual void LMBDown(const Gdiplus::PointF* cursorPos, const double time=0.0);
@@ -54,6 +95,7 @@ private:
     
     bool WordInDifficultyRange( unsigned int wordID );
     bool WordHasActiveTags( unsigned int wordID );
+    bool WordMatchesSearch( unsigned int wordID );
     void UpdateWords( int tagID );
     void UpdateWords();
     
@@ -61,6 +103,7 @@ private:
     void SortWords( int state );
     
     void ChangeDifficulty( Range newDiff );
+    void EditSearch( wchar_t ch ); // Typed letters filter the words: "ough", "-tion" (ending), "pre-" (starting)
     
     void SaveChanges();
     void Cancel();
@@ -68,7 +111,7 @@ private:
     void StarChange( unsigned int wordID );
 
 private:
-    Gdiplus::Image* pBackground_;   // Stores the background image
+    Gdiplus::Bitmap* pBackground_;  // Stores the background image
     std::vector<Button*> buttons_;   // Stores the buttons.
     std::vector<Gdiplus::Bitmap*> pButtonImages_; // Stores button images
     Gdiplus::Font* mpFont_;
@@ -77,6 +120,7 @@ private:
     
     WordBank& wordBank_;
     TagList& tagList_;
+    const SubstringIndex& substringIndex_;
     
     FilterState fState_;
     SortState sState_;
@@ -84,13 +128,20 @@ private:
     //Tag ScrollBox
     ScrollBox* sbTagList_;          // Pointer to scrollbox for Tags
     TableData tagData_;             // Tags data
+    RowPool tagRows_;               // Where tagData_'s rows are made
     
     //Word ScrollBox
     ScrollBox* sbWordList_;
-    TableData wordData_;
-    Gdiplus::Image* starIcons_;
+    IDList stars_;       // Starred words, as changed but not yet saved
+    WordRows wordRows_;
+    Gdiplus::Bitmap* starIcons_;
     int selectedRow_;       // Used to check if a different word has been selected, for tag updates.
                             // Also checked when selecting stars.    
+    // Letter search
+    std::wstring search_;
+    bool searching_;       // False when search_ has no letters, so all words match
+    IDList searchMatches_; // IDs of words matching search_
+    
     // Difficulty Dumbell
     Dumbell* dbDifficulty_;
     
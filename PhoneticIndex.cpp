@@ -0,0 +1,350 @@
+// PhoneticIndex.cpp
+
+#include "PhoneticIndex.h"
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include "Word.h"
+#include "Utility.h"
+
+using namespace std;
+
+namespace {
+    const size_t MINCHUNK = 1024; // Fewest spellings worth starting a thread for
+
+    bool IsVowel( wchar_t c ){
+        return c == L'a' || c == L'e' || c == L'i' || c == L'o' || c == L'u';
+    }
+
+    bool IsFrontVowel( wchar_t c ){ // Softens c and g
+        return c == L'e' || c == L'i' || c == L'y';
+    }
+
+    // True if s holds letters at pos.
+    bool LettersAt( const wstring& s, size_t pos, const wchar_t* letters ){
+        for( ; *letters; ++letters, ++pos ){
+            if( pos >= s.length() || s[pos] != *letters )
+                return false;
+        }
+        return true;
+    }
+
+    void Add( wstring& primary, wstring& alternate, const wchar_t* sound, const wchar_t* alternateSound = 0 ){
+        primary += sound;
+        alternate += alternateSound ? alternateSound : sound;
+    }
+}
+
+void PhoneticKeys( const wstring& spelling, wstring& primary, wstring& alternate ){
+    primary.clear();
+    alternate.clear();
+
+    // Sound the diacritics that change a letter's sound, and lose the rest along with caps and punctuation.
+    wstring s;
+    for( wstring::const_iterator iter = spelling.begin(); iter != spelling.end(); ++iter ){
+        if( *iter == L'\x00E7' || *iter == L'\x00C7' ){ // c cedilla
+            s += L's';
+            continue;
+        }
+        if( *iter == L'\x00F1' || *iter == L'\x00D1' ){ // n tilde
+            s += L"ny";
+            continue;
+        }
+        wchar_t c = RemoveDiacritic( *iter );
+        if( c >= L'A' && c <= L'Z' )
+            c += 32;
+        if( c >= L'a' && c <= L'z' )
+            s += c;
+    }
+    if( s.empty() )
+        return;
+
+    size_t i = 0;
+    // Silent first letters
+    if( LettersAt( s, 0, L"kn" ) || LettersAt( s, 0, L"gn" ) || LettersAt( s, 0, L"pn" ) ||
+        LettersAt( s, 0, L"wr" ) || LettersAt( s, 0, L"ps" ) ){
+        i = 1;
+    }
+    else if( s[0] == L'x' ){ // xylophone
+        Add( primary, alternate, L"S" );
+        i = 1;
+    }
+    else if( LettersAt( s, 0, L"wh" ) ){
+        Add( primary, alternate, L"W" );
+        i = 2;
+    }
+
+    for( ; i < s.length(); ++i ){
+        wchar_t c = s[i];
+        wchar_t previous = i > 0 ? s[i - 1] : 0;
+        wchar_t next = i + 1 < s.length() ? s[i + 1] : 0;
+        if( c == previous && c != L'c' ) // Doubled letters sound once, but "cc" can be two sounds (accept)
+            continue;
+
+        switch( c ){
+            case L'a': case L'e': case L'i': case L'o': case L'u':{
+                if( c == L'e' && i + 1 == s.length() && i > 1 && !IsVowel( previous ) ) // Silent e, as in note
+                    break;
+                if( IsVowel( previous ) ) // One sound for each run of vowels
+                    break;
+                if( i == 0 ){
+                    wchar_t sound[2] = { static_cast<wchar_t>( c - 32 ), 0 };
+                    Add( primary, alternate, sound, L"A" );
+                }
+                else{ // The alternate has no vowels after the first
+                    primary += static_cast<wchar_t>( c - 32 );
+                }
+                break;
+            }
+            case L'b':{
+                if( !( previous == L'm' && i + 1 == s.length() ) ) // lamb
+                    Add( primary, alternate, L"B", L"P" );
+                break;
+            }
+            case L'c':{
+                if( LettersAt( s, i, L"cia" ) ){
+                    Add( primary, alternate, L"X" );
+                }
+                else if( next == L'h' ){
+                    if( previous == L's' ) // school
+                        Add( primary, alternate, L"K" );
+                    else                   // chop, or chorus
+                        Add( primary, alternate, L"X", L"K" );
+                    ++i;
+                }
+                else if( IsFrontVowel( next ) ){
+                    if( previous != L's' ) // scene
+                        Add( primary, alternate, L"S" );
+                }
+                else{
+                    Add( primary, alternate, L"K" );
+                    if( next == L'k' || next == L'q' ) // back, acquire
+                        ++i;
+                }
+                break;
+            }
+            case L'd':{
+                if( next == L'g' && i + 2 < s.length() && IsFrontVowel( s[i + 2] ) ){ // edge
+                    Add( primary, alternate, L"J" );
+                    ++i;
+                }
+                else{
+                    Add( primary, alternate, L"D", L"T" );
+                }
+                break;
+            }
+            case L'g':{
+                if( next == L'h' ){
+                    if( i == 0 ) // ghost
+                        Add( primary, alternate, L"G", L"K" );
+                    ++i;         // otherwise silent, as in night
+                }
+                else if( next == L'n' && ( i + 2 == s.length() || ( LettersAt( s, i + 1, L"ned" ) && i + 4 == s.length() ) ) ){
+                    // silent, as in sign
+                }
+                else if( IsFrontVowel( next ) ){ // gem, or get
+                    Add( primary, alternate, L"J", L"K" );
+                }
+                else{
+                    Add( primary, alternate, L"G", L"K" );
+                }
+                break;
+            }
+            case L'h':{
+                if( IsVowel( next ) && previous != L'c' && previous != L's' && previous != L'p' &&
+                    previous != L't' && previous != L'g' ){
+                    Add( primary, alternate, L"H" );
+                }
+                break;
+            }
+            case L'k':{
+                if( previous != L'c' )
+                    Add( primary, alternate, L"K" );
+                break;
+            }
+            case L'p':{
+                if( next == L'h' ){
+                    Add( primary, alternate, L"F" );
+                    ++i;
+                }
+                else{
+                    Add( primary, alternate, L"P" );
+                }
+                break;
+            }
+            case L'q':{
+                Add( primary, alternate, L"K" );
+                break;
+            }
+            case L's':{
+                if( LettersAt( s, i, L"sch" ) ){
+                    Add( primary, alternate, L"SK" );
+                    i += 2;
+                }
+                else if( next == L'h' ){
+                    Add( primary, alternate, L"X" );
+                    ++i;
+                }
+                else if( LettersAt( s, i + 1, L"io" ) || LettersAt( s, i + 1, L"ia" ) ){ // mission
+                    Add( primary, alternate, L"X" );
+                }
+                else{
+                    Add( primary, alternate, L"S" );
+                }
+                break;
+            }
+            case L't':{
+                if( LettersAt( s, i + 1, L"io" ) || LettersAt( s, i + 1, L"ia" ) ){ // nation
+                    Add( primary, alternate, L"X" );
+                }
+                else if( next == L'h' ){ // the, or thyme
+                    Add( primary, alternate, L"0", L"T" );
+                    ++i;
+                }
+                else if( !LettersAt( s, i + 1, L"ch" ) ){ // t in match is silent
+                    Add( primary, alternate, L"T" );
+                }
+                break;
+            }
+            case L'v':{
+                Add( primary, alternate, L"V", L"F" );
+                break;
+            }
+            case L'w':
+            case L'y':{
+                if( IsVowel( next ) )
+                    Add( primary, alternate, c == L'w' ? L"W" : L"Y" );
+                else if( c == L'y' && i + 1 == s.length() && i > 0 && !IsVowel( previous ) ) // tiny
+                    primary += L'I';
+                break;
+            }
+            case L'x':{
+                Add( primary, alternate, L"KS" );
+                break;
+            }
+            case L'z':{
+                Add( primary, alternate, L"S" );
+                break;
+            }
+            default:{ // f, j, l, m, n, r
+                wchar_t sound[2] = { static_cast<wchar_t>( c - 32 ), 0 };
+                Add( primary, alternate, sound );
+                break;
+            }
+        }
+    }
+}
+
+PhoneticIndex::PhoneticIndex()
+{}
+
+void PhoneticIndex::Build( const WordBank& wordBank, unsigned int threads ){
+    Clear();
+    for( WordBank::const_iterator iter = wordBank.begin(); iter != wordBank.end(); ++iter ){
+        const SpellingList& spellings = iter->second.GetSpellings();
+        for( SpellingList::const_iterator spelling = spellings.begin(); spelling != spellings.end(); ++spelling ){
+            Entry entry;
+            entry.wordID_ = iter->first;
+            entry.spelling_ = spelling->GetSpelling();
+            entries_.push_back( entry );
+        }
+    }
+
+    // Work out the keys in parallel; each thread fills its own share of entries_.
+    if( threads == 0 )
+        threads = max( thread::hardware_concurrency(), 1u );
+    size_t chunk = max( ( entries_.size() + threads - 1 ) / threads, MINCHUNK );
+    vector<thread> workers;
+    for( size_t first = chunk; first < entries_.size(); first += chunk ){
+        workers.push_back( thread( &PhoneticIndex::MakeKeys, ref( entries_ ), first, min( first + chunk, entries_.size() ) ) );
+    }
+    MakeKeys( entries_, 0, min( chunk, entries_.size() ) );
+    for( vector<thread>::iterator iter = workers.begin(); iter != workers.end(); ++iter ){
+        iter->join();
+    }
+
+    for( unsigned int i = 0; i < entries_.size(); ++i ){
+        const Entry& entry = entries_[i];
+        if( entry.primary_.empty() ) // Nothing to sound
+            continue;
+        primary_[entry.primary_].push_back( i );
+        if( entry.alternate_ != entry.primary_ )
+            alternate_[entry.alternate_].push_back( i );
+        words_[entry.wordID_].push_back( i );
+    }
+}
+
+void PhoneticIndex::Clear(){
+    entries_.clear();
+    primary_.clear();
+    alternate_.clear();
+    words_.clear();
+}
+
+size_t PhoneticIndex::Size() const {
+    return entries_.size();
+}
+
+void PhoneticIndex::Homophones( unsigned int wordID, IDList& wordIDs ) const {
+    Collect( wordID, false, wordIDs );
+}
+
+void PhoneticIndex::NearHomophones( unsigned int wordID, IDList& wordIDs ) const {
+    Collect( wordID, true, wordIDs );
+}
+
+bool PhoneticIndex::HasHomophones( unsigned int wordID ) const {
+    IDList wordIDs;
+    Homophones( wordID, wordIDs );
+    return !wordIDs.empty();
+}
+
+void PhoneticIndex::Groups( vector<IDList>& groups ) const {
+    groups.clear();
+    for( KeyTable::const_iterator iter = primary_.begin(); iter != primary_.end(); ++iter ){
+        IDList group;
+        AddWords( primary_, iter->first, entries_, group );
+        if( group.size() > 1 )
+            groups.push_back( group );
+    }
+}
+
+void PhoneticIndex::MarkConfusables( WordBank& wordBank ) const {
+    for( WordBank::iterator iter = wordBank.begin(); iter != wordBank.end(); ++iter ){
+        if( !iter->second.IsConfusable() && HasHomophones( iter->first ) )
+            iter->second.SetConfusable();
+    }
+}
+
+void PhoneticIndex::MakeKeys( vector<Entry>& entries, size_t first, size_t last ){
+    for( size_t i = first; i < last; ++i ){
+        PhoneticKeys( entries[i].spelling_, entries[i].primary_, entries[i].alternate_ );
+    }
+}
+
+void PhoneticIndex::Collect( unsigned int wordID, bool near, IDList& wordIDs ) const {
+    wordIDs.clear();
+    WordTable::const_iterator word = words_.find( wordID );
+    if( word == words_.end() )
+        return;
+    for( vector<unsigned int>::const_iterator iter = word->second.begin(); iter != word->second.end(); ++iter ){
+        const Entry& entry = entries_[*iter];
+        AddWords( primary_, entry.primary_, entries_, wordIDs );
+        if( near ){
+            AddWords( alternate_, entry.primary_, entries_, wordIDs );
+            AddWords( primary_, entry.alternate_, entries_, wordIDs );
+            AddWords( alternate_, entry.alternate_, entries_, wordIDs );
+        }
+    }
+    wordIDs.erase( wordID ); // A word's own spellings don't count
+}
+
+void PhoneticIndex::AddWords( const KeyTable& table, const wstring& key, const vector<Entry>& entries,
+                              IDList& wordIDs ){
+    KeyTable::const_iterator found = table.find( key );
+    if( found == table.end() )
+        return;
+    for( vector<unsigned int>::const_iterator iter = found->second.begin(); iter != found->second.end(); ++iter ){
+        wordIDs.insert( entries[*iter].wordID_ );
+    }
+}
@@ -0,0 +1,64 @@
+// PhoneticIndex.h
+// Groups words that sound alike, so homophones ("their", "there") can be found without hand-made flags.
+// Each spelling gets two sound keys, in the style of Double Metaphone.  The primary key is the most likely
+// pronunciation, keeping the first letter of each run of vowels and voiced consonants.  The alternate, as
+// in Metaphone, drops the vowels, devoices (d as t), and takes the other sound where a letter group is
+// ambiguous ("ch" as in chop or chorus).
+// Words sharing a primary key are homophones; words sharing either key are near-homophones.
+
+#ifndef PHONETICINDEX_H
+#define PHONETICINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include "Definitions.h"
+
+// Primary and alternate sound keys for spelling.  Diacritics are sounded where they matter (ç, ñ).
+void PhoneticKeys( const std::wstring& spelling, std::wstring& primary, std::wstring& alternate );
+
+class PhoneticIndex{
+public:
+    PhoneticIndex();
+
+    // Replaces the index with every spelling in wordBank.  Keys are worked out on up to threads threads;
+    // 0 uses one per core.
+    void Build( const WordBank& wordBank, unsigned int threads = 0 );
+    void Clear();
+    std::size_t Size() const; // Number of spellings indexed
+
+    // Fill wordIDs with the other words that sound like (or nearly like) any spelling of wordID.
+    void Homophones( unsigned int wordID, IDList& wordIDs ) const;
+    void NearHomophones( unsigned int wordID, IDList& wordIDs ) const;
+    bool HasHomophones( unsigned int wordID ) const;
+
+    // Fills groups with each set of two or more words sharing a primary key.
+    void Groups( std::vector<IDList>& groups ) const;
+
+    // Sets each word in wordBank as confusable if it has homophones.  Words already marked stay confusable.
+    void MarkConfusables( WordBank& wordBank ) const;
+
+private:
+    struct Entry{
+        unsigned int wordID_;
+        std::wstring spelling_;
+        std::wstring primary_;
+        std::wstring alternate_;
+    };
+    typedef std::unordered_map< std::wstring, std::vector<unsigned int> > KeyTable; // Key to indices into entries_
+    typedef std::unordered_map< unsigned int, std::vector<unsigned int> > WordTable; // Word ID to indices into entries_
+
+    static void MakeKeys( std::vector<Entry>& entries, std::size_t first, std::size_t last );
+    void Collect( unsigned int wordID, bool near, IDList& wordIDs ) const;
+    static void AddWords( const KeyTable& table, const std::wstring& key, const std::vector<Entry>& entries,
+                          IDList& wordIDs );
+
+private:
+    std::vector<Entry> entries_;
+    KeyTable primary_;   // Primary keys
+    KeyTable alternate_; // Alternate keys, where different from the primary
+    WordTable words_;
+};
+
+#endif // PHONETICINDEX_H
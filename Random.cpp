@@ -1,16 +1,84 @@
 // Random.cpp
 
 #include "Random.h"
-#include <cstdlib>
+#include <ctime>
 
-// Returns a random number in r.
-int Random(Range r)
-{
-	return r.mLow + rand() % ((r.mHigh + 1) - r.mLow);
+namespace {
+    // SplitMix64 - used to spread a seed across the generator state.
+    RandomStream::result_type SplitMix( RandomStream::result_type& x ){
+        RandomStream::result_type z = ( x += 0x9E3779B97F4A7C15ULL );
+        z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+        return z ^ ( z >> 31 );
+    }
+    
+    RandomStream::result_type RotateLeft( RandomStream::result_type x, int k ){
+        return ( x << k ) | ( x >> ( 64 - k ) );
+    }
+}
+
+RandomStream::RandomStream(Seed seed){
+    Reseed(seed);
+}
+
+void RandomStream::Reseed(Seed seed){
+    seed_ = seed;
+    result_type x = seed;
+    for( int i = 0; i < 4; ++i )
+        state_[i] = SplitMix(x); // SplitMix never gives an all zero state.
+}
+
+RandomStream::Seed RandomStream::GetSeed() const{
+    return seed_;
+}
+
+RandomStream RandomStream::Split(unsigned int streamID) const{
+    result_type x = seed_ ^ ( static_cast<result_type>(streamID) * 0xD1B54A32D192ED03ULL );
+    SplitMix(x);
+    return RandomStream( SplitMix(x) );
+}
+
+RandomStream::result_type RandomStream::Next(){
+    const result_type result = RotateLeft( state_[1] * 5, 7 ) * 9;
+    const result_type t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft( state_[3], 45 );
+    return result;
+}
+
+RandomStream::result_type RandomStream::Below(result_type bound){
+    if( bound == 0 ) return 0;
+    // Reject the few values at the bottom of the range that would bias the modulo.
+    const result_type threshold = ( 0 - bound ) % bound;
+    result_type r;
+    do{
+        r = Next();
+    } while( r < threshold );
+    return r % bound;
 }
 
 // Returns a random number in [low, high].
-int Random(int low, int high)
-{
-	return low + rand() % ((high + 1) - low);
+int RandomStream::Random(int low, int high){
+    if( high <= low ) return low;
+    result_type span = static_cast<result_type>( static_cast<long long>(high) - low ) + 1;
+    return static_cast<int>( low + static_cast<long long>( Below(span) ) );
+}
+
+// Returns a random number in r.
+int RandomStream::Random(const Range& r){
+    return Random(r.mLow, r.mHigh);
+}
+
+double RandomStream::Unit(){
+    return ( Next() >> 11 ) * ( 1.0 / 9007199254740992.0 ); // top 53 bits
+}
+
+RandomStream::Seed MakeSeed(){
+    RandomStream::result_type x = static_cast<RandomStream::result_type>( time(0) );
+    x ^= static_cast<RandomStream::result_type>( clock() ) << 32;
+    return SplitMix(x);
 }
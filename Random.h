@@ -3,10 +3,47 @@
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <cstddef>
+#include <algorithm>
 #include "Range.h"
 
-int Random(Range r);
+// RandomStream is a small, fast generator (xoshiro256**) that is always seeded explicitly.
+// Streams share no state, so a session can be replayed from its seed, and Split() hands out
+// independent child streams for sessions and subsystems without disturbing the parent.
+class RandomStream{
+public:
+    typedef unsigned long long Seed;
+    typedef unsigned long long result_type;
+    
+    explicit RandomStream(Seed seed = 0);
+    
+    void Reseed(Seed seed);
+    Seed GetSeed() const; // The seed this stream started from - record this to replay a run.
+    
+    // Returns a new stream derived from this stream's seed and the streamID.
+    // The same seed and streamID always give the same child stream.
+    RandomStream Split(unsigned int streamID) const;
+    
+    result_type Next(); // Next raw 64 bit value.
+    result_type Below(result_type bound); // Unbiased value in [0, bound).  Returns 0 if bound is 0.
+    int Random(int low, int high); // Unbiased value in [low, high].
+    int Random(const Range& r);    // Unbiased value in r.
+    double Unit(); // Value in [0, 1).
+    
+    // Fisher-Yates shuffle, using this stream.
+    template <typename RandomIt>
+    void Shuffle(RandomIt first, RandomIt last){
+        for( std::ptrdiff_t n = last - first; n > 1; --n ){
+            std::swap( first[n - 1], first[ static_cast<std::ptrdiff_t>( Below( static_cast<result_type>(n) ) ) ] );
+        }
+    }
+    
+private:
+    result_type state_[4];
+    Seed seed_;
+};
 
-int Random(int a, int b);
+// Produces a seed from the clock, for sessions that do not need to be replayed.
+RandomStream::Seed MakeSeed();
 
 #endif // RANDOM_H
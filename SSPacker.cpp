@@ -0,0 +1,104 @@
+// SSPacker.cpp
+
+#include "SSPacker.h"
+#include "Random.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace{
+    // Orders word indices widest first.
+    class WiderThan{
+    public:
+        WiderThan( const vector<float>& widths ) : widths_(widths) {}
+        bool operator()( int lhs, int rhs ) const { return widths_[lhs] > widths_[rhs]; }
+    private:
+        const vector<float>& widths_;
+    };
+}
+
+SSPacking::SSPacking()
+: size_(0), rowHeight_(0.0f)
+{}
+
+SSPacker::SSPacker( WordMeasure& measure, float width, float height, float boxWidth, float boxHeight )
+: measure_(measure), width_(width), height_(height), boxWidth_(boxWidth), boxHeight_(boxHeight)
+{}
+
+void SSPacker::Pack( const std::wstring& correctSpelling, const std::vector<std::wstring>& wrongSpellings,
+                     RandomStream& random, SSPacking& packing ){
+    words_.assign( 1, correctSpelling );
+    words_.insert( words_.end(), wrongSpellings.begin(), wrongSpellings.end() );
+
+    vector<int> order( words_.size() );
+    for( int i = 0; i < static_cast<int>( order.size() ); ++i )
+        order[i] = i;
+    random.Shuffle( order.begin(), order.end() );
+
+    unsigned int sizes = max( 1u, measure_.Sizes() );
+    for( unsigned int size = 0; size < sizes; ++size ){
+        if( PackAt( size, order, size + 1 == sizes, random, packing ) )
+            return;
+    }
+}
+
+bool SSPacker::PackAt( unsigned int size, const std::vector<int>& order, bool lastResort, RandomStream& random,
+                       SSPacking& packing ){
+    packing.size_ = size;
+    packing.rowHeight_ = measure_.Height( size ) + boxHeight_;
+    packing.rows_.clear();
+    packing.dropped_.clear();
+
+    int maxRows = packing.rowHeight_ > 0.0f ? static_cast<int>( height_ / packing.rowHeight_ ) : 0;
+    if( maxRows < 1 ){
+        if( !lastResort )
+            return false;
+        maxRows = 1;
+    }
+
+    packing.widths_.resize( words_.size() );
+    for( size_t i = 0; i < words_.size(); ++i )
+        packing.widths_[i] = measure_.Width( size, words_[i] ) + boxWidth_;
+
+    // Widest first.  Equal widths keep their shuffled order.
+    vector<int> sorted( order );
+    stable_sort( sorted.begin(), sorted.end(), WiderThan( packing.widths_ ) );
+    if( lastResort ){ // The correct spelling goes first, so it can't be crowded out
+        sorted.erase( find( sorted.begin(), sorted.end(), 0 ) );
+        sorted.insert( sorted.begin(), 0 );
+    }
+
+    // Rows are tried in a random order, so the words don't all pile into the top ones.
+    vector<int> rowOrder( maxRows );
+    for( int i = 0; i < maxRows; ++i )
+        rowOrder[i] = i;
+    random.Shuffle( rowOrder.begin(), rowOrder.end() );
+
+    vector<float> space( maxRows, width_ );
+    vector<SSPackedRow> rows( maxRows );
+    for( vector<int>::const_iterator word = sorted.begin(); word != sorted.end(); ++word ){
+        float wordWidth = packing.widths_[*word];
+        vector<int>::const_iterator row = rowOrder.begin();
+        while( row != rowOrder.end() && space[*row] < wordWidth )
+            ++row;
+        if( row != rowOrder.end() ){
+            rows[*row].push_back( *word );
+            space[*row] -= wordWidth;
+        }
+        else if( !lastResort )
+            return false;
+        else if( *word == 0 ){
+            // Too wide for the region even on its own: it gets a row to itself, and overhangs.
+            rows[rowOrder.front()].push_back( 0 );
+            space[rowOrder.front()] = 0.0f;
+        }
+        else
+            packing.dropped_.push_back( *word );
+    }
+
+    for( vector<SSPackedRow>::const_iterator row = rows.begin(); row != rows.end(); ++row ){
+        if( !row->empty() )
+            packing.rows_.push_back( *row );
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+// SSPacker.h
+/*
+Packs the words of a Spelling Spotting question into rows, in bounded time.
+The words go in widest first, each into the first row with room, with the rows tried in a random order.
+The word order is shuffled before sorting so equal widths are tied randomly, and everything random comes
+from the RandomStream - the same seed always gives the same layout.
+If the words don't all fit, the next smaller size from the WordMeasure is tried.  At the smallest size
+any wrong spellings that still don't fit are left out; the correct spelling is always placed.
+Measuring goes through WordMeasure, so layouts can be worked out without GDI+.
+*/
+
+#ifndef SSPACKER_H
+#define SSPACKER_H
+
+#include <string>
+#include <vector>
+
+class RandomStream;
+
+class WordMeasure{
+public:
+    virtual ~WordMeasure() {}
+
+    virtual unsigned int Sizes() = 0;                                   // Font sizes to try, largest (0) first
+    virtual float Width( unsigned int size, const std::wstring& word ) = 0;
+    virtual float Height( unsigned int size ) = 0;                       // Of a line of text
+};
+
+typedef std::vector<int> SSPackedRow; // Word indices: 0 is the correct spelling, then the wrong ones in the order given
+
+struct SSPacking{
+    SSPacking();
+
+    unsigned int size_;              // The WordMeasure size used
+    float rowHeight_;                // Padding and margins included
+    std::vector<float> widths_;      // Of each word at size_, padding and margins included
+    std::vector<SSPackedRow> rows_;  // No empty rows
+    std::vector<int> dropped_;       // Wrong spellings that didn't fit at any size
+};
+
+class SSPacker{
+public:
+    // boxWidth and boxHeight are the padding and margins added around each word.
+    SSPacker( WordMeasure& measure, float width, float height, float boxWidth, float boxHeight );
+
+    void Pack( const std::wstring& correctSpelling, const std::vector<std::wstring>& wrongSpellings,
+               RandomStream& random, SSPacking& packing );
+
+private:
+    // Returns false if a word wouldn't fit, unless lastResort, when misfits are dropped instead.
+    bool PackAt( unsigned int size, const std::vector<int>& order, bool lastResort, RandomStream& random,
+                 SSPacking& packing );
+
+private:
+    WordMeasure& measure_;
+    float width_, height_;
+    float boxWidth_, boxHeight_;
+    std::vector<std::wstring> words_; // Correct spelling first
+};
+
+#endif // SSPACKER_H
@@ -4,23 +4,53 @@
 #include <gdiplus.h>
 #include "BackBuffer.h"
 #include <string>
+#include <sstream>
 
 using namespace Gdiplus;
 using namespace std;
 
+GdiplusMetrics::GdiplusMetrics(BackBuffer* bb, const Gdiplus::StringFormat& format)
+: bb_(bb)
+, format_(format)
+{}
+
+std::wstring GdiplusMetrics::FontKey(const Gdiplus::Font& font){
+    WCHAR family[LF_FACESIZE] = L"";
+    FontFamily fontFamily;
+    if( font.GetFamily(&fontFamily) == Ok )
+        fontFamily.GetFamilyName(family);
+    wostringstream key;
+    key << family << L'|' << font.GetSize() << L'|' << font.GetStyle() << L'|' << font.GetUnit();
+    return key.str();
+}
+
+float GdiplusMetrics::Advance(const Gdiplus::Font& font, wchar_t letter){
+    Gdiplus::RectF rec;
+    Gdiplus::Graphics graph(bb_->getDC());
+    graph.MeasureString(&letter, 1, &font, Gdiplus::PointF(0.0f, 0.0f), &format_, &rec);
+    return rec.GetRight();
+}
+
 ScreenPrinter::ScreenPrinter(BackBuffer* bb)
 : bb_(bb)
 , xOff_(bb->mOffX)
 , yOff_(bb->mOffY)
-{}
+, format_(Gdiplus::StringFormat::GenericTypographic())
+, metrics_(bb, format_)
+, layout_(metrics_)
+{
+    format_.SetFormatFlags(Gdiplus::StringFormatFlagsMeasureTrailingSpaces);
+}
 
 
 Gdiplus::PointF ScreenPrinter::PrintLetter(wchar_t letter, Gdiplus::PointF& position, Gdiplus::Font& font,
                                         Gdiplus::Color& colour) {
-    Gdiplus::StringFormat sfNormal(Gdiplus::StringFormat::GenericTypographic());
-    sfNormal.SetFormatFlags(Gdiplus::StringFormatFlagsMeasureTrailingSpaces);
+    Gdiplus::SolidBrush brush( colour );
+    Gdiplus::Graphics graph(bb_->getDC());
+ 
+    graph.DrawString(&letter, 1, &font, Gdiplus::PointF(position.X + xOff_, position.Y + yOff_), &format_, &brush);
     
-    return PrintLetter(letter, position, font, colour, sfNormal);                                                                             
+    return Gdiplus::PointF( position.X + layout_.Advance(font, letter), position.Y );
 }
 
 Gdiplus::PointF ScreenPrinter::PrintLetter(wchar_t letter, Gdiplus::PointF& position, const Gdiplus::Font& font,
@@ -32,7 +62,7 @@ Gdiplus::PointF ScreenPrinter::PrintLetter(wchar_t letter, Gdiplus::PointF& posi
     Gdiplus::Graphics graph(bb_->getDC());
  
     graph.DrawString(ws.c_str(), -1, &font, pos, &format, &brush);
-    graph.MeasureString(ws.c_str(), -1, &font, pos, &format, &rec);
+    graph.MeasureString(ws.c_str(), -1, &font, pos, &format, &rec); // Caller's format, so not cached
     
     return Gdiplus::PointF( rec.GetRight() - xOff_, rec.Y- yOff_ );                                                                               
 }
@@ -42,20 +72,39 @@ Gdiplus::PointF ScreenPrinter::PrintLetterFixedWidth(wchar_t letter, Gdiplus::Po
     std::wstring ws(1,  letter);
     Gdiplus::PointF pos(position.X + xOff_, position.Y + yOff_);
     Gdiplus::SolidBrush brush( colour );
-    Gdiplus::RectF rec;
     Gdiplus::Graphics graph(bb_->getDC());
 
-    Gdiplus::StringFormat sfNormal(Gdiplus::StringFormat::GenericTypographic());
-    sfNormal.SetFormatFlags(Gdiplus::StringFormatFlagsMeasureTrailingSpaces);
-    Gdiplus::StringFormat sfFixedWidth;
-    sfFixedWidth.SetFormatFlags(sfNormal.GetFormatFlags() - Gdiplus::StringFormatFlagsNoFitBlackBox);
-
     graph.DrawString(ws.c_str(), -1, &font, pos, &brush);
     //MISMATCH
     return Gdiplus::PointF( pos.X + width - xOff_, pos.Y - yOff_ );                           
                            
 }
 
+Gdiplus::PointF ScreenPrinter::PrintLetters(const std::wstring& letters, const Gdiplus::PointF& position,
+                                        const Gdiplus::Font& font, const std::vector<Gdiplus::Color>& colours) {
+    vector<unsigned int> argb;
+    argb.reserve(colours.size());
+    for( vector<Color>::const_iterator iter = colours.begin(); iter != colours.end(); ++iter )
+        argb.push_back(iter->GetValue());
+
+    TextRunList runs;
+    float end = layout_.Runs(font, letters, argb, position.X, runs);
+
+    Gdiplus::Graphics graph(bb_->getDC());
+    for( TextRunList::const_iterator run = runs.begin(); run != runs.end(); ++run ){
+        Gdiplus::SolidBrush brush( colours[run->first_] );
+        graph.DrawString(letters.c_str() + run->first_, static_cast<INT>(run->length_), &font,
+                         Gdiplus::PointF(run->x_ + xOff_, position.Y + yOff_), &format_, &brush);
+    }
+
+    return Gdiplus::PointF( end, position.Y );
+}
+
+Gdiplus::PointF ScreenPrinter::PrintLetters(const std::wstring& letters, const Gdiplus::PointF& position,
+                                        const Gdiplus::Font& font, const Gdiplus::Color& colour) {
+    return PrintLetters(letters, position, font, vector<Color>(letters.length(), colour));
+}
+
 // Prints string, ensuring the text fits in a specified rectangular area.
 // If it doesn't, it truncates the string (from the FRONT) until it fits, or until there is only one
 // character left in the string.
@@ -63,20 +112,16 @@ void ScreenPrinter::PrintTruncString(const std::wstring string, const Gdiplus::P
                                 const Gdiplus::Font &font, const Gdiplus::Color& colour,
                                 const Gdiplus::RectF& targetRec ) {
     
-    Gdiplus::StringFormat sfNormal(Gdiplus::StringFormat::GenericTypographic());
-    std::wstring localStr = string; // Copy string
+    size_t cut = layout_.FrontCut(font, string, targetRec.Width); // Worked out from the cached letter widths
     Gdiplus::PointF pos(position.X + xOff_, position.Y + yOff_); // Adjust position for offset
     Gdiplus::SolidBrush brush( colour );
-    //Gdiplus::RectF targetRec(pos.X, pos.Y, 400.0f, 50.0f);
-    Gdiplus::RectF measuredRec; // This rectangle is used in the measuring process
     Gdiplus::Graphics graph(bb_->getDC());
-    do{
-        graph.MeasureString(localStr.c_str(), -1, &font, pos, &sfNormal, &measuredRec); // Check string fits.
-        if( measuredRec.Width > targetRec.Width ) // If it doesn't...
-            localStr = localStr.substr(1, localStr.length() - 1); // ...chop off the leading character...
-    } while ( measuredRec.Width > targetRec.Width && localStr.length() > 1 ); //...until it fits, or there is only one char left.
     
     // Now print the string.
-    graph.DrawString(localStr.c_str(), -1,  &font, pos, &sfNormal, &brush);
+    graph.DrawString(string.c_str() + cut, static_cast<INT>(string.length() - cut),  &font, pos, &format_, &brush);
     
-}
\ No newline at end of file
+}
+
+TextLayout& ScreenPrinter::Layout(){
+    return layout_;
+}
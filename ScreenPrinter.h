@@ -6,9 +6,24 @@
 #include <windows.h>
 #include <gdiplus.h>
 #include <string>
+#include <vector>
+#include "TextLayout.h"
 
 class BackBuffer;
 
+// Measures letters with GDI+, the way ScreenPrinter's compact printing lays them out.
+class GdiplusMetrics : public GlyphMetrics{
+public:
+    GdiplusMetrics(BackBuffer* bb, const Gdiplus::StringFormat& format);
+
+    std::wstring FontKey(const Gdiplus::Font& font);
+    float Advance(const Gdiplus::Font& font, wchar_t letter);
+
+private:
+    BackBuffer* bb_;
+    const Gdiplus::StringFormat& format_;
+};
+
 class ScreenPrinter{
 public:
 
@@ -24,16 +39,35 @@ public:
     // Uses a capital W to determine a fixed width
     Gdiplus::PointF PrintLetterFixedWidth(wchar_t letter, Gdiplus::PointF& position, Gdiplus::Font& font,
                            Gdiplus::Color& colour, Gdiplus::REAL width);
+
+    // Several Letter Printing:
+    // Uses compact printing, with a colour for each letter. Letters next to each other in the same
+    // colour are drawn in one go. Returns the position after the last letter, as PrintLetter does.
+    Gdiplus::PointF PrintLetters(const std::wstring& letters, const Gdiplus::PointF& position,
+                           const Gdiplus::Font& font, const std::vector<Gdiplus::Color>& colours);
+    // All in one colour
+    Gdiplus::PointF PrintLetters(const std::wstring& letters, const Gdiplus::PointF& position,
+                           const Gdiplus::Font& font, const Gdiplus::Color& colour);
                            
     // String Printing:
     // Uses compact printing
     void PrintTruncString(const std::wstring string, const Gdiplus::PointF& position, const Gdiplus::Font& font,
                         const Gdiplus::Color& colour, const Gdiplus::RectF& targetRec);
+
+    TextLayout& Layout(); // Letter widths for compact printing, measured once each
            
 public:
     BackBuffer* bb_;
     int xOff_, yOff_;
+
+private:
+    ScreenPrinter(const ScreenPrinter&);
+    ScreenPrinter& operator=(const ScreenPrinter&);
+
+    Gdiplus::StringFormat format_; // Compact printing
+    GdiplusMetrics metrics_;
+    TextLayout layout_;
 };
 
 
-#endif // SCREENPRINTER
\ No newline at end of file
+#endif // SCREENPRINTER
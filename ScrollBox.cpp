@@ -2,6 +2,7 @@
 
 #include "ScrollBox.h"
 #include "BackBuffer.h"
+#include "ImageCache.h"
 #include <algorithm>
 #include <math.h>
 
@@ -137,11 +138,13 @@ ImageColumn::ImageColumn()
 : Column()
 , imageWidth_(0), imageHeight_(0)
 , justifyAdjustment_(0.0f)
+, pImages_(0)
 {}
 
-ImageColumn::ImageColumn(Column::Justify j, int columnWidth, int imageWidth, int imageHeight )
+ImageColumn::ImageColumn(Column::Justify j, int columnWidth, int imageWidth, int imageHeight, ImageCache& images )
 : Column(j, columnWidth)
 , imageWidth_(imageWidth), imageHeight_(imageHeight), justifyAdjustment_(0.0f)
+, pImages_(&images)
 {
      
      // Calculate adjustments for horizontal justification, if necessary.
@@ -153,7 +156,10 @@ ImageColumn::ImageColumn(Column::Justify j, int columnWidth, int imageWidth, int
      }
 }
 
-ImageColumn::~ImageColumn(){}
+ImageColumn::~ImageColumn(){
+    for( ImageMap::iterator iter = shown_.begin(); iter != shown_.end(); ++iter )
+        pImages_->Release( iter->second );
+}
 
 void ImageColumn::Print(BackBuffer& bb, const std::wstring &data,
                         const Gdiplus::RectF &rec, const Gdiplus::Color &col,
@@ -169,9 +175,14 @@ void ImageColumn::Print(BackBuffer& bb, const std::wstring &data,
         recCopy.Y += (rec.Height - imageHeight_)/2;  
      }
      
-     // Create Image
-     Gdiplus::Image* pImage = new Image( data.c_str() );
-     graphics.DrawImage(pImage, recCopy);
+     // Get Image
+     if( !pImages_ )
+        return;
+     ImageMap::iterator found = shown_.find( data );
+     if( found == shown_.end() )
+        found = shown_.insert( ImageMap::value_type( data, pImages_->Acquire( data ) ) ).first;
+     if( found->second )
+        graphics.DrawImage(found->second, recCopy);
 
 }
 
@@ -230,30 +241,80 @@ bool RowData::EqualToID( const unsigned int id ) const {
 }
 
 
+// TABLESOURCE
+TableSource::TableSource( std::vector<RowData*>* data )
+: data_(data), visible_(data ? static_cast<int>( data->size() ) : 0)
+{}
+
+int TableSource::Rows(){
+    return visible_;
+}
+
+const RowData& TableSource::Row( int row ){
+    return *(*data_)[row];
+}
+
+void TableSource::Refresh(){
+    // This is required on the off-chance some rows have been made "invisible".
+    // the partition brings the visible rows to the front of the container, and
+    // the printing process stops when it gets to the first invisible row or
+    // reaches the end of the data.
+    visible_ = distance(data_->begin(), stable_partition(data_->begin(), data_->end(), mem_fun(&RowData::IsVisible)));
+}
+
+std::vector<RowData*>* TableSource::Data(){
+    return data_;
+}
+
+void TableSource::SetData( std::vector<RowData*>* data ){
+    data_ = data;
+    visible_ = static_cast<int>( data_->size() );
+}
+
 // SCROLLBOX
 
 ScrollBox::ScrollBox(TableData* data, Gdiplus::PointF pos, int rowHeight, int numRows)
-: data_(data)
+: table_(data)
+, source_(&table_)
 , position_(pos)
 , rowHeight_(rowHeight)
-, totalWidth_(0)
-, rowColour1_(50,0,0,255)
-, rowColour2_(100,0,0,255)
 , numRows_(numRows)
-, currentTopRow_(0)
-, selectable_(true)
-, selectedRow_(-1)
-, selectionColour_(255,50,0)
 , upImage_(new Bitmap(L"Images/upArrow.bmp"))
 , downImage_(new Bitmap(L"Images/downArrow.bmp"))
 , up_(upImage_, PointF(0.0, 0.0),0.0f, 0.0f, Button::Normal, Button::Normal, Color(0,0,0,0))
 , down_(downImage_, PointF(0.0, 0.0),0.0f, 0.0f, Button::Normal, Button::Normal, Color(0,0,0,0))
-, barGrabbed_(false)
-, barClicked_(0)
-, scrollBarDisabled_(false)
-, timer_(0.0)
-, numVisibleData_(data_->size())
-{}
+{
+    Init();
+}
+
+ScrollBox::ScrollBox(RowSource& source, Gdiplus::PointF pos, int rowHeight, int numRows)
+: table_(0)
+, source_(&source)
+, position_(pos)
+, rowHeight_(rowHeight)
+, numRows_(numRows)
+, upImage_(new Bitmap(L"Images/upArrow.bmp"))
+, downImage_(new Bitmap(L"Images/downArrow.bmp"))
+, up_(upImage_, PointF(0.0, 0.0),0.0f, 0.0f, Button::Normal, Button::Normal, Color(0,0,0,0))
+, down_(downImage_, PointF(0.0, 0.0),0.0f, 0.0f, Button::Normal, Button::Normal, Color(0,0,0,0))
+{
+    Init();
+}
+
+void ScrollBox::Init(){
+    totalWidth_ = 0;
+    rowColour1_ = Color(50,0,0,255);
+    rowColour2_ = Color(100,0,0,255);
+    currentTopRow_ = 0;
+    selectable_ = true;
+    selectedRow_ = -1;
+    selectionColour_ = Color(255,50,0);
+    barGrabbed_ = false;
+    barClicked_ = 0;
+    scrollBarDisabled_ = false;
+    timer_ = 0.0;
+    numVisibleData_ = source_->Rows();
+}
 
 ScrollBox::~ScrollBox(){
     for(list<Column*>::iterator iter = columns_.begin(); iter != columns_.end(); ++iter) {
@@ -270,7 +331,8 @@ ScrollBox::~ScrollBox(){
 }
 
 void ScrollBox::AddData(RowData* data){
-    data_->push_back(data);
+    if( table_.Data() )
+        table_.Data()->push_back(data);
 }
 
 void ScrollBox::AddColumn(Column::Justify j, int columnWidth,
@@ -286,8 +348,8 @@ void ScrollBox::AddColumn(Column::Justify j, int columnWidth,
 }
 
 void ScrollBox::AddColumn(Column::Justify j, int columnWidth,
-                            int imageWidth, int imageHeight ){
-    columns_.push_back(new ImageColumn(j, columnWidth, imageWidth, imageHeight));
+                            int imageWidth, int imageHeight, ImageCache& images ){
+    columns_.push_back(new ImageColumn(j, columnWidth, imageWidth, imageHeight, images));
     UpdateAfterNewColumn(columnWidth);                           
 }
 
@@ -342,7 +404,7 @@ void ScrollBox::UpdateScrollBar(){
 }
 
 void ScrollBox::UpdateScrollBarPosition(){
-    if( data_->empty() )
+    if( numVisibleData_ == 0 )
         return;
 
     scrollBar_.Height = (numRows_ * scrollRectangle_.Height) / numVisibleData_ - 2.0f;
@@ -361,7 +423,9 @@ void ScrollBox::UpdateScrollBarPosition(){
 }
 
 
-void ScrollBox::Update(double dt, const Gdiplus::PointF& mousePos ){
+bool ScrollBox::Update(double dt, const Gdiplus::PointF& mousePos ){
+    int topRow = currentTopRow_;
+    REAL barY = scrollBar_.Y;
     timer_ += dt;
     if( timer_ >= 0.1 ){
         if( down_.GetState() == Button::Clicked ){
@@ -377,11 +441,22 @@ void ScrollBox::Update(double dt, const Gdiplus::PointF& mousePos ){
     }
     if( barGrabbed_ )
         DragBar(mousePos);
+    return currentTopRow_ != topRow || scrollBar_.Y != barY;
+}
 
+bool ScrollBox::Scrolling() const{
+    return down_.GetState() == Button::Clicked || up_.GetState() == Button::Clicked || barClicked_ != 0;
+}
+
+Gdiplus::RectF ScrollBox::Bounds() const{
+    if( numRows_ <= 0 )
+        return RectF();
+    return RectF(position_.X, position_.Y, static_cast<REAL>( totalWidth_ ) + up_.Width(),
+                 static_cast<REAL>( numRows_ * rowHeight_ ));
 }
 
 void ScrollBox::Display(BackBuffer& bb){
-    if( columns_.empty() || data_->empty() ) return;
+    if( columns_.empty() || source_->Rows() == 0 ) return;
         
     PointF pos = position_; // Make a working copy of the top left corner.
     
@@ -410,7 +485,7 @@ void ScrollBox::Display(BackBuffer& bb){
         // Get data, if this isn't an empty row
         if( i < static_cast<int>(numVisibleData_) ){
             // Get row of data
-            RowData* data( (*data_)[i] );
+            const RowData* data( &source_->Row(i) ); // Only rows on show are ever made
             // Set ink colour
             Color dataInk(0,0,0);
             // If inactive, lighten ink colour TODO: CREATE NORMAL AND ACTIVE INK
@@ -574,12 +649,9 @@ void ScrollBox::ClearSelectedRow(){
 }
 
 void ScrollBox::Refresh(){
-    // This is required on the off-chance some rows have been made "invisible".
-    // the partition brings the visible rows to the front of the container, and
-    // the printing process below stops when it gets to the first invisible row or
-    // reaches the end of the data.
-    numVisibleData_ = distance(data_->begin(), stable_partition(data_->begin(), data_->end(), mem_fun(&RowData::IsVisible)));
-    // count how many data are actually visible
+    // Rows may have been hidden, shown or reordered since the source was last asked.
+    source_->Refresh();
+    numVisibleData_ = source_->Rows(); // count how many data are actually visible
     ValidateTopRow();
     UpdateScrollBar();
 }
@@ -635,7 +707,9 @@ void ScrollBox::DragBar(const Gdiplus::PointF &mousePos) {
 }
 
 void ScrollBox::SwapData(TableData* data){
-    data_ = data;
+    table_.SetData( data );
+    source_ = &table_;
+    numVisibleData_ = source_->Rows();
     ValidateTopRow();
     UpdateScrollBarPosition();
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <cstdlib>
 
 class BackBuffer;
+class ImageCache;
 
 class Column{
 public:
@@ -76,11 +77,12 @@ protected:
     
 };
 
-// Shows images specified by filename data.
+// Shows images specified by filename data.  Each file is taken from images once, on first display,
+// and released with the column.
 class ImageColumn : public Column {
 public:
     ImageColumn();
-    ImageColumn(Column::Justify j, int columnWidth, int imageWidth, int imageHeight );
+    ImageColumn(Column::Justify j, int columnWidth, int imageWidth, int imageHeight, ImageCache& images );
                          
     ~ImageColumn();
     
@@ -88,8 +90,11 @@ public:
                         bool active);
 
 protected:
+    typedef std::map<std::wstring, Gdiplus::Bitmap*> ImageMap;
     int imageWidth_, imageHeight_;
     Gdiplus::REAL justifyAdjustment_;
+    ImageCache* pImages_;
+    ImageMap shown_; // Images acquired so far, by filename
     
     
 };
@@ -142,15 +147,44 @@ bool ColumnNumericSort(const RowData* l, const RowData* r){
     return _wtoi(l->data_[N].c_str()) < _wtoi(r->data_[N].c_str());
 }
 
+// Where a ScrollBox gets its rows.  Only the rows on show are asked for, so a source can make each one as
+// it is needed instead of keeping a RowData for every row.
+class RowSource{
+public:
+    virtual ~RowSource() {}
+    
+    virtual int Rows() = 0;                   // How many rows there are to show
+    virtual const RowData& Row( int row ) = 0; // Row, from 0 to Rows()-1.  Valid until the next call.
+    virtual void Refresh() {}                 // The rows have changed - called by ScrollBox::Refresh
+};
+
+// Rows kept as a TableData made by the client.  Visible rows are moved to the front by Refresh.
+class TableSource : public RowSource{
+public:
+    explicit TableSource( std::vector<RowData*>* data );
+    
+    int Rows();
+    const RowData& Row( int row );
+    void Refresh();
+    
+    std::vector<RowData*>* Data();
+    void SetData( std::vector<RowData*>* data );
+    
+private:
+    std::vector<RowData*>* data_; // Belongs to the client
+    int visible_;
+};
+
 // TODO: Make many of the settings customisable by client.
 class ScrollBox{
 public:
     //typedef std::vector<std::wstring> RowData; // Single row of data
     typedef std::vector<RowData*> TableData;    // Collection of all rows 
     ScrollBox(TableData* data, Gdiplus::PointF pos, int rowHeight, int numRows = 0);
+    ScrollBox(RowSource& source, Gdiplus::PointF pos, int rowHeight, int numRows = 0); // source outlives the box
     
     ~ScrollBox();
-    void AddData( RowData* data );
+    void AddData( RowData* data ); // Only for a box made with TableData
     
     // For Text columns
     void AddColumn( Column::Justify j, int columnWidth,
@@ -160,15 +194,17 @@ public:
                     Gdiplus::Image* image, IconColumn::ValueList values );
     // For Image columns
     void AddColumn( Column::Justify j, int columnWidth,
-                    int imageWidth, int imageHeight );
+                    int imageWidth, int imageHeight, ImageCache& images );
                     
     void SetRowColours( Gdiplus::Color& colour1, Gdiplus::Color& colour2 );
     void SetRowColours( Gdiplus::Color& colour); //sets both rows to the same colour
     void SetSelectedColour( Gdiplus::Color& colour );
     //TODO: ink colour / active ink colour
     
-    void Update( double dt, const Gdiplus::PointF& mousePos );
+    bool Update( double dt, const Gdiplus::PointF& mousePos ); // Returns true if it scrolled
     void Display( BackBuffer& bb );
+    bool Scrolling() const; // True while a held button or bar keeps it scrolling
+    Gdiplus::RectF Bounds() const; // Rows and scroll bar.  Empty until the number of rows is known.
     
     // Clicking on a row
     // If a cell is clicked, this function returns the row and col (as pair<int,int>) of the table.
@@ -199,9 +235,11 @@ private:
     void Scroll(int rows);
     void DragBar(const Gdiplus::PointF& mousePos);
     void ValidateTopRow(); // Checks that currentTopRow_ is valid.
+    void Init();
 
 private:
-    TableData* data_;// Note: POINTER data member - data is created by the client, but can be manipulated by ScrollBox.
+    TableSource table_; // Used when the client gives TableData.  Note: that data can be manipulated by ScrollBox.
+    RowSource* source_; // table_, or the client's own source
                        
     std::list<Column*> columns_;
     Gdiplus::PointF position_;
@@ -213,8 +251,7 @@ private:
     int currentTopRow_;             // The item in the RowData displayed on the top (visible) row.
     bool selectable_;               // Whether a row in the scrollbox can be visibly selected.
     int selectedRow_;               // The currently selected row.  -1 if none selected.
-    unsigned int numVisibleData_;   // How many rows of data are "visible".
-    TableData::iterator cutOffPoint; // Position in TableData to stop printing - this is where the invisible data starts.
+    unsigned int numVisibleData_;   // How many rows of data are "visible" - source_->Rows() at the last Refresh.
     
     Gdiplus::Color selectionColour_; // Background colour for a selected row.
     
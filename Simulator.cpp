@@ -0,0 +1,313 @@
+// Simulator.cpp
+
+#include "Simulator.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include "Word.h"
+#include "Speller.h"
+#include "Range.h"
+#include "WordIndex.h"
+
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    double Microseconds( Clock::duration d ){
+        return chrono::duration<double, micro>(d).count();
+    }
+
+    // Value at fraction p of a sorted list.
+    double Percentile( const vector<double>& sorted, double p ){
+        if( sorted.empty() ) return 0.0;
+        size_t i = static_cast<size_t>( p * (sorted.size() - 1) + 0.5 );
+        return sorted[i];
+    }
+
+    wchar_t RandomLetter( RandomStream& random ){
+        return static_cast<wchar_t>( L'a' + random.Random(0, 25) );
+    }
+
+    enum{ ATTEMPTSTREAM = 0 }; // Speller sessions use streams 1..N
+}
+
+ErrorModel::ErrorModel()
+: substitute_(0.03), omit_(0.02), insert_(0.01), swap_(0.02)
+{}
+
+SimulationSettings::SimulationSettings()
+: spellers_(10), words_(200), attemptsPerSpeller_(1000), weighting_(SpellingSession::WEIGHTING),
+  engine_(SpellingAnalyser::PATTERNMATCHING), skillSpread_(0.5), secondsPerAttempt_(20), seed_(1)
+{}
+
+SimulationReport::SimulationReport()
+: seed_(0), attempts_(0), correct_(0), seconds_(0.0), attemptsPerSecond_(0.0),
+  p50_(0.0), p90_(0.0), p99_(0.0), max_(0.0)
+{}
+
+wstring SimulationReport::ToString() const {
+    wostringstream out;
+    out << L"seed " << seed_ << L": " << attempts_ << L" attempts (" << correct_ << L" correct) in "
+        << fixed << setprecision(3) << seconds_ << L"s, "
+        << setprecision(0) << attemptsPerSecond_ << L" attempts/s; latency us p50 "
+        << setprecision(1) << p50_ << L", p90 " << p90_ << L", p99 " << p99_ << L", max " << max_;
+    return out.str();
+}
+
+CorpusEntry::CorpusEntry( unsigned int wordID, const wstring& attempt )
+: wordID_(wordID), attempt_(attempt)
+{}
+
+ComparisonReport::ComparisonReport()
+: seed_(0), attempts_(0), labelsAgree_(0), verdictsAgree_(0), scoresAgree_(0),
+  patternMatchingP50_(0.0), patternMatchingP99_(0.0), alignmentP50_(0.0), alignmentP99_(0.0)
+{}
+
+wstring ComparisonReport::ToString() const {
+    double total = attempts_ ? attempts_ : 1;
+    wostringstream out;
+    out << L"seed " << seed_ << L": " << attempts_ << L" attempts: labels agree " << fixed << setprecision(1) << 100.0 * labelsAgree_ / total
+        << L"%, verdicts " << 100.0 * verdictsAgree_ / total << L"%, scores " << 100.0 * scoresAgree_ / total
+        << L"%; latency us p50/p99 pattern matching " << patternMatchingP50_ << L"/" << patternMatchingP99_
+        << L", alignment " << alignmentP50_ << L"/" << alignmentP99_;
+    return out.str();
+}
+
+IndexReport::IndexReport()
+: seed_(0), words_(0), queries_(0), found_(0), buildSeconds_(0.0), p50_(0.0), p99_(0.0), max_(0.0)
+{}
+
+wstring IndexReport::ToString() const {
+    wostringstream out;
+    out << L"seed " << seed_ << L": " << words_ << L" words indexed in " << fixed << setprecision(3) << buildSeconds_ << L"s; "
+        << queries_ << L" queries (" << found_ << L" found the intended word); latency us p50 "
+        << setprecision(1) << p50_ << L", p99 " << p99_ << L", max " << max_;
+    return out.str();
+}
+
+Simulator::Simulator( WordBank& wordBank, DBController* db )
+: wordBank_(wordBank), pDB_(db)
+{}
+
+SimulationReport Simulator::Run( const SimulationSettings& settings ){
+    SimulationReport report;
+    report.seed_ = settings.seed_;
+
+    RandomStream master( settings.seed_ );
+    RandomStream attemptRandom = master.Split( ATTEMPTSTREAM );
+
+    // Every speller practises the same words: the first words_ in the bank.
+    IDList words;
+    for( WordBank::iterator iter = wordBank_.begin(); iter != wordBank_.end() && words.size() < settings.words_; ++iter ){
+        words.insert( iter->first );
+    }
+
+    vector<Speller*> spellers;
+    vector<SpellingSession*> sessions;
+    vector<double> skills; // Multiplies the error model - lower is better.
+    for( unsigned int i = 0; i < settings.spellers_; ++i ){
+        Speller* pSpeller = new Speller( FIRSTSPELLERID + i, L"Simulated", Range(1, 10), L"", IDList(), IDList() );
+        pSpeller->GetWordList() = words;
+        SpellingSession* pSession = new SpellingSession( wordBank_, *pSpeller, pDB_, master.Split(i + 1) );
+        pSession->SetWordList( words, settings.weighting_ );
+        pSession->SetEngine( settings.engine_ );
+        spellers.push_back( pSpeller );
+        sessions.push_back( pSession );
+        skills.push_back( 1.0 + settings.skillSpread_ * (2.0 * attemptRandom.Unit() - 1.0) );
+    }
+
+    vector<double> latencies;
+    latencies.reserve( settings.spellers_ * settings.attemptsPerSpeller_ );
+    Clock::duration total = Clock::duration::zero();
+    long long now = 1000000000; // Simulated seconds - any fixed start will do.
+
+    // Round robin, so spellers interleave as they would on a shared database.
+    for( unsigned int round = 0; round < settings.attemptsPerSpeller_; ++round ){
+        for( size_t i = 0; i < sessions.size(); ++i ){
+            now += settings.secondsPerAttempt_;
+            sessions[i]->SetTime( now );
+
+            Clock::time_point start = Clock::now();
+            Word* pWord = sessions[i]->NextWord();
+            Clock::duration elapsed = Clock::now() - start;
+            if( !pWord ) continue;
+
+            // Making up the attempt is not part of the measured path.
+            wstring spelling = pWord->GetMainSpellingString();
+            wstring attempt = MakeAttempt( spelling, settings.errors_, skills[i], attemptRandom );
+
+            start = Clock::now();
+            AnalysedWord aw( spelling.length() );
+            if( sessions[i]->Check( attempt, aw ) )
+                ++report.correct_;
+            elapsed += Clock::now() - start;
+
+            total += elapsed;
+            latencies.push_back( Microseconds(elapsed) );
+            ++report.attempts_;
+        }
+    }
+
+    for( size_t i = 0; i < sessions.size(); ++i ){
+        delete sessions[i];
+        delete spellers[i];
+    }
+
+    report.seconds_ = Microseconds(total) / 1000000.0;
+    if( report.seconds_ > 0.0 )
+        report.attemptsPerSecond_ = report.attempts_ / report.seconds_;
+    sort( latencies.begin(), latencies.end() );
+    report.p50_ = Percentile( latencies, 0.50 );
+    report.p90_ = Percentile( latencies, 0.90 );
+    report.p99_ = Percentile( latencies, 0.99 );
+    report.max_ = latencies.empty() ? 0.0 : latencies.back();
+    return report;
+}
+
+ComparisonReport Simulator::CompareEngines( const Corpus& corpus, Speller& speller ){
+    ComparisonReport report;
+    vector<double> patternTimes, alignmentTimes;
+    patternTimes.reserve( corpus.size() );
+    alignmentTimes.reserve( corpus.size() );
+
+    for( Corpus::const_iterator iter = corpus.begin(); iter != corpus.end(); ++iter ){
+        WordBank::iterator wordIter = wordBank_.find( iter->wordID_ );
+        if( wordIter == wordBank_.end() ) continue;
+        const Word* pWord = &wordIter->second;
+        unsigned int length = pWord->GetMainSpellingString().length();
+
+        AnalysedWord pattern( length );
+        Clock::time_point start = Clock::now();
+        SpellingAnalyser( iter->attempt_, pWord, speller, pattern, SpellingAnalyser::PATTERNMATCHING );
+        patternTimes.push_back( Microseconds(Clock::now() - start) );
+
+        AnalysedWord alignment( length );
+        start = Clock::now();
+        SpellingAnalyser( iter->attempt_, pWord, speller, alignment, SpellingAnalyser::ALIGNMENT );
+        alignmentTimes.push_back( Microseconds(Clock::now() - start) );
+
+        ++report.attempts_;
+        const AnalysedLetters& p = pattern.GetAnalysis();
+        const AnalysedLetters& a = alignment.GetAnalysis();
+        bool same = p.size() == a.size();
+        for( size_t i = 0; same && i < p.size(); ++i ){
+            same = p[i].letter_ == a[i].letter_ && p[i].status_ == a[i].status_;
+        }
+        if( same )
+            ++report.labelsAgree_;
+        if( pattern.IsCorrect() == alignment.IsCorrect() && pattern.IsBeyondWrong() == alignment.IsBeyondWrong() )
+            ++report.verdictsAgree_;
+        if( pattern.IsCorrect() || pattern.Score() == alignment.Score() ) // Exact matches are never scored
+            ++report.scoresAgree_;
+    }
+
+    sort( patternTimes.begin(), patternTimes.end() );
+    sort( alignmentTimes.begin(), alignmentTimes.end() );
+    report.patternMatchingP50_ = Percentile( patternTimes, 0.50 );
+    report.patternMatchingP99_ = Percentile( patternTimes, 0.99 );
+    report.alignmentP50_ = Percentile( alignmentTimes, 0.50 );
+    report.alignmentP99_ = Percentile( alignmentTimes, 0.99 );
+    return report;
+}
+
+void Simulator::MakeCorpus( Corpus& corpus, unsigned int count, const ErrorModel& errors, RandomStream& random ) const {
+    if( wordBank_.empty() ) return;
+    vector<const Word*> words;
+    words.reserve( wordBank_.size() );
+    for( WordBank::const_iterator iter = wordBank_.begin(); iter != wordBank_.end(); ++iter ){
+        words.push_back( &iter->second );
+    }
+    for( unsigned int i = 0; i < count; ++i ){
+        const Word* pWord = words[ static_cast<size_t>( random.Below( words.size() ) ) ];
+        wstring attempt = MakeAttempt( pWord->GetMainSpellingString(), errors, 1.0, random );
+        corpus.push_back( CorpusEntry(pWord->GetID(), attempt) );
+    }
+}
+
+void Simulator::AddWrongSpellings( Corpus& corpus, const Speller& speller ) const {
+    for( WordBank::const_iterator iter = wordBank_.begin(); iter != wordBank_.end(); ++iter ){
+        StringVec wrong = speller.GetWrongWords( iter->first );
+        for( StringVec::iterator s = wrong.begin(); s != wrong.end(); ++s ){
+            corpus.push_back( CorpusEntry(iter->first, *s) );
+        }
+    }
+}
+
+IndexReport Simulator::BenchmarkIndex( unsigned int queries, size_t k, const ErrorModel& errors,
+                                       const Speller& speller, RandomStream& random ){
+    IndexReport report;
+    report.seed_ = random.GetSeed();
+    WordIndex index;
+    Clock::time_point start = Clock::now();
+    index.Build( wordBank_ );
+    report.buildSeconds_ = Microseconds(Clock::now() - start) / 1000000.0;
+    report.words_ = wordBank_.size();
+
+    Corpus corpus;
+    MakeCorpus( corpus, queries, errors, random );
+    vector<double> latencies;
+    latencies.reserve( corpus.size() );
+    WordIndex::MatchList matches;
+    for( Corpus::iterator iter = corpus.begin(); iter != corpus.end(); ++iter ){
+        start = Clock::now();
+        index.Find( iter->attempt_, speller, k, matches );
+        latencies.push_back( Microseconds(Clock::now() - start) );
+        ++report.queries_;
+        for( WordIndex::MatchList::iterator match = matches.begin(); match != matches.end(); ++match ){
+            if( match->wordID_ == iter->wordID_ ){
+                ++report.found_;
+                break;
+            }
+        }
+    }
+    sort( latencies.begin(), latencies.end() );
+    report.p50_ = Percentile( latencies, 0.50 );
+    report.p99_ = Percentile( latencies, 0.99 );
+    report.max_ = latencies.empty() ? 0.0 : latencies.back();
+    return report;
+}
+
+void Simulator::MakeWordBank( WordBank& bank, unsigned int count, RandomStream& random, unsigned int firstID ){
+    for( unsigned int i = 0; i < count; ++i ){
+        unsigned int id = firstID + i;
+        wstring spelling;
+        int length = random.Random(3, 12);
+        for( int j = 0; j < length; ++j ){
+            spelling += RandomLetter( random );
+        }
+        Word word( id, random.Random(1, 10), false, id );
+        word.AddSpelling( Spelling(id, spelling) );
+        bank.insert( WordBank::value_type(id, word) );
+    }
+}
+
+wstring Simulator::MakeAttempt( const wstring& spelling, const ErrorModel& errors,
+                                double skill, RandomStream& random ) const {
+    double omit = errors.omit_ * skill;
+    double substitute = omit + errors.substitute_ * skill;
+    double swap = substitute + errors.swap_ * skill;
+    double insert = errors.insert_ * skill;
+
+    wstring attempt;
+    for( size_t i = 0; i < spelling.length(); ++i ){
+        double r = random.Unit();
+        if( r < omit ){
+            // Leave it out
+        } else if( r < substitute ){
+            wchar_t c = RandomLetter( random );
+            attempt += ( c == spelling[i] ) ? static_cast<wchar_t>( L'a' + (c - L'a' + 1) % 26 ) : c;
+        } else if( r < swap && i + 1 < spelling.length() ){
+            attempt += spelling[i + 1];
+            attempt += spelling[i];
+            ++i;
+        } else {
+            attempt += spelling[i];
+        }
+        if( random.Unit() < insert )
+            attempt += RandomLetter( random );
+    }
+    return attempt;
+}
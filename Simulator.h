@@ -0,0 +1,117 @@
+// Simulator.h
+// Plays synthetic spellers through SpellingSession without a window, and reports
+// how many attempts per second the select -> analyse -> record path sustains.
+// Pass a DBController for a scratch copy of the database to include database writes.
+// Also compares the two SpellingAnalyser engines over a corpus of attempts, and times WordIndex.
+
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include <string>
+#include <vector>
+#include "Definitions.h"
+#include "Random.h"
+#include "SpellingSession.h"
+
+class DBController;
+class Speller;
+
+// Chance of each mistake, per letter of the word.
+struct ErrorModel{
+    ErrorModel();
+    double substitute_; // Wrong letter
+    double omit_;       // Letter left out
+    double insert_;     // Extra letter after this one
+    double swap_;       // This letter and the next swapped
+};
+
+struct SimulationSettings{
+    SimulationSettings();
+    unsigned int spellers_;
+    unsigned int words_;              // Size of each speller's word list.
+    unsigned int attemptsPerSpeller_;
+    SpellingSession::WeightingOption weighting_;
+    SpellingAnalyser::Engine engine_;
+    ErrorModel errors_;
+    double skillSpread_;              // Each speller's error rates are scaled by 1 +/- up to this.
+    long long secondsPerAttempt_;     // Simulated time between attempts, for scheduling.
+    RandomStream::Seed seed_;         // Same seed, same run.
+};
+
+struct SimulationReport{
+    SimulationReport();
+    std::wstring ToString() const;
+
+    RandomStream::Seed seed_;
+    unsigned int attempts_;
+    unsigned int correct_;
+    double seconds_;           // Time spent in NextWord and Check only.
+    double attemptsPerSecond_;
+    double p50_, p90_, p99_, max_; // Latency of one attempt, in microseconds.
+};
+
+// One attempt at a word, for comparing analysers.
+struct CorpusEntry{
+    CorpusEntry( unsigned int wordID, const std::wstring& attempt );
+    unsigned int wordID_;
+    std::wstring attempt_;
+};
+typedef std::vector<CorpusEntry> Corpus;
+
+struct ComparisonReport{
+    ComparisonReport();
+    std::wstring ToString() const;
+
+    RandomStream::Seed seed_;    // The corpus's: the same seed makes the same attempts
+    unsigned int attempts_;
+    unsigned int labelsAgree_;   // Identical letters and statuses
+    unsigned int verdictsAgree_; // Both correct, both beyond wrong, or both plain wrong
+    unsigned int scoresAgree_;
+    double patternMatchingP50_, patternMatchingP99_; // Latency of one analysis, in microseconds.
+    double alignmentP50_, alignmentP99_;
+};
+
+struct IndexReport{
+    IndexReport();
+    std::wstring ToString() const;
+
+    RandomStream::Seed seed_;
+    unsigned int words_;
+    unsigned int queries_;
+    unsigned int found_;     // Queries whose intended word was among the results
+    double buildSeconds_;
+    double p50_, p99_, max_; // Latency of one query, in microseconds.
+};
+
+class Simulator{
+public:
+    // wordBank must hold at least SimulationSettings::words_ words.  db may be 0.
+    Simulator( WordBank& wordBank, DBController* db = 0 );
+
+    SimulationReport Run( const SimulationSettings& settings );
+
+    // Analyses every entry with both engines, using speller's options.
+    ComparisonReport CompareEngines( const Corpus& corpus, Speller& speller );
+    // Adds count made-up attempts at words from the bank.
+    void MakeCorpus( Corpus& corpus, unsigned int count, const ErrorModel& errors, RandomStream& random ) const;
+    // Adds the wrong spellings recorded for speller.
+    void AddWrongSpellings( Corpus& corpus, const Speller& speller ) const;
+
+    // Builds a WordIndex over the word bank, then looks up the k nearest words to made-up attempts.
+    IndexReport BenchmarkIndex( unsigned int queries, std::size_t k, const ErrorModel& errors,
+                                const Speller& speller, RandomStream& random );
+
+    // Fills bank with count made-up words, with IDs starting at firstID.
+    static void MakeWordBank( WordBank& bank, unsigned int count, RandomStream& random, unsigned int firstID = 1 );
+
+private:
+    std::wstring MakeAttempt( const std::wstring& spelling, const ErrorModel& errors,
+                              double skill, RandomStream& random ) const;
+
+private:
+    enum{ FIRSTSPELLERID = 1000000 }; // Keeps simulated records clear of real spellers.
+    WordBank& wordBank_;
+    DBController* pDB_;
+};
+
+#endif // SIMULATOR_H
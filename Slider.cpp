@@ -46,6 +46,11 @@ void Slider::Display( BackBuffer* bb ){
 
 }
 
+Gdiplus::RectF Slider::Bounds() const{
+    // The knob is taller than the slot, and hangs half its width over either end.
+    return RectF( slot_.X - 0.5f * knob_.Width, knob_.Y, slot_.Width + knob_.Width, knob_.Height );
+}
+
 void Slider::LMBDown( const Gdiplus::PointF& mousePos ){
     if( ClickInRegion( &mousePos, &PointF( knob_.X, knob_.Y ), knob_.Width, knob_.Height ) ) 
         grabbed_ = true;
@@ -13,6 +13,7 @@ public:
     
     void Update( double ratio, const Gdiplus::PointF& mousePos );
     void Display( BackBuffer* bb );
+    Gdiplus::RectF Bounds() const; // Everywhere the knob and slot can be
     
     void LMBDown( const Gdiplus::PointF& mousePos );
     void LMBUp();
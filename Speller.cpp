@@ -10,8 +10,10 @@ WrongSpelling::WrongSpelling()
     : spelling_(L""), score_(0.0), aveLinkLength_(0.0), longestLink_(0), lengthDifference_(0)
 {}
 
-WrongSpelling::WrongSpelling(std::wstring spelling, int score, double aveLinkLength, unsigned int longestLink, unsigned int lengthDifference)
-    : spelling_(spelling), score_(score), aveLinkLength_(aveLinkLength), longestLink_(longestLink), lengthDifference_(lengthDifference)
+WrongSpelling::WrongSpelling(std::wstring spelling, int score, double aveLinkLength, unsigned int longestLink, unsigned int lengthDifference,
+                             const PackedAnalysis& analysis)
+    : spelling_(spelling), score_(score), aveLinkLength_(aveLinkLength), longestLink_(longestLink), lengthDifference_(lengthDifference),
+      analysis_(analysis)
 {}
 
 WrongSpelling::WrongSpelling(const AnalysedWord &aw )
@@ -20,7 +22,17 @@ WrongSpelling::WrongSpelling(const AnalysedWord &aw )
       aveLinkLength_( aw.AverageLinkSize() ),
       longestLink_( aw.LargestLink() ),
       lengthDifference_( aw.LengthDifference() )
-{}
+{
+    PackAnalysis( aw.GetAnalysis(), analysis_ );
+}
+
+bool WrongSpelling::GetAnalysis( AnalysedLetters& letters ) const{
+    if( analysis_.empty() ){
+        letters.clear();
+        return false;
+    }
+    return UnpackAnalysis( &analysis_[0], analysis_.size(), letters );
+}
 
 // TODO: This breaks the requirement of strict weak ordering...
 // TODO:Check this with the version in AnalysedWord (SortOrder).  AnalysedWord seems to work - this needs rewriting.
@@ -46,15 +58,17 @@ bool WrongSpelling::operator <(const WrongSpelling &rhs){
 }
 
 unsigned int Record::MAXWRONGSPELLINGS = 10;
+long long    Record::FIRSTINTERVAL = 5 * 60;            // five minutes
+long long    Record::MAXINTERVAL   = 60 * 24 * 60 * 60; // sixty days
 
 Record::Record()
-    : wordID_(0), numAttempts_(0), level_(0)
+    : wordID_(0), numAttempts_(0), level_(0), lastSeen_(0), interval_(0)
 {
     wrongSpellings_.clear();
 }
 
-Record::Record(unsigned int wordID, unsigned int numAttempts, int level)
-    : wordID_(wordID), numAttempts_(numAttempts), level_(level)
+Record::Record(unsigned int wordID, unsigned int numAttempts, int level, long long lastSeen, long long interval)
+    : wordID_(wordID), numAttempts_(numAttempts), level_(level), lastSeen_(lastSeen), interval_(interval)
 {
     wrongSpellings_.clear();
 }
@@ -79,6 +93,29 @@ void Record::AddAttempt(){
     ++numAttempts_;
 }
 
+long long Record::GetLastSeen() const{
+    return lastSeen_;
+}
+
+long long Record::GetInterval() const{
+    return interval_;
+}
+
+long long Record::GetDue() const{
+    return lastSeen_ + interval_;
+}
+
+void Record::Review( long long now, bool correct ){
+    lastSeen_ = now;
+    if( correct ){
+        interval_ = max( interval_, FIRSTINTERVAL ) * 2;
+        if( interval_ > MAXINTERVAL )
+            interval_ = MAXINTERVAL;
+    } else {
+        interval_ = FIRSTINTERVAL;
+    }
+}
+
 void Record::AddWrongSpelling( WrongSpelling& ws ){
     wrongSpellings_.push_back( ws );
 }
@@ -111,6 +148,10 @@ StringVec Record::GetWrongWords() const{
     return wrongSpellings;
 }
 
+const WrongSpellingList& Record::GetWrongSpellings() const{
+    return wrongSpellings_;
+}
+
 void Record::RemoveExcessiveWrongSpellings( unsigned int spellerID, DBController* db ){
     // Are there too many wrong spellings?
     if( wrongSpellings_.size() > MAXWRONGSPELLINGS ){
@@ -215,6 +256,13 @@ StringVec Speller::GetWrongWords( const int wordID ) const{
     return iter->second.GetWrongWords();
 }
 
+WrongSpellingList Speller::GetWrongSpellings( const int wordID ) const{
+    SpellingRecord::const_iterator iter = spellingRecord_.find(wordID);
+    if( iter == spellingRecord_.end() )
+        return WrongSpellingList();
+    return iter->second.GetWrongSpellings();
+}
+
 int Speller::GetWordLevel(const int wordID) const {
     if( spellingRecord_.empty() )
         return 4; // 4 is starting level for unattempted words.
@@ -232,8 +280,8 @@ void Speller::CreateRecord( const int wordID ) {
     spellingRecord_[wordID] = Record(wordID, 1, 0);
 }
 
-void Speller::AddRecord( const int wordID, unsigned int attempts, int level ){
-    spellingRecord_[wordID] = Record( wordID, attempts, level );
+void Speller::AddRecord( const int wordID, unsigned int attempts, int level, long long lastSeen, long long interval ){
+    spellingRecord_[wordID] = Record( wordID, attempts, level, lastSeen, interval );
 }
 
 void Speller::IncreaseAttempts( const int wordID ) {
@@ -246,6 +294,32 @@ void Speller::SetLevel( const int wordID, const int level ){
         spellingRecord_[wordID].SetLevel( level );
 }
 
+long long Speller::GetWordLastSeen( const int wordID ) const{
+    SpellingRecord::const_iterator iter = spellingRecord_.find( wordID );
+    if( iter == spellingRecord_.end() )
+        return 0;
+    return iter->second.GetLastSeen();
+}
+
+long long Speller::GetWordInterval( const int wordID ) const{
+    SpellingRecord::const_iterator iter = spellingRecord_.find( wordID );
+    if( iter == spellingRecord_.end() )
+        return 0;
+    return iter->second.GetInterval();
+}
+
+long long Speller::GetWordDue( const int wordID ) const{
+    SpellingRecord::const_iterator iter = spellingRecord_.find( wordID );
+    if( iter == spellingRecord_.end() )
+        return 0; // Never seen, so due now.
+    return iter->second.GetDue();
+}
+
+void Speller::ReviewWord( const int wordID, long long now, bool correct ){
+    if( RecordExists( wordID ) )
+        spellingRecord_[wordID].Review( now, correct );
+}
+
 void Speller::AddWrongSpelling( int wordID, WrongSpelling& ws ){
     if( RecordExists( wordID ) )
         spellingRecord_[wordID].AddWrongSpelling( ws );  
@@ -18,15 +18,18 @@ struct WrongSpelling{
     WrongSpelling(const AnalysedWord& aw);
     WrongSpelling(std::wstring spelling,
                   int score, double aveLinkLength,
-                  unsigned int longestLink, unsigned int lengthDifference );
+                  unsigned int longestLink, unsigned int lengthDifference,
+                  const PackedAnalysis& analysis = PackedAnalysis() );
     
     bool operator< (const WrongSpelling& rhs);
+    bool GetAnalysis( AnalysedLetters& letters ) const; // Unpacks analysis_ for replaying.  False if none was stored.
     
     std::wstring spelling_;         // The spelling attempt.
     int          score_;            // The score for this spelling
     double       aveLinkLength_;    // Average length of each "link" (consecutive correct letters)
     unsigned int longestLink_;      // The longest "link" (consecutive correct letters)
     unsigned int lengthDifference_; // Absolute difference in characters between target word and this attempt
+    PackedAnalysis analysis_;       // Letters and statuses of the attempt.  Empty for spellings stored before these were kept.
     
     
     /*
@@ -45,7 +48,8 @@ typedef std::vector<WrongSpelling> WrongSpellingList;
 class Record{
 public:
     Record();
-    Record(unsigned int wordID, unsigned int numAttempts, int level);
+    Record(unsigned int wordID, unsigned int numAttempts, int level,
+           long long lastSeen = 0, long long interval = 0);
     
     bool operator<(const Record& rhs);
     
@@ -54,20 +58,32 @@ public:
     void         SetLevel( const int level );
     
     void AddAttempt();
+    
+    // Spaced repetition - times are in seconds.
+    long long    GetLastSeen() const;
+    long long    GetInterval() const;
+    long long    GetDue() const;  // When the word should next be seen.
+    void         Review( long long now, bool correct ); // Reschedules after a check: interval doubles if correct, resets if not.
+    
     void AddWrongSpelling( WrongSpelling& ws ); // Used on loading - no database update
     void AddWrongSpelling( WrongSpelling& ws, unsigned int spellerID, DBController* db); // Used during running - changes to WrongSpellings.
     unsigned int GetNumWrongWords() const;
     StringVec GetWrongWords() const;
+    const WrongSpellingList& GetWrongSpellings() const;
     
 private:
     void RemoveExcessiveWrongSpellings( unsigned int spellerID, DBController* db );
 
 private:
     static unsigned int MAXWRONGSPELLINGS;
+    static long long    FIRSTINTERVAL; // Interval after a wrong attempt (seconds)
+    static long long    MAXINTERVAL;   // Longest interval (seconds)
 
     unsigned int wordID_;
     unsigned int numAttempts_;
     int          level_;
+    long long    lastSeen_; // time of last check
+    long long    interval_; // time between lastSeen_ and when the word is due again
     WrongSpellingList wrongSpellings_;
 
 };
@@ -98,12 +114,18 @@ public:
     unsigned int GetWordAttempts( const int wordID ) const; // returns the number of attempts for a particular word.
     unsigned int GetNumWrongWords( const int wordID ) const;
     StringVec    GetWrongWords( const int wordID ) const;
+    WrongSpellingList GetWrongSpellings( const int wordID ) const; // Empty if no record
     int          GetWordLevel( const int wordID ) const; // returns speller's current level for particular word.
     bool         RecordExists( const int wordID ) const; // true if record exists for supplied word ID
     void         CreateRecord( const int wordID );
-    void         AddRecord( const int wordID, unsigned int attempts, int level);
+    void         AddRecord( const int wordID, unsigned int attempts, int level,
+                            long long lastSeen = 0, long long interval = 0 );
     void         IncreaseAttempts( const int wordID );
     void         SetLevel( const int wordID, const int level );
+    long long    GetWordLastSeen( const int wordID ) const; // 0 if no record
+    long long    GetWordInterval( const int wordID ) const; // 0 if no record
+    long long    GetWordDue( const int wordID ) const;      // 0 (overdue) if no record
+    void         ReviewWord( const int wordID, long long now, bool correct );
     void         AddWrongSpelling( int wordID, WrongSpelling& ws ); // used on loading.
     void         AddWrongSpelling( int wordID, WrongSpelling& ws, 
                                    DBController* db ); // tries to add a wrong spelling.
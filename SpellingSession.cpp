@@ -0,0 +1,192 @@
+// SpellingSession.cpp
+
+#include "SpellingSession.h"
+#include <algorithm>
+#include <ctime>
+#include "Word.h"
+#include "Speller.h"
+#include "DBController.h"
+
+using namespace std;
+
+SpellingSession::SpellingSession( WordBank& wordBank, Speller& speller, DBController* db, const RandomStream& random )
+: wordBank_(wordBank), speller_(speller), pDB_(db), random_(random), weightingOption_(NOWEIGHTING),
+  dueWordPending_(false), usedWords_(0), pWord_(0), wordIndex_(NOINDEX), fixedTime_(0),
+  engine_(SpellingAnalyser::PATTERNMATCHING)
+{}
+
+void SpellingSession::SetWordList( const IDList& wordIDs, WeightingOption option ){
+    weightingOption_ = option;
+    workingList_.clear(); // Clear any previous list
+    wordIndex_ = NOINDEX; // Current word (if any) is not in the new list.
+    
+    // Copy IDs into Working List.
+    for( IDList::const_iterator iter = wordIDs.begin(); iter != wordIDs.end(); ++iter ){
+        SelectionID sid;
+        sid.id_ = *iter;
+        sid.enabled_ = true;
+        workingList_.push_back(sid);
+    }
+    
+    // Weighting
+    dueWordPending_ = false;
+    if( weightingOption_ == DUEDATE ){
+        weights_.Clear();
+        dueWords_.Build( workingList_, speller_ );
+    } else {
+        dueWords_.Clear();
+        weights_.Build( workingList_, speller_, weightingOption_ == WEIGHTING );
+    }
+    
+    //Update fixed queue size
+    usedWords_.Clear(); // Stored indices refer to the old list, whose words are all enabled again.
+    if( workingList_.size() < 2 ){
+        usedWords_.ChangeSize(0);
+    } else {
+        usedWords_.ChangeSize(workingList_.size()/2);
+    }
+}
+
+bool SpellingSession::IsEmpty() const{
+    return workingList_.empty();
+}
+
+size_t SpellingSession::Size() const{
+    return workingList_.size();
+}
+
+Word* SpellingSession::NextWord(){
+    if( workingList_.empty() ) { return 0; }
+    
+    int selected = -1;
+    if( weightingOption_ == DUEDATE ){
+        // Due words are rescheduled when checked, so the recently used queue is not needed.
+        if( dueWordPending_ && wordIndex_ != NOINDEX ){ // Skipped without a check - goes back behind any words already due.
+            dueWords_.Schedule( wordIndex_, max( speller_.GetWordDue( workingList_[wordIndex_].id_ ), Now() ) );
+        }
+        selected = static_cast<int>( dueWords_.Pop() );
+        dueWordPending_ = true;
+    } else {
+        selected = GetNewWord();
+        unsigned int evicted = 0;
+        if( usedWords_.Add(selected, evicted) )
+            ReenableIndex(evicted);
+    }
+    wordIndex_ = selected;
+    pWord_ = &(wordBank_.find( workingList_[selected].id_ )->second);
+    return pWord_;
+}
+
+Word* SpellingSession::CurrentWord() const{
+    return pWord_;
+}
+
+int SpellingSession::GetNewWord(){
+    size_t index = weights_.Select( random_ ); // Disabled words have no weight, so are never drawn.
+    
+    if (workingList_.size() > 1){ // Only disable if using fixed queue (when more than one word available)
+        workingList_[index].enabled_ = false;
+        weights_.SetEnabled( index, false );
+    }
+    return static_cast<int>( index );
+}
+
+void SpellingSession::ReenableIndex(unsigned int index){
+    if( index < workingList_.size() ){
+        workingList_[index].enabled_ = true;
+        weights_.SetEnabled( index, true );
+    }
+}
+
+bool SpellingSession::Check( const std::wstring& attempt, AnalysedWord& aw ){
+    if( !pWord_ ) return false;
+    StartRecord();
+    
+    // Word analysis - also adds a wrong spelling, if appropriate, and ups the level if word correct
+    SpellingAnalyser sp( attempt, pWord_, speller_, aw, engine_ );
+    if( !( aw.IsCorrect() || aw.IsBeyondWrong() ) ){
+        WrongSpelling ws(aw);
+        if( pDB_ )
+            speller_.AddWrongSpelling( pWord_->GetID(), ws, pDB_ );
+        else
+            speller_.AddWrongSpelling( pWord_->GetID(), ws );
+    }
+    bool correct = aw.IsCorrect();
+    if( correct )
+        IncreaseLevel();
+    
+    FinishRecord( correct, true );
+    return correct;
+}
+
+void SpellingSession::Check( bool correct, bool practice ){
+    if( !pWord_ ) return;
+    StartRecord();
+    if( correct )
+        IncreaseLevel(); // CONSIDER: ignoring changes to level in either direction in practice modes.
+    FinishRecord( correct, !practice );
+}
+
+void SpellingSession::SetTime( long long now ){
+    fixedTime_ = now;
+}
+
+void SpellingSession::SetEngine( SpellingAnalyser::Engine engine ){
+    engine_ = engine;
+}
+
+void SpellingSession::StartRecord(){
+    // See if there is an existing record for this word, and create one if there isn't.
+    if( speller_.RecordExists( pWord_->GetID() ) ){
+        // If so, increase the number of attempts.
+        speller_.IncreaseAttempts( pWord_->GetID() );        
+    } else {
+        // If not, create a record and set attempts to 1.
+        speller_.CreateRecord( pWord_->GetID() );
+        // Add to database
+        if( pDB_ )
+            pDB_->AddSpellerRecord( speller_.GetID(), pWord_->GetID(), 1, 0);
+    }
+}
+
+void SpellingSession::FinishRecord( bool correct, bool review ){
+    // Spaced repetition schedule is kept whatever the weighting option, so it is ready if DUEDATE is chosen later.
+    if( review )
+        speller_.ReviewWord( pWord_->GetID(), Now(), correct );
+    
+    // Update attempts, level and schedule in DB
+    if( pDB_ )
+        pDB_->UpdateSpellerRecord( speller_, pWord_->GetID() ); 
+    if( wordIndex_ == NOINDEX )
+        return; // Working list changed since this word was chosen.
+    if( weightingOption_ == DUEDATE ){
+        long long due = speller_.GetWordDue( pWord_->GetID() );
+        if( !review ) // Still due - goes back behind any words already due, as a skipped word does.
+            due = max( due, Now() );
+        dueWords_.Schedule( wordIndex_, due );
+        dueWordPending_ = false;
+    } else {
+        weights_.Refresh( wordIndex_, speller_ ); // Attempts and level feed the weighting.
+    }
+}
+
+void SpellingSession::IncreaseLevel(){
+    int level = speller_.GetWordLevel( pWord_->GetID() );
+    if( level == 0 ) return; // no change if not got a level yet.
+    
+    if( level < TOP_LEVEL_RANK_1 ){
+        level = TOP_LEVEL_RANK_1;
+    } else if( level < TOP_LEVEL_RANK_2 ){
+        level = TOP_LEVEL_RANK_2;
+    } else if ( level < TOP_LEVEL_RANK_3 ){
+        level = TOP_LEVEL_RANK_3;
+    }
+    if( level != speller_.GetWordLevel( pWord_->GetID() ) )
+        speller_.SetLevel( pWord_->GetID(), level );
+}
+
+long long SpellingSession::Now() const{
+    if( fixedTime_ )
+        return fixedTime_;
+    return static_cast<long long>( time(0) );
+}
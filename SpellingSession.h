@@ -0,0 +1,76 @@
+// SpellingSession.h
+// The game state behind the MiniSpell activities: choosing words and recording attempts.
+// Kept apart from buttons, keyboards and drawing, so it can be driven without a window (see Simulator).
+
+#ifndef SPELLINGSESSION_H
+#define SPELLINGSESSION_H
+
+#include <string>
+#include <cstddef>
+#include "Definitions.h"
+#include "Utility.h"
+#include "Random.h"
+#include "WeightingModel.h"
+#include "DueQueue.h"
+#include "Word.h"
+
+class Speller;
+class DBController;
+
+class SpellingSession{
+public:
+    // DUEDATE - spaced repetition, most overdue word first.  MiniSpell has no button for choosing weighting
+    // yet, so only the Simulator uses WEIGHTING and DUEDATE.
+    enum WeightingOption { NOWEIGHTING, WEIGHTING, DUEDATE };
+    
+    // db may be 0, in which case nothing is written to the database.
+    SpellingSession( WordBank& wordBank, Speller& speller, DBController* db, const RandomStream& random );
+    
+    // Replaces the working list.  wordIDs must all be in the word bank.
+    // The current word can still be checked, but is no longer part of the selection.
+    void SetWordList( const IDList& wordIDs, WeightingOption option );
+    bool IsEmpty() const;
+    std::size_t Size() const;
+    
+    Word* NextWord();            // Chooses the next word.  Returns 0 if the list is empty.
+    Word* CurrentWord() const;
+    
+    // Recording an attempt at the current word updates attempts, level, wrong spellings,
+    // the spaced repetition schedule, the selection weights and the database.
+    bool Check( const std::wstring& attempt, AnalysedWord& aw ); // QuickSpell - analyses attempt into aw.  Returns true if correct.
+    // No analysis needed.  A correct check increases the level.  A practice check (Word Workout, where the
+    // word is copied until it is right) counts as an attempt, but isn't a verdict, so the schedule is left alone.
+    void Check( bool correct, bool practice = false );
+    
+    void SetTime( long long now ); // Fixes the time used for scheduling, in seconds.  0 uses the system clock.
+    void SetEngine( SpellingAnalyser::Engine engine ); // Analyser used by the QuickSpell check.
+    
+private:
+    int  GetNewWord(); // Draws an enabled word, disables it, and returns its index into workingList_.
+    void ReenableIndex( unsigned int index );
+    void StartRecord();              // Creates or adds to the record for the current word.
+    void FinishRecord( bool correct, bool review ); // Reschedules (if review) and saves the record for the current word.
+    void IncreaseLevel(); // If word spelt/chosen correctly, adjust level to top level of the current rank.
+    long long Now() const;
+
+private:
+    WordBank& wordBank_;
+    Speller&  speller_;
+    DBController* pDB_;
+    RandomStream random_;
+    
+    WeightingOption weightingOption_;
+    WorkingList workingList_; // Active list used to select words.
+    WeightingModel weights_;  // Selection weights for workingList_, kept up to date after each attempt.
+    DueQueue dueWords_;       // Used instead of weights_ for DUEDATE.
+    bool dueWordPending_;     // True while the current word is out of dueWords_ awaiting a check.
+    FixedQueue usedWords_;    // Indices into workingList_ of recently used words.
+    
+    Word* pWord_;
+    std::size_t wordIndex_;   // Index of pWord_ in workingList_, or NOINDEX if the list changed since it was chosen.
+    static const std::size_t NOINDEX = static_cast<std::size_t>(-1);
+    long long fixedTime_;
+    SpellingAnalyser::Engine engine_;
+};
+
+#endif // SPELLINGSESSION_H
@@ -6,13 +6,14 @@
 #include "Utility.h"
 #include "Speller.h"
 #include "ScreenPrinter.h"
+#include "TextLayout.h"
 
 using namespace std;
 using namespace Gdiplus;
 
 // SSWord
 SSWord::SSWord(std::wstring text, bool correct)
-    : text_(text), correct_(correct), selected_(false)
+    : text_(text), correct_(correct), selected_(false), width_(0.0f)
 {}
 
 
@@ -31,111 +32,131 @@ bool SSRow::AddWord(SSWord *word){
     return true;
 }
 
-void SSRow::RandomiseWordOrder() {
+void SSRow::RandomiseWordOrder( RandomStream& random ) {
     if( words_.size() < 2 )
         return;
-    random_shuffle(words_.begin(), words_.end() );
+    random.Shuffle(words_.begin(), words_.end() );
 }
 
 bool SSRow::IsEmpty() const{
     return words_.empty();
 }
 
+// SSFontSizes
+const float SSFontSizes::SCALES[] = { 1.0f, 0.85f, 0.7f, 0.55f };
+
+SSFontSizes::SSFontSizes(BackBuffer* bb, TextLayout& layout, Gdiplus::Font* font)
+    : bb_(bb), layout_(layout), fonts_(sizeof(SCALES) / sizeof(SCALES[0]), static_cast<Font*>(0))
+{
+    fonts_[0] = font;
+}
+
+SSFontSizes::~SSFontSizes(){
+    for( size_t i = 1; i < fonts_.size(); ++i )
+        delete fonts_[i];
+}
+
+unsigned int SSFontSizes::Sizes(){
+    return static_cast<unsigned int>( fonts_.size() );
+}
+
+float SSFontSizes::Width(unsigned int size, const std::wstring& word){
+    return layout_.Advances( *GetFont( size ), word, advances_ );
+}
+
+float SSFontSizes::Height(unsigned int size){
+    Graphics graphics( bb_->getDC() );
+    return GetFont( size )->GetHeight( &graphics );
+}
+
+Gdiplus::Font* SSFontSizes::Release(unsigned int size){
+    if( size == 0 || size >= fonts_.size() )
+        return 0;
+    Font* font = GetFont( size );
+    fonts_[size] = 0;
+    return font;
+}
+
+Gdiplus::Font* SSFontSizes::GetFont(unsigned int size){
+    if( !fonts_[size] ){
+        FontFamily family;
+        fonts_[0]->GetFamily( &family );
+        fonts_[size] = new Font( &family, fonts_[0]->GetSize() * SCALES[size], fonts_[0]->GetStyle(), fonts_[0]->GetUnit() );
+    }
+    return fonts_[size];
+}
+
 // SSRegion
 SSRegion::SSRegion(std::wstring correctSpelling, StringVec wrongSpellings,
-                   Gdiplus::PointF pos, BackBuffer *bb, Font* font, Speller& speller)
+                   Gdiplus::PointF pos, BackBuffer *bb, Font* font, ScreenPrinter* sp, Speller& speller,
+                   RandomStream& random)
     : position_(pos), bb_(bb),
         height_(500.0f), width_(1000.0f), hPad_(10.0f), vPad_(10.0f), hMargin_(20.0f), vMargin_(30.0f), // these should become constants
         highlightWidth_(5.0f), highlightColour_(Color(255,255,0)),
-        maxRows_(0), selected_(false), timer_(0.0), pFont_(font), FADESPEED(1.0)
+        maxRows_(0), selected_(false), timer_(0.0), pFont_(font), ownFont_(0), pScreenPrinter_(sp), FADESPEED(1.0)
 {
     paper_      = speller.GetColour( Speller::PAPER );
     correct_    = speller.GetColour( Speller::CORRECT );
     wrong_      = speller.GetColour( Speller::WRONG );
     pen_ = correctFade_ = wrongFade_ = speller.GetColour( Speller::PEN );
     
-    SetUp(correctSpelling, wrongSpellings, speller);
+    SetUp(correctSpelling, wrongSpellings, speller, random);
 }
 
 SSRegion::~SSRegion(){
-    wordList_.erase( remove_if( wordList_.begin(), wordList_.end(), deleteAll<SSWord>),
-                     wordList_.end() );
+    delete ownFont_; // The words go with wordPool_
 }
 
-void SSRegion::SetUp(std::wstring& correctSpelling, StringVec& wrongSpellings, Speller& speller){
+void SSRegion::SetUp(std::wstring& correctSpelling, StringVec& wrongSpellings, Speller& speller, RandomStream& random){
     
-    // Add correct word to beginning of vector
-    wordList_.push_back( new SSWord(correctSpelling, true) );
-    SSRegion::HeightAndWidth dim = MeasureWord( correctSpelling );
-    wordList_[0]->width_ = dim.second;
-    float maxHeight = dim.first; // Store height for comparison (TODO: Might not be needed - just a single measurement.)
-    
-    // Shuffle up the wrong spellings
-    random_shuffle(wrongSpellings.begin(), wrongSpellings.end() );
+    // Pack the words into rows, dropping to a smaller font if they won't all fit.
+    SSFontSizes sizes( bb_, pScreenPrinter_->Layout(), pFont_ );
+    SSPacker packer( sizes, width_, height_, 2.0f*(hPad_ + hMargin_), 2.0f*(vPad_ + vMargin_) );
+    SSPacking packing;
+    packer.Pack( correctSpelling, wrongSpellings, random, packing );
+    if( packing.size_ > 0 ){
+        ownFont_ = sizes.Release( packing.size_ );
+        pFont_ = ownFont_;
+    }
     
-    // TODO: Is the measured height going to be the same for all strings?
-    // Add the wrong spellings to the vector
+    // Correct word at the beginning of the vector, then the wrong spellings - the packer's numbering.
+    wordList_.push_back( wordPool_.Make( SSWord(correctSpelling, true) ) );
     for( StringVec::iterator iter = wrongSpellings.begin();
          iter != wrongSpellings.end();
          ++iter ){
-        SSWord* word = new SSWord( *iter );
-        SSRegion::HeightAndWidth dim = MeasureWord( *iter );
-        word->width_ = dim.second;
-        maxHeight = (dim.first > maxHeight) ? dim.first : maxHeight;
-        wordList_.push_back( word );
+        wordList_.push_back( wordPool_.Make( SSWord( *iter ) ) );
     }
-    maxRows_ = static_cast<unsigned int> (height_ / maxHeight);
-    rowHeight_ = height_ / static_cast<float>( maxRows_ );
-    // Make the rows
-    rows_.resize(maxRows_, SSRow(width_));
+    for( size_t i = 0; i < wordList_.size(); ++i )
+        wordList_[i]->width_ = packing.widths_[i];
     
-    // Populate the rows
-    // Correct word first
-    int index = GetRandomRowIndex();
-    rows_[index].AddWord( wordList_[0] ); // TODO: word should fit - what if it doesn't?
+    // The rows share out the region's height
+    maxRows_ = max( 1u, static_cast<unsigned int> (height_ / packing.rowHeight_) );
+    rowHeight_ = height_ / static_cast<float>( maxRows_ );
     
-    // TEST: For now, fit every wrong word possible. Potential for infinite loop.
-    for(SSWordList::iterator iter = wordList_.begin()+1;
-        iter != wordList_.end();
-        ++iter ){
-            do{
-                index = GetRandomRowIndex();
-            } while( !(rows_[index].AddWord( *iter ) ) );
+    // Make the rows.  Wrong spellings that didn't fit at all are left out.
+    for( vector<SSPackedRow>::const_iterator packed = packing.rows_.begin(); packed != packing.rows_.end(); ++packed ){
+        rows_.push_back( SSRow(width_) );
+        SSRow& row = rows_.back();
+        for( SSPackedRow::const_iterator index = packed->begin(); index != packed->end(); ++index ){
+            if( !row.AddWord( wordList_[*index] ) ){
+                // Only a correct spelling too wide for the region - alone in its row, overhanging both sides.
+                row.words_.push_back( wordList_[*index] );
+                row.horizontalOffset_ = 0.5f * ( width_ - wordList_[*index]->width_ );
+            }
+        }
     }
     
-    // Delete any empty rows.
-    rows_.erase(remove_if( rows_.begin(), rows_.end(), mem_fun_ref( &SSRow::IsEmpty ) ),rows_.end() );
-    
-    // TODO: Sort out sparse rows here.
-    
     // Calculate vertical offset
     verticalOffset_ = 0.5f * ( height_ - (rows_.size() * rowHeight_ ) );
     
     // Randomise words in each row
-    for_each(rows_.begin(), rows_.end(), mem_fun_ref( &SSRow::RandomiseWordOrder ) );
+    for( SSRowList::iterator iter = rows_.begin(); iter != rows_.end(); ++iter )
+        iter->RandomiseWordOrder( random );
     
 }
 
-SSRegion::HeightAndWidth SSRegion::MeasureWord( std::wstring& word ){
-    HDC hdc = bb_->getDC();
-    Gdiplus::Graphics graphics(hdc);
-    PointF p;
-    //Need the following StringFormat for accurate measurement.
-    StringFormat* sf = (StringFormat::GenericTypographic())->Clone();
-    sf->SetFormatFlags( StringFormatFlags::StringFormatFlagsMeasureTrailingSpaces );
-    Gdiplus::RectF rec;
-    graphics.MeasureString(word.c_str(), -1, pFont_, p, sf, &rec);
-    HeightAndWidth dim(rec.Height + 2.0f*vPad_ + 2.0*vMargin_ , rec.Width + 2.0f*hPad_ + 2.0f*hMargin_ );
-    return dim;
-}
-
-int SSRegion::GetRandomRowIndex(){
-    return Random(0, static_cast<int>( rows_.size() - 1 ) );
-}
-
 void SSRegion::Display(){
     Graphics graphics(bb_->getDC());
-    ScreenPrinter* sp = new ScreenPrinter( bb_ );
     
     PointF storePos = position_;
     // Adjust for offsets.
@@ -171,11 +192,7 @@ void SSRegion::Display(){
             // Adjust for padding, BUT REPLACE screen offsets - ScreenPrinter takes them off again.
             wordPos.X += hPad_ - bb_->mOffX;
             wordPos.Y += vPad_ - bb_->mOffY;
-            for( wstring::iterator letter = rows_[row].words_[word]->text_.begin();
-                 letter != pWord->text_.end();
-                 ++letter ){
-                wordPos = sp->PrintLetter( *letter, wordPos, *pFont_, colour );
-            } //End Letter For
+            pScreenPrinter_->PrintLetters( pWord->text_, wordPos, *pFont_, colour );
             
             // Update position for next word.
             pos.X += pWord->width_ - hMargin_;
@@ -184,23 +201,32 @@ void SSRegion::Display(){
         pos.Y += rowHeight_;
         pos.X = storePos.X;
     } //End Row For
-    delete sp; // delete screenprinter object
     
     
 }
 
-void SSRegion::Update(double dt, const Gdiplus::PointF *cursorPos){
+bool SSRegion::Update(double dt, const Gdiplus::PointF *cursorPos){
     int g = 0;
     if( selected_ ) {
+        bool fading = Fading(); // Checked first, so the final colours are drawn too
         timer_ += dt;
         double ratio = timer_ / FADESPEED;
         correctFade_ = GetFadeColour( pen_, correct_, ratio );
         wrongFade_   = GetFadeColour( pen_, wrong_, ratio );
-        return;
+        return fading;
     }
     
+    pair<int, int> highlight = highlightWord_;
     IsInWord( cursorPos );
+    return highlightWord_ != highlight;
+}
+
+Gdiplus::RectF SSRegion::Bounds() const{
+    return RectF( position_.X, position_.Y, width_, height_ );
+}
 
+bool SSRegion::Fading() const{
+    return selected_ && timer_ < FADESPEED;
 }
 
 bool SSRegion::IsInWord( const Gdiplus::PointF* cursorPos ){
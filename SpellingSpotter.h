@@ -15,9 +15,14 @@
 #include <string>
 #include <vector>
 #include "Definitions.h"
+#include "SSPacker.h"
+#include "ObjectPool.h"
 
 class BackBuffer;
+class ScreenPrinter;
+class TextLayout;
 class Speller;
+class RandomStream;
 
 struct SSWord{
     SSWord(std::wstring text, bool correct = false);       
@@ -35,7 +40,7 @@ struct SSRow{
     SSRow(float width);
     
     bool AddWord( SSWord* word ); // Store a pointer to word.  Returns false if the word won't fit.
-    void RandomiseWordOrder(); // mix up the order the words are stored.
+    void RandomiseWordOrder( RandomStream& random ); // mix up the order the words are stored.
     bool IsEmpty() const;
     
     SSWordList words_; // list of SSWords
@@ -46,27 +51,57 @@ struct SSRow{
 
 typedef std::vector<SSRow> SSRowList;
 
+// Measures words for the SSPacker at the region's font and a few smaller sizes, through a ScreenPrinter's
+// TextLayout so the widths match what PrintLetters draws.
+class SSFontSizes : public WordMeasure{
+public:
+    SSFontSizes(BackBuffer* bb, TextLayout& layout, Gdiplus::Font* font);
+    ~SSFontSizes();
+
+    unsigned int Sizes();
+    float Width(unsigned int size, const std::wstring& word);
+    float Height(unsigned int size);
+
+    // Hands over the font for size, to be deleted by the caller.  Size 0 is the font given, never handed over.
+    Gdiplus::Font* Release(unsigned int size);
+
+private:
+    SSFontSizes(const SSFontSizes&);
+    SSFontSizes& operator=(const SSFontSizes&);
+
+    Gdiplus::Font* GetFont(unsigned int size);
+
+    static const float SCALES[]; // Of the font given
+
+    BackBuffer* bb_;
+    TextLayout& layout_;
+    std::vector<Gdiplus::Font*> fonts_; // Made as needed.  fonts_[0] belongs to the caller.
+    std::vector<float> advances_;
+};
+
 class SSRegion{
 public:
     SSRegion(std::wstring correctSpelling, StringVec wrongSpellings,
-             Gdiplus::PointF pos, BackBuffer* bb, Gdiplus::Font* font, Speller& speller);
+             Gdiplus::PointF pos, BackBuffer* bb, Gdiplus::Font* font, ScreenPrinter* sp, Speller& speller,
+             RandomStream& random);
              
     ~SSRegion();
     
-    void SetUp(std::wstring& correctSpelling, StringVec& wrongSpellings, Speller& speller);
+    void SetUp(std::wstring& correctSpelling, StringVec& wrongSpellings, Speller& speller, RandomStream& random);
     
     void Display(); // display each row.
-    void Update( double dt, const Gdiplus::PointF *cursorPos ); // borders while nothing selected; colour changes when selected
+    bool Fading() const; // True while the chosen words fade to their colours
+    // borders while nothing selected; colour changes when selected.  Returns true if either changed.
+    bool Update( double dt, const Gdiplus::PointF *cursorPos );
+    Gdiplus::RectF Bounds() const; // The whole region
     
     bool Click( const Gdiplus::PointF* cursorPos ); // Check which word, if any, has been clicked
     
 
     
 private:
-    typedef std::pair<float,float> HeightAndWidth;
-    HeightAndWidth MeasureWord(std::wstring& word); // Measure the height and width of a word
-    
-    int GetRandomRowIndex(); // Select an SSRow index at random
+    SSRegion(const SSRegion&);
+    SSRegion& operator=(const SSRegion&);
     
     bool IsInWord(const Gdiplus::PointF* cursorPos);
     void DrawHighlight( Gdiplus::Graphics& graphics, const Gdiplus::PointF& position );
@@ -84,6 +119,7 @@ private:
     
     SSRowList rows_; 
     SSWordList wordList_;
+    ObjectPool<SSWord> wordPool_; // Where wordList_'s words are made
     std::pair<int,int> highlightWord_; // Stores which row and which word (within that row) is highlighted.
     
     unsigned int maxRows_; // calculated based on word with greatest measured height
@@ -91,6 +127,8 @@ private:
     bool selected_; // whether a word has been chosen or not.
     BackBuffer* bb_;
     Gdiplus::Font* pFont_;
+    Gdiplus::Font* ownFont_; // A smaller font, when the words didn't fit at the mode's.  0 otherwise.
+    ScreenPrinter* pScreenPrinter_; // Shared with the mode, so its letter widths stay cached between frames
     double timer_;
     Gdiplus::Color paper_, pen_, correct_, wrong_;
     Gdiplus::Color correctFade_, wrongFade_;
@@ -0,0 +1,117 @@
+// SubstringIndex.cpp
+
+#include "SubstringIndex.h"
+#include <algorithm>
+#include "Word.h"
+#include "Utility.h"
+
+using namespace std;
+
+namespace {
+    const wchar_t STARTMARK = L'\x02'; // Never appears in a spelling
+    const wchar_t ENDMARK   = L'\x03';
+
+    bool TrigramLess( const pair<unsigned long long, unsigned int>& lhs, const pair<unsigned long long, unsigned int>& rhs ){
+        return lhs.first < rhs.first;
+    }
+}
+
+SubstringIndex::SubstringIndex()
+{}
+
+void SubstringIndex::Build( const WordBank& wordBank ){
+    Clear();
+    for( WordBank::const_iterator iter = wordBank.begin(); iter != wordBank.end(); ++iter ){
+        const SpellingList& spellings = iter->second.GetSpellings();
+        for( SpellingList::const_iterator spelling = spellings.begin(); spelling != spellings.end(); ++spelling ){
+            unsigned int index = static_cast<unsigned int>( keys_.size() );
+            keys_.push_back( MakeKey( spelling->GetSpelling(), WHOLE ) );
+            wordIDs_.push_back( iter->first );
+            const wstring& key = keys_.back();
+            for( size_t i = 0; i + 3 <= key.length(); ++i ){
+                postings_.push_back( Posting( MakeTrigram( key, i ), index ) );
+            }
+        }
+    }
+    sort( postings_.begin(), postings_.end() );
+    // A trigram repeated within one spelling only needs filing once.
+    postings_.erase( unique( postings_.begin(), postings_.end() ), postings_.end() );
+}
+
+void SubstringIndex::Clear(){
+    keys_.clear();
+    wordIDs_.clear();
+    postings_.clear();
+}
+
+size_t SubstringIndex::Size() const {
+    return keys_.size();
+}
+
+void SubstringIndex::Find( const wstring& pattern, Anchor anchor, IDList& wordIDs ) const {
+    wordIDs.clear();
+    wstring key = MakeKey( pattern, anchor );
+
+    if( key.length() < 3 ){ // Too short to have a trigram, so check every spelling
+        for( size_t i = 0; i < keys_.size(); ++i ){
+            if( keys_[i].find( key ) != wstring::npos )
+                wordIDs.insert( wordIDs_[i] );
+        }
+        return;
+    }
+
+    // Only spellings holding the pattern's rarest trigram can match.
+    pair<PostingList::const_iterator, PostingList::const_iterator> rarest = Postings( MakeTrigram( key, 0 ) );
+    for( size_t i = 1; i + 3 <= key.length() && rarest.first != rarest.second; ++i ){
+        pair<PostingList::const_iterator, PostingList::const_iterator> postings = Postings( MakeTrigram( key, i ) );
+        if( postings.second - postings.first < rarest.second - rarest.first )
+            rarest = postings;
+    }
+    for( PostingList::const_iterator iter = rarest.first; iter != rarest.second; ++iter ){
+        if( keys_[iter->second].find( key ) != wstring::npos )
+            wordIDs.insert( wordIDs_[iter->second] );
+    }
+}
+
+bool SubstringIndex::Find( const wstring& query, IDList& wordIDs ) const {
+    wordIDs.clear();
+    wstring pattern = trim( query );
+    bool start = false;
+    bool end = false;
+    if( !pattern.empty() && pattern[0] == L'-' ){
+        end = true;
+        pattern.erase( 0, 1 );
+    }
+    if( !pattern.empty() && pattern[pattern.length() - 1] == L'-' ){
+        start = true;
+        pattern.erase( pattern.length() - 1 );
+    }
+    if( pattern.empty() )
+        return false;
+
+    Anchor anchor = ANYWHERE; // Also for "-ough-", somewhere in the middle
+    if( start && !end )
+        anchor = START;
+    else if( end && !start )
+        anchor = END;
+    Find( pattern, anchor, wordIDs );
+    return true;
+}
+
+wstring SubstringIndex::MakeKey( const wstring& s, Anchor anchor ){
+    wstring key = ToLower( s, true );
+    if( anchor == START || anchor == WHOLE )
+        key.insert( key.begin(), STARTMARK );
+    if( anchor == END || anchor == WHOLE )
+        key += ENDMARK;
+    return key;
+}
+
+SubstringIndex::Trigram SubstringIndex::MakeTrigram( const wstring& s, size_t pos ){
+    return ( Trigram( s[pos] & 0xFFFF ) << 32 ) | ( Trigram( s[pos + 1] & 0xFFFF ) << 16 ) | Trigram( s[pos + 2] & 0xFFFF );
+}
+
+pair<SubstringIndex::PostingList::const_iterator, SubstringIndex::PostingList::const_iterator>
+SubstringIndex::Postings( Trigram trigram ) const {
+    return equal_range( postings_.begin(), postings_.end(), Posting( trigram, 0 ), TrigramLess );
+}
@@ -0,0 +1,48 @@
+// SubstringIndex.h
+// Finds the words whose spellings contain, start with or end with a few letters, for filtering
+// word lists ("all words containing 'ough'", "all words ending in -tion").
+// A trigram index: each spelling is filed under every run of three letters in it, with markers for its
+// start and end, so only spellings sharing the pattern's rarest trigram need checking.
+// Matching ignores caps and diacritics.
+
+#ifndef SUBSTRINGINDEX_H
+#define SUBSTRINGINDEX_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "Definitions.h"
+
+class SubstringIndex{
+public:
+    enum Anchor{ ANYWHERE, START, END, WHOLE };
+
+    SubstringIndex();
+
+    void Build( const WordBank& wordBank ); // Replaces the index with every spelling in wordBank.
+    void Clear();
+    std::size_t Size() const;               // Number of spellings indexed
+
+    // Fills wordIDs with every word having a spelling that matches pattern at anchor.
+    void Find( const std::wstring& pattern, Anchor anchor, IDList& wordIDs ) const;
+    // As above, but a leading or trailing '-' gives the anchor: "-tion" ends in tion, "pre-" starts with pre.
+    // Returns false, leaving wordIDs empty, if query has no letters to search for.
+    bool Find( const std::wstring& query, IDList& wordIDs ) const;
+
+private:
+    typedef unsigned long long Trigram;
+    typedef std::pair<Trigram, unsigned int> Posting; // Trigram, and index into keys_
+    typedef std::vector<Posting> PostingList;
+
+    static std::wstring MakeKey( const std::wstring& s, Anchor anchor ); // Caps and diacritics removed, with markers
+    static Trigram MakeTrigram( const std::wstring& s, std::size_t pos );
+    std::pair<PostingList::const_iterator, PostingList::const_iterator> Postings( Trigram trigram ) const;
+
+private:
+    std::vector<std::wstring> keys_;     // Every spelling, as made by MakeKey( spelling, WHOLE )
+    std::vector<unsigned int> wordIDs_;  // Word ID for each of keys_
+    PostingList postings_;               // Sorted
+};
+
+#endif // SUBSTRINGINDEX_H
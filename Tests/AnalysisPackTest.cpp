@@ -0,0 +1,201 @@
+// AnalysisPackTest.cpp
+// PackAnalysis and UnpackAnalysis: round trips of narrow and wide letters with every status, packings that
+// are not analyses turned away, and a wrong spelling stored before analyses were kept (a NULL Analysis
+// column) loading through DBController with none.
+
+#include <cstdio>
+#include "Check.h"
+#include "DBController.h"
+#include "Random.h"
+#include "Speller.h"
+#include "Word.h"
+#include "sqlite3.h"
+
+using namespace std;
+
+namespace{
+    bool Same( const AnalysedLetters& a, const AnalysedLetters& b ){
+        if( a.size() != b.size() )
+            return false;
+        for( size_t i = 0; i < a.size(); ++i ){
+            if( a[i].letter_ != b[i].letter_ || a[i].status_ != b[i].status_ )
+                return false;
+        }
+        return true;
+    }
+
+    // Packs letters, checks the format byte and size, and that it unpacks to the same.
+    bool RoundTrips( const AnalysedLetters& letters, bool wide ){
+        PackedAnalysis packed;
+        PackAnalysis( letters, packed );
+        size_t n = letters.size();
+        size_t countBytes = n < 0x80 ? 1 : 2;
+        if( !CHECK( packed.size() == 1 + countBytes + ( n + 1 ) / 2 + ( wide ? 2 * n : n ) ) )
+            return false;
+        if( !CHECK( packed[0] == ( wide ? 2 : 1 ) ) )
+            return false;
+        AnalysedLetters unpacked;
+        unpacked.push_back( AnalysedLetter( L'x', Wrong ) ); // Replaced, not added to
+        return CHECK( UnpackAnalysis( &packed[0], packed.size(), unpacked ) ) && CHECK( Same( letters, unpacked ) );
+    }
+
+    void Narrow(){
+        AnalysedLetters letters;
+        CHECK( RoundTrips( letters, false ) ); // Empty
+
+        const wchar_t word[] = L"elephant\xE9\xFF"; // Latin-1 still packs a byte a letter
+        for( int i = 0; word[i]; ++i )
+            letters.push_back( AnalysedLetter( word[i], static_cast<LetterStatus>( i % ( ThreeAwayWrongB + 1 ) ) ) );
+        CHECK( RoundTrips( letters, false ) );
+
+        // Every status, in both halves of a byte.
+        for( int first = Null; first <= ThreeAwayWrongB; ++first ){
+            for( int second = Null; second <= ThreeAwayWrongB; ++second ){
+                letters.clear();
+                letters.push_back( AnalysedLetter( L'a', static_cast<LetterStatus>( first ) ) );
+                letters.push_back( AnalysedLetter( L'b', static_cast<LetterStatus>( second ) ) );
+                letters.push_back( AnalysedLetter( L'c', static_cast<LetterStatus>( first ) ) ); // Odd count
+                if( !RoundTrips( letters, false ) )
+                    return;
+            }
+        }
+    }
+
+    void Wide(){
+        AnalysedLetters letters;
+        letters.push_back( AnalysedLetter( L'a', Correct ) );
+        letters.push_back( AnalysedLetter( L'\x0142', Missing ) ); // One letter past Latin-1 makes them all two bytes
+        letters.push_back( AnalysedLetter( L'\x0100', Swapped ) );
+        letters.push_back( AnalysedLetter( L'\xFFFF', ThreeAwayWrongB ) );
+        CHECK( RoundTrips( letters, true ) );
+
+        letters.clear();
+        letters.push_back( AnalysedLetter( L'\x3042', Null ) );
+        CHECK( RoundTrips( letters, true ) );
+    }
+
+    // Analyses of every length an analysis can hold, from a fixed seed.
+    void RandomAnalyses(){
+        RandomStream random( 40 );
+        AnalysedLetters letters;
+        for( int trial = 0; trial < 20000; ++trial ){
+            letters.clear();
+            bool wide = random.Random( 0, 3 ) == 0;
+            int n = random.Random( 0, ANALYSED_LETTERS_LIMIT );
+            for( int i = 0; i < n; ++i ){
+                wchar_t c = static_cast<wchar_t>( random.Random( 1, wide ? 0xFFFF : 0xFF ) );
+                letters.push_back( AnalysedLetter( c, static_cast<LetterStatus>( random.Random( Null, ThreeAwayWrongB ) ) ) );
+            }
+            bool anyWide = false;
+            for( AWConstIter iter = letters.begin(); iter != letters.end(); ++iter )
+                anyWide = anyWide || iter->letter_ > 0xFF;
+            if( !RoundTrips( letters, anyWide ) )
+                return;
+        }
+    }
+
+    bool Rejected( const PackedAnalysis& packed, size_t size ){
+        AnalysedLetters letters;
+        letters.push_back( AnalysedLetter( L'x', Wrong ) );
+        bool unpacked = UnpackAnalysis( packed.empty() ? 0 : &packed[0], size, letters );
+        return !unpacked && letters.empty();
+    }
+
+    void NotAnalyses(){
+        AnalysedLetters letters;
+        const wchar_t word[] = L"swapped";
+        for( int i = 0; word[i]; ++i )
+            letters.push_back( AnalysedLetter( word[i], i % 2 ? Swapped : Correct ) );
+        PackedAnalysis packed;
+        PackAnalysis( letters, packed );
+
+        PackedAnalysis none;
+        CHECK( Rejected( none, 0 ) );
+
+        // Bad format bytes
+        for( int format = 0; format < 256; ++format ){
+            if( format == 1 || format == 2 )
+                continue;
+            PackedAnalysis bad( packed );
+            bad[0] = static_cast<unsigned char>( format );
+            if( !CHECK( Rejected( bad, bad.size() ) ) )
+                break;
+        }
+
+        // Truncated anywhere, or a byte too long
+        for( size_t size = 0; size < packed.size(); ++size ){
+            if( !CHECK( Rejected( packed, size ) ) )
+                break;
+        }
+        PackedAnalysis longer( packed );
+        longer.push_back( 'x' );
+        CHECK( Rejected( longer, longer.size() ) );
+
+        // A count that never ends, and a status past the last
+        PackedAnalysis endless( 8, 0xFF );
+        endless[0] = 1;
+        CHECK( Rejected( endless, endless.size() ) );
+        PackedAnalysis status( packed );
+        status[2] = 0x0F;
+        CHECK( Rejected( status, status.size() ) );
+    }
+
+    // A database as older versions left it, without the Analysis column.
+    bool MakeOldDatabase( const char* location ){
+        remove( location );
+        sqlite3* db = 0;
+        if( sqlite3_open_v2( location, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, 0 ) != SQLITE_OK ){
+            sqlite3_close( db );
+            return false;
+        }
+        const char* sql =
+            "CREATE TABLE SpellerRecords (SpellerID NUMERIC, WordID NUMERIC, Attempts NUMERIC, Level NUMERIC);"
+            "CREATE TABLE WrongSpellings (LengthDifference NUMERIC, LongestLink NUMERIC, AverageLinkLength NUMERIC,"
+            " WordID NUMERIC, SpellerID NUMERIC, Spelling TEXT, Score NUMERIC);"
+            "INSERT INTO WrongSpellings VALUES (1, 3, 1.5, 7, 1, 'elefant', 40);";
+        bool made = sqlite3_exec( db, sql, 0, 0, 0 ) == SQLITE_OK;
+        sqlite3_close( db );
+        return made;
+    }
+
+    void NullColumn(){
+        const char* location = "analysis_pack_test.db";
+        if( !CHECK( MakeOldDatabase( location ) ) )
+            return;
+        {
+            DBController db( location ); // Adds the column, NULL in the old row
+            AnalysedWord aw( 8 );
+            const wchar_t attempt[] = L"elephent";
+            for( int i = 0; attempt[i]; ++i )
+                aw.Add( attempt[i], i == 5 ? Wrong : Correct );
+            aw.CalculateStats();
+            WrongSpelling stored( aw );
+            db.AddWrongSpelling( 1, 7, stored );
+
+            Speller speller( 1, L"Test", Range( 1, 9 ), L"", IDList(), IDList() );
+            speller.AddRecord( 7, 2, 4 );
+            db.GetWrongSpellings( speller );
+            WrongSpellingList loaded = speller.GetWrongSpellings( 7 );
+            if( CHECK( loaded.size() == 2 ) ){
+                AnalysedLetters letters;
+                letters.push_back( AnalysedLetter( L'x', Wrong ) );
+                const WrongSpelling& old = loaded[0].spelling_ == L"elefant" ? loaded[0] : loaded[1];
+                const WrongSpelling& added = loaded[0].spelling_ == L"elefant" ? loaded[1] : loaded[0];
+                CHECK( old.score_ == 40 && old.analysis_.empty() );
+                CHECK( !old.GetAnalysis( letters ) && letters.empty() );
+                CHECK( added.spelling_ == L"elephent" && added.analysis_ == stored.analysis_ );
+                CHECK( added.GetAnalysis( letters ) && Same( letters, aw.GetAnalysis() ) );
+            }
+        }
+        remove( location );
+    }
+}
+
+int main(){
+    Narrow();
+    Wide();
+    RandomAnalyses();
+    NotAnalyses();
+    NullColumn();
+    return CheckResult();
+}
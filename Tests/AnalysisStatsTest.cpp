@@ -0,0 +1,89 @@
+// AnalysisStatsTest.cpp
+// AnalysedWord::CalculateStats works everything out in one pass (Tally).  Checks it against the separate
+// passes it replaced (StatsReference) over made-up analyses, from a fixed seed so a failure repeats.
+
+#include <cmath>
+#include "Check.h"
+#include "StatsReference.h"
+#include "Random.h"
+#include "Word.h"
+
+using namespace std;
+
+namespace{
+    // Checks every statistic of aw against the reference.  calculated says whether CalculateStats has been called.
+    bool Matches( const AnalysedWord& aw, unsigned int originalLength, bool calculated ){
+        const AnalysedLetters& letters = aw.GetAnalysis();
+        bool matches = true;
+        if( calculated ){
+            const AnalysisStats& stats = aw.Stats();
+            unsigned int attemptLength, lengthDifference, numLinks, largestLink;
+            double averageLinkSize;
+            StatsReference::NumLetters( letters, originalLength, attemptLength, lengthDifference );
+            StatsReference::Links( letters, numLinks, largestLink, averageLinkSize );
+
+            matches &= CHECK( aw.Score() == StatsReference::Score( letters, originalLength ) );
+            matches &= CHECK( stats.attemptLength_ == attemptLength );
+            matches &= CHECK( aw.LengthDifference() == lengthDifference );
+            matches &= CHECK( aw.NumLinks() == numLinks );
+            matches &= CHECK( aw.LargestLink() == largestLink );
+            matches &= CHECK( fabs( aw.AverageLinkSize() - averageLinkSize ) < 1e-12 );
+        }
+        matches &= CHECK( aw.NumErrors() == StatsReference::NumErrors( letters ) );
+        matches &= CHECK( aw.NumCorrect() == static_cast<int>( StatsReference::CountStatus( letters, Correct ) ) );
+        for( int s = Null; s <= ThreeAwayWrongB; ++s ){
+            LetterStatus status = static_cast<LetterStatus>( s );
+            matches &= CHECK( aw.CountStatus( status ) == static_cast<int>( StatsReference::CountStatus( letters, status ) ) );
+        }
+        return matches;
+    }
+
+    // Builds an analysis from a string of status digits, e.g. "1123" is Correct, Correct, Missing, Wrong.
+    AnalysedWord FromStatuses( unsigned int originalLength, const char* statuses ){
+        AnalysedWord aw( originalLength );
+        for( const char* c = statuses; *c; ++c ){
+            aw.Add( L'a', static_cast<LetterStatus>( *c - '0' ) );
+        }
+        return aw;
+    }
+}
+
+int main(){
+    // Shapes the scoring treats specially: empty, all correct, runs of missing and wrong either way round,
+    // a final link, and swapped and three away groups.
+    const char* cases[] = { "", "1111", "0", "2222", "3333", "11232311", "1133221", "32", "23", "2332",
+                            "1441", "44441", "17151", "16181", "3223322", "1231231", "111000111" };
+    for( unsigned int i = 0; i < sizeof( cases ) / sizeof( cases[0] ); ++i ){
+        for( unsigned int length = 0; length <= 10; length += 5 ){
+            AnalysedWord aw = FromStatuses( length, cases[i] );
+            Matches( aw, length, false );
+            aw.CalculateStats();
+            if( !Matches( aw, length, true ) )
+                cerr << "  case \"" << cases[i] << "\", original length " << length << endl;
+        }
+    }
+
+    // Made-up analyses, long enough to go past AnalysedLetters' inline storage.
+    RandomStream random( 21 );
+    const unsigned int analyses = 200000;
+    unsigned int mismatches = 0;
+    for( unsigned int n = 0; n < analyses; ++n ){
+        unsigned int originalLength = random.Random( 1, WORD_LENGTH_LIMIT );
+        AnalysedWord aw( originalLength );
+        int length = random.Random( 0, 2 * ANALYSED_LETTERS_LIMIT / 3 );
+        for( int i = 0; i < length; ++i ){
+            LetterStatus status = static_cast<LetterStatus>( random.Random( Correct, ThreeAwayWrongB ) );
+            aw.Add( L'a', status );
+            if( status == Swapped ){ // Swapped letters come in pairs
+                aw.Add( L'b', status );
+                ++i;
+            }
+        }
+        bool calculated = n % 4 != 0; // Some are asked without CalculateStats, so count on their own
+        if( calculated )
+            aw.CalculateStats();
+        if( !Matches( aw, originalLength, calculated ) && ++mismatches >= 10 )
+            break; // Enough to go on
+    }
+    return CheckResult();
+}
@@ -0,0 +1,37 @@
+// Check.h
+// The little the tests here need: CHECK reports a failed condition and carries on, and a test's main
+// returns CheckResult() so ctest sees the failures.
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <iostream>
+
+namespace Check{
+    inline int& Failures(){
+        static int failures = 0;
+        return failures;
+    }
+
+    inline bool Report( bool passed, const char* condition, const char* file, int line ){
+        if( !passed ){
+            ++Failures();
+            std::cerr << file << "(" << line << "): CHECK failed: " << condition << std::endl;
+        }
+        return passed;
+    }
+}
+
+#define CHECK( condition ) Check::Report( (condition) ? true : false, #condition, __FILE__, __LINE__ )
+
+// Exit code for main: the number of failures, less than 256 so it survives as a process status.
+inline int CheckResult(){
+    int failures = Check::Failures();
+    if( failures == 0 )
+        std::cout << "All checks passed" << std::endl;
+    else
+        std::cerr << failures << " check(s) failed" << std::endl;
+    return failures > 255 ? 255 : failures;
+}
+
+#endif
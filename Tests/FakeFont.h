@@ -0,0 +1,53 @@
+// FakeFont.h
+// GlyphMetrics for a made-up font, so TextLayout can be tested and timed without GDI+.  Fonts are only
+// passed by reference, so any object can stand in for one: here, the font's key.
+
+#ifndef FAKEFONT_H
+#define FAKEFONT_H
+
+#include <string>
+#include <list>
+#include "TextLayout.h"
+
+class FakeFont : public GlyphMetrics{
+public:
+    // Measuring a letter loops work times, to stand in for what GDI+ costs.
+    explicit FakeFont( unsigned int work = 0 ) : work_(work), calls_(0) {}
+
+    // A new font with the given key.  Every font measures the same, but only fonts with the same key
+    // share their widths.
+    const Gdiplus::Font& Font( const std::wstring& key ){
+        keys_.push_back( key );
+        return *reinterpret_cast<const Gdiplus::Font*>( &keys_.back() );
+    }
+
+    virtual std::wstring FontKey( const Gdiplus::Font& font ){
+        return *reinterpret_cast<const std::wstring*>( &font );
+    }
+
+    // Narrow letters are 4 wide, wide ones 12, the rest 7.  Letters past Latin-1 are 10.
+    virtual float Advance( const Gdiplus::Font&, wchar_t letter ){
+        ++calls_;
+        volatile unsigned int spin = 0;
+        for( unsigned int i = 0; i < work_; ++i )
+            spin += i;
+        return Width( letter );
+    }
+
+    static float Width( wchar_t letter ){
+        if( letter == L'i' || letter == L'l' || letter == L'.' )
+            return 4.0f;
+        if( letter == L'm' || letter == L'w' || letter == L'M' || letter == L'W' )
+            return 12.0f;
+        return letter < 256 ? 7.0f : 10.0f;
+    }
+
+    unsigned int Calls() const{ return calls_; } // Letters measured
+
+private:
+    unsigned int work_;
+    unsigned int calls_;
+    std::list<std::wstring> keys_; // One for each font made, which stands in for it
+};
+
+#endif // FAKEFONT_H
@@ -0,0 +1,188 @@
+// FeedbackTimelineTest.cpp
+// FeedbackTimeline compiled against a fake font, then sampled: where each letter is, and its colour, through
+// each stage of the feedback.
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "FakeFont.h"
+#include "FeedbackTimeline.h"
+#include "TextLayout.h"
+
+using namespace std;
+
+namespace{
+    bool Near( float a, float b ){
+        return fabs( a - b ) < 0.01f;
+    }
+
+    // Palette with a different colour for everything, so each can be told apart.
+    FeedbackPalette TestPalette(){
+        FeedbackPalette palette;
+        palette.pen_     = 0xFF000000;
+        palette.correct_ = 0xFF00FF00;
+        palette.wrong_   = 0xFFFF0000;
+        palette.missing_ = 0xFF0000FF;
+        palette.swapped_ = 0xFFFFFF00;
+        return palette;
+    }
+
+    class Fixture{
+    public:
+        Fixture() : layout_(metrics_), font_(metrics_.Font( L"Arial 20" )), palette_(TestPalette()) {}
+
+        void Compile( const wchar_t* letters, const LetterStatus* statuses ){
+            wstring word( letters );
+            timeline_.Compile( word, vector<LetterStatus>( statuses, statuses + word.size() ), layout_, font_,
+                               palette_, FeedbackTimings() );
+        }
+        // Every visible letter, sampled all the way through, stays inside the extent.
+        bool InsideExtent() const{
+            float left, top, right, bottom;
+            timeline_.Extent( left, top, right, bottom );
+            LetterFrameList frames;
+            for( double t = 0.0; t <= timeline_.Length(); t += 1.0 / 64.0 ){
+                timeline_.Sample( t, frames );
+                for( LetterFrameList::const_iterator iter = frames.begin(); iter != frames.end(); ++iter ){
+                    if( iter->visible_ && ( iter->x_ < left - 0.01f || iter->y_ < top - 0.01f ||
+                        iter->x_ + FakeFont::Width( iter->letter_ ) > right + 0.01f || iter->y_ > bottom + 0.01f ) )
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        FakeFont metrics_;
+        TextLayout layout_;
+        const Gdiplus::Font& font_;
+        FeedbackPalette palette_;
+        FeedbackTimeline timeline_;
+    };
+
+    void AllCorrect(){
+        Fixture fixture;
+        LetterStatus statuses[] = { Correct, Correct, Correct };
+        fixture.Compile( L"cat", statuses );
+        CHECK( fixture.timeline_.Length() == 1.0 && fixture.timeline_.Steps() == 2 );
+
+        LetterFrameList frames;
+        fixture.timeline_.Sample( 0.0, frames );
+        CHECK( frames.size() == 3 && frames[1].visible_ && frames[2].x_ == 14.0f );
+        CHECK( frames[0].letter_ == L'c' && frames[0].colour_ == fixture.palette_.pen_ );
+        fixture.timeline_.Sample( 0.5, frames ); // Half way from the pen to correct
+        CHECK( frames[0].colour_ == 0xFF007F00 );
+        fixture.timeline_.Sample( 5.0, frames ); // Past the end holds the end
+        CHECK( frames[0].colour_ == fixture.palette_.correct_ );
+
+        // Each letter was measured once, however many times it is sampled.
+        CHECK( fixture.metrics_.Calls() == 3 );
+        CHECK( fixture.InsideExtent() );
+    }
+
+    void WrongAndMissing(){
+        Fixture fixture;
+        LetterStatus statuses[] = { Correct, Wrong, Missing, Correct };
+        fixture.Compile( L"cxat", statuses );
+        CHECK( fixture.timeline_.Length() == 2.0 );
+
+        LetterFrameList frames;
+        fixture.timeline_.Sample( 0.5, frames ); // The missing letter isn't shown yet, and takes no room
+        CHECK( frames[1].visible_ && !frames[2].visible_ && frames[3].x_ == 14.0f );
+
+        // Half way, the wrong letter has dropped half out as the missing one drops half in, in its place.
+        fixture.timeline_.Sample( 1.5, frames );
+        CHECK( frames[1].x_ == 7.0f && Near( frames[1].y_, 75.0f ) );
+        CHECK( frames[2].x_ == 7.0f && Near( frames[2].y_, -75.0f ) && frames[3].x_ == 14.0f );
+        CHECK( ( frames[1].colour_ >> 24 ) == 128 && ( frames[2].colour_ >> 24 ) == 127 );
+
+        fixture.timeline_.Sample( 2.0, frames );
+        CHECK( !frames[1].visible_ && frames[2].x_ == 7.0f && frames[3].x_ == 14.0f );
+        CHECK( frames[2].colour_ == fixture.palette_.missing_ );
+
+        float left, top, right, bottom;
+        fixture.timeline_.Extent( left, top, right, bottom );
+        CHECK( left == 0.0f && Near( top, -150.0f ) && right == 21.0f && Near( bottom, 150.0f ) );
+        CHECK( fixture.InsideExtent() );
+
+        // Letters after a group that is only wrong close up behind it.
+        LetterStatus wrongs[] = { Wrong, Wrong, Correct };
+        fixture.Compile( L"wwa", wrongs );
+        fixture.timeline_.Sample( 1.5, frames );
+        CHECK( frames[2].x_ == 12.0f );
+        fixture.timeline_.Sample( 2.0, frames );
+        CHECK( frames[2].x_ == 0.0f );
+        CHECK( fixture.InsideExtent() );
+    }
+
+    void Misplaced(){
+        Fixture fixture;
+        LetterFrameList frames;
+
+        LetterStatus swapped[] = { Swapped, Swapped, Correct };
+        fixture.Compile( L"wab", swapped );
+        CHECK( fixture.timeline_.Length() == 2.0 );
+        fixture.timeline_.Sample( 1.5, frames );
+        CHECK( frames[0].x_ == 3.5f && frames[1].x_ == 6.0f && frames[2].x_ == 19.0f );
+        fixture.timeline_.Sample( 2.0, frames );
+        CHECK( frames[1].x_ == 0.0f && frames[0].x_ == 7.0f && frames[0].colour_ == fixture.palette_.swapped_ );
+        CHECK( fixture.InsideExtent() );
+
+        // The wrong x jumps over ab, landing where the missing x shows up.
+        LetterStatus threeAway[] = { ThreeAwayWrongF, Correct, Correct, ThreeAwayMissingB };
+        fixture.Compile( L"xabx", threeAway );
+        CHECK( fixture.timeline_.Length() == 2.0 );
+        fixture.timeline_.Sample( 1.0, frames );
+        CHECK( frames[0].x_ == 0.0f && frames[1].x_ == 7.0f && !frames[3].visible_ );
+        fixture.timeline_.Sample( 1.5, frames );
+        CHECK( frames[0].x_ == 7.0f && frames[0].y_ < 0.0f && frames[1].x_ == 3.5f && frames[2].x_ == 10.5f );
+        fixture.timeline_.Sample( 2.0, frames );
+        CHECK( !frames[0].visible_ && frames[1].x_ == 0.0f && frames[2].x_ == 7.0f && frames[3].x_ == 14.0f );
+        CHECK( frames[3].colour_ == fixture.palette_.swapped_ );
+        CHECK( fixture.InsideExtent() );
+    }
+
+    // Sampling in any order gives the same frames as sampling forwards.
+    void SamplesAnyOrder(){
+        Fixture fixture;
+        LetterStatus statuses[] = { Correct, Swapped, Swapped, Wrong, Missing, Correct };
+        fixture.Compile( L"mlipat", statuses );
+
+        const double times[] = { 3.0, 0.25, 2.75, 1.5, 0.0, 100.0, 1.25 };
+        LetterFrameList frames, again;
+        for( unsigned int i = 0; i < sizeof( times ) / sizeof( times[0] ); ++i ){
+            fixture.timeline_.Sample( times[i], frames );
+            for( unsigned int j = 0; j < 3; ++j )
+                fixture.timeline_.Sample( times[j], again );
+            fixture.timeline_.Sample( times[i], again );
+            bool same = frames.size() == again.size();
+            for( size_t k = 0; same && k < frames.size(); ++k ){
+                same = frames[k].visible_ == again[k].visible_ && frames[k].x_ == again[k].x_ &&
+                       frames[k].y_ == again[k].y_ && frames[k].colour_ == again[k].colour_;
+            }
+            CHECK( same );
+        }
+        CHECK( fixture.InsideExtent() );
+    }
+
+    void Empty(){
+        Fixture fixture;
+        fixture.Compile( L"", 0 );
+        LetterFrameList frames( 3 );
+        fixture.timeline_.Sample( 0.5, frames );
+        CHECK( frames.empty() );
+
+        float left = 1.0f, top = 1.0f, right = 1.0f, bottom = 1.0f;
+        fixture.timeline_.Extent( left, top, right, bottom );
+        CHECK( left == 0.0f && top == 0.0f && right == 0.0f && bottom == 0.0f );
+    }
+}
+
+int main(){
+    AllCorrect();
+    WrongAndMissing();
+    Misplaced();
+    SamplesAnyOrder();
+    Empty();
+    return CheckResult();
+}
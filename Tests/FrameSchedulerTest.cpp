@@ -0,0 +1,190 @@
+// FrameSchedulerTest.cpp
+// FrameScheduler with a clock that only moves when told and a surface that records what it is asked
+// to draw, so frame timing and the dirty rectangles can be checked exactly.
+
+#include <vector>
+#include "Check.h"
+#include "FrameScheduler.h"
+
+using namespace std;
+
+namespace{
+    class FakeClock : public FrameClock{
+    public:
+        FakeClock() : now_(100.0) {}
+        virtual double Now(){ return now_; }
+        double now_;
+    };
+
+    class FakeSurface : public FrameSurface{
+    public:
+        struct Call{
+            bool draw_; // Else present
+            DirtyRect rect_;
+        };
+        virtual void Draw( const DirtyRect& rect ){ Record( true, rect ); }
+        virtual void Present( const DirtyRect& rect ){ Record( false, rect ); }
+
+        void Record( bool draw, const DirtyRect& rect ){
+            Call call;
+            call.draw_ = draw;
+            call.rect_ = rect;
+            calls_.push_back( call );
+        }
+        // Whether a call drew exactly rect
+        bool Drew( const DirtyRect& rect ) const{
+            for( vector<Call>::const_iterator iter = calls_.begin(); iter != calls_.end(); ++iter ){
+                if( iter->draw_ && Same( iter->rect_, rect ) )
+                    return true;
+            }
+            return false;
+        }
+        static bool Same( const DirtyRect& a, const DirtyRect& b ){
+            return a.left_ == b.left_ && a.top_ == b.top_ && a.right_ == b.right_ && a.bottom_ == b.bottom_;
+        }
+
+        vector<Call> calls_;
+    };
+
+    const double PERIOD = 1.0 / 64.0; // Exact in binary, so the fake clock lands on each frame exactly
+
+    void Rects(){
+        DirtyRect rect( 10, 10, 20, 20 );
+        CHECK( !rect.Empty() && DirtyRect().Empty() && DirtyRect( 5, 5, 5, 9 ).Empty() );
+        CHECK( rect.Touches( DirtyRect( 20, 10, 30, 20 ) ) );  // Sharing an edge
+        CHECK( !rect.Touches( DirtyRect( 21, 10, 30, 20 ) ) );
+
+        rect.Merge( DirtyRect( 15, 0, 40, 12 ) );
+        CHECK( FakeSurface::Same( rect, DirtyRect( 10, 0, 40, 20 ) ) );
+        rect.Merge( DirtyRect() );
+        CHECK( FakeSurface::Same( rect, DirtyRect( 10, 0, 40, 20 ) ) );
+        rect.Clip( DirtyRect( 0, 5, 30, 100 ) );
+        CHECK( FakeSurface::Same( rect, DirtyRect( 10, 5, 30, 20 ) ) );
+        rect.Clip( DirtyRect( 50, 50, 60, 60 ) );
+        CHECK( rect.Empty() );
+    }
+
+    void Regions(){
+        DirtyRegion region;
+        CHECK( region.Empty() && !region.All() );
+        region.Add( DirtyRect( 0, 0, 0, 10 ) ); // Empty, so ignored
+        CHECK( region.Empty() );
+
+        // Rectangles that touch become one; those apart stay apart.
+        region.Add( DirtyRect( 0, 0, 10, 10 ) );
+        region.Add( DirtyRect( 100, 100, 110, 110 ) );
+        CHECK( region.Rects().size() == 2 );
+        region.Add( DirtyRect( 10, 0, 20, 10 ) );
+        CHECK( region.Rects().size() == 2 );
+        // One that bridges the two swallows both.
+        region.Add( DirtyRect( 5, 5, 105, 105 ) );
+        CHECK( region.Rects().size() == 1 && FakeSurface::Same( region.Rects()[0], DirtyRect( 0, 0, 110, 110 ) ) );
+
+        // Too many, and they are merged into their bounds.
+        region.Clear();
+        for( int i = 0; i < 9; ++i )
+            region.Add( DirtyRect( i * 20, 0, i * 20 + 10, 10 ) );
+        CHECK( region.Rects().size() == 1 && FakeSurface::Same( region.Rects()[0], DirtyRect( 0, 0, 170, 10 ) ) );
+
+        DirtyRegion all;
+        all.AddAll();
+        region.Add( all );
+        CHECK( region.All() && !region.Empty() && region.Rects().empty() );
+        region.Add( DirtyRect( 0, 0, 10, 10 ) ); // Already covered
+        CHECK( region.Rects().empty() );
+        region.Clear();
+        CHECK( region.Empty() );
+    }
+
+    void DrawsOnlyWhatChanged(){
+        FakeClock clock;
+        FakeSurface surface;
+        DirtyRect screen( 0, 0, 800, 600 );
+        FrameScheduler scheduler( clock, screen, PERIOD );
+
+        // The first frame is the whole screen, straight away.
+        CHECK( scheduler.Frame( surface ) );
+        CHECK( surface.calls_.size() == 2 && surface.Drew( screen ) && !surface.calls_[1].draw_ );
+        CHECK( !scheduler.Frame( surface ) ); // Nothing dirty
+        CHECK( scheduler.Frames() == 1 );
+
+        // A key's highlight moving: the old and new key, not the screen.
+        surface.calls_.clear();
+        DirtyRegion moved;
+        moved.Add( DirtyRect( 100, 400, 140, 440 ) );
+        moved.Add( DirtyRect( 150, 400, 190, 440 ) );
+        moved.Add( DirtyRect( 790, 590, 900, 700 ) ); // Partly off screen
+        scheduler.Invalidate( moved );
+        CHECK( !scheduler.Frame( surface ) ); // Too soon after the last
+        clock.now_ += PERIOD;
+        CHECK( scheduler.Frame( surface ) );
+        CHECK( surface.calls_.size() == 6 );
+        CHECK( surface.Drew( DirtyRect( 100, 400, 140, 440 ) ) && surface.Drew( DirtyRect( 150, 400, 190, 440 ) ) );
+        CHECK( surface.Drew( DirtyRect( 790, 590, 800, 600 ) ) );
+        CHECK( !surface.Drew( screen ) );
+        // Everything is drawn before any of it is presented.
+        CHECK( surface.calls_[0].draw_ && surface.calls_[1].draw_ && surface.calls_[2].draw_ );
+        CHECK( !surface.calls_[3].draw_ && !surface.calls_[4].draw_ && !surface.calls_[5].draw_ );
+
+        surface.calls_.clear();
+        clock.now_ += PERIOD;
+        scheduler.InvalidateAll();
+        CHECK( scheduler.Frame( surface ) && surface.calls_.size() == 2 && surface.Drew( screen ) );
+        CHECK( scheduler.Frames() == 3 );
+    }
+
+    void Timing(){
+        FakeClock clock;
+        FakeSurface surface;
+        FrameScheduler scheduler( clock, DirtyRect( 0, 0, 800, 600 ), PERIOD );
+        scheduler.Frame( surface );
+
+        // Idle and drawn: nothing until input.
+        CHECK( scheduler.Wait() < 0.0 );
+        CHECK( !scheduler.UpdateDue() );
+        clock.now_ += 5.0;
+        CHECK( scheduler.Step() == 0.0 ); // No jump after being idle
+
+        // Dirty just after a frame: wait for the rest of the period.
+        scheduler.InvalidateAll();
+        CHECK( scheduler.Wait() == 0.0 );
+        scheduler.Frame( surface );
+        scheduler.InvalidateAll();
+        clock.now_ += 0.25 * PERIOD;
+        CHECK( scheduler.Wait() == 0.75 * PERIOD );
+
+        // Animating: updated every period, with the time since the last step.
+        scheduler.SetAnimating( true );
+        CHECK( scheduler.Animating() );
+        scheduler.Step();
+        CHECK( !scheduler.UpdateDue() );
+        clock.now_ += PERIOD;
+        CHECK( scheduler.UpdateDue() && scheduler.Wait() == 0.0 );
+        CHECK( scheduler.Step() == PERIOD );
+        clock.now_ += 3.0; // A stall is capped, so animations don't leap
+        CHECK( scheduler.Step() == 0.1 );
+
+        scheduler.SetAnimating( false );
+        scheduler.Frame( surface );
+        CHECK( scheduler.Wait() < 0.0 );
+    }
+
+    // However the clock and period round, the first frame is never held back.
+    void FirstFrame(){
+        FakeClock clock;
+        clock.now_ = 12345.678;
+        FakeSurface surface;
+        FrameScheduler scheduler( clock, DirtyRect( 0, 0, 800, 600 ), 1.0 / 60.0 );
+        CHECK( scheduler.Wait() == 0.0 );
+        CHECK( scheduler.Frame( surface ) );
+    }
+}
+
+int main(){
+    Rects();
+    Regions();
+    DrawsOnlyWhatChanged();
+    Timing();
+    FirstFrame();
+    return CheckResult();
+}
@@ -0,0 +1,89 @@
+// HitGridBench.cpp
+// Times HitGrid against testing every key in turn, as Keyboard did before it, on a keyboard laid out in
+// rows of 30 keys.  Points are spread over the keyboard and a little around it.
+//
+//   hit_grid_bench [keys] [queries] [seed]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "HitGrid.h"
+#include "Random.h"
+
+using namespace std;
+
+namespace{
+    typedef chrono::steady_clock Clock;
+
+    struct Key{
+        float x_, y_, width_, height_;
+    };
+
+    double Seconds( Clock::time_point start ){
+        return chrono::duration<double>( Clock::now() - start ).count();
+    }
+
+    int LinearFind( const vector<Key>& keys, float x, float y ){
+        for( size_t i = 0; i < keys.size(); ++i ){
+            const Key& key = keys[i];
+            if( x >= key.x_ && x <= key.x_ + key.width_ && y >= key.y_ && y <= key.y_ + key.height_ )
+                return static_cast<int>( i );
+        }
+        return -1;
+    }
+}
+
+int main( int argc, char* argv[] ){
+    unsigned int count = argc > 1 ? strtoul( argv[1], 0, 10 ) : 600;
+    unsigned int queries = argc > 2 ? strtoul( argv[2], 0, 10 ) : 1000000;
+    RandomStream random( argc > 3 ? strtoull( argv[3], 0, 10 ) : 1 );
+    if( count == 0 || queries == 0 ){
+        cerr << "hit_grid_bench [keys] [queries] [seed]" << endl;
+        return 1;
+    }
+
+    vector<Key> keys( count );
+    HitGrid grid;
+    for( unsigned int i = 0; i < count; ++i ){
+        Key& key = keys[i];
+        key.x_ = ( i % 30 ) * 42.0f;
+        key.y_ = ( i / 30 ) * 50.0f;
+        key.width_ = 40.0f;
+        key.height_ = 45.0f;
+        grid.Add( key.x_, key.y_, key.width_, key.height_ );
+    }
+    grid.Build();
+
+    float width = ( count < 30 ? count : 30 ) * 42.0f, height = ( ( count + 29 ) / 30 ) * 50.0f;
+    vector<float> xs( queries ), ys( queries );
+    for( unsigned int i = 0; i < queries; ++i ){
+        xs[i] = static_cast<float>( random.Unit() * width * 1.2 - width * 0.1 );
+        ys[i] = static_cast<float>( random.Unit() * height * 1.2 - height * 0.1 );
+    }
+
+    vector<int> linear( queries ), found( queries );
+    Clock::time_point start = Clock::now();
+    for( unsigned int i = 0; i < queries; ++i )
+        linear[i] = LinearFind( keys, xs[i], ys[i] );
+    double linearSeconds = Seconds( start );
+
+    start = Clock::now();
+    for( unsigned int i = 0; i < queries; ++i )
+        found[i] = grid.Find( xs[i], ys[i] );
+    double gridSeconds = Seconds( start );
+
+    unsigned int mismatches = 0, hits = 0;
+    for( unsigned int i = 0; i < queries; ++i ){
+        if( found[i] != linear[i] )
+            ++mismatches;
+        if( found[i] >= 0 )
+            ++hits;
+    }
+
+    cout << count << " keys, " << queries << " queries, " << hits << " on a key\n"
+         << "linear: " << linearSeconds * 1e9 / queries << " ns a query\n"
+         << "grid:   " << gridSeconds * 1e9 / queries << " ns a query\n"
+         << "mismatches: " << mismatches << endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// HitGridTest.cpp
+// HitGrid against testing every rectangle in turn, which is what Keyboard did before it: keyboards, scattered
+// rectangles, and tiny or empty ones with stragglers far away, probed on their edges and all around them.
+
+#include <vector>
+#include "Check.h"
+#include "HitGrid.h"
+#include "Random.h"
+
+using namespace std;
+
+namespace{
+    struct Box{
+        float x_, y_, width_, height_;
+    };
+
+    // The first box containing the point, edges included, or -1.
+    int LinearFind( const vector<Box>& boxes, float x, float y ){
+        for( size_t i = 0; i < boxes.size(); ++i ){
+            const Box& box = boxes[i];
+            if( x >= box.x_ && x <= box.x_ + box.width_ && y >= box.y_ && y <= box.y_ + box.height_ )
+                return static_cast<int>( i );
+        }
+        return -1;
+    }
+
+    float Between( RandomStream& random, float low, float high ){
+        return low + ( high - low ) * static_cast<float>( random.Unit() );
+    }
+
+    void Build( HitGrid& grid, const vector<Box>& boxes ){
+        grid.Clear();
+        for( vector<Box>::const_iterator box = boxes.begin(); box != boxes.end(); ++box )
+            grid.Add( box->x_, box->y_, box->width_, box->height_ );
+        grid.Build();
+    }
+
+    void Keys(){
+        HitGrid grid;
+        CHECK( grid.Find( 0.0f, 0.0f ) == -1 ); // Nothing added
+        grid.Build();
+        CHECK( grid.Find( 0.0f, 0.0f ) == -1 && grid.Size() == 0 );
+
+        CHECK( grid.Add( 0.0f, 0.0f, 40.0f, 45.0f ) == 0 );
+        CHECK( grid.Add( 42.0f, 0.0f, 40.0f, 45.0f ) == 1 );
+        CHECK( grid.Add( 0.0f, 50.0f, 82.0f, 45.0f ) == 2 );
+        grid.Build();
+        CHECK( grid.Size() == 3 );
+        CHECK( grid.Find( 20.0f, 20.0f ) == 0 && grid.Find( 60.0f, 20.0f ) == 1 && grid.Find( 81.0f, 94.0f ) == 2 );
+        CHECK( grid.Find( 40.0f, 45.0f ) == 0 && grid.Find( 42.0f, 0.0f ) == 1 ); // Edges included
+        CHECK( grid.Find( 41.0f, 20.0f ) == -1 && grid.Find( 20.0f, 47.0f ) == -1 ); // The gaps
+        CHECK( grid.Find( -1.0f, 20.0f ) == -1 && grid.Find( 20.0f, 96.0f ) == -1 ); // Outside
+
+        // Overlapping: the first added wins, as it did testing them in turn.
+        grid.Add( 10.0f, 10.0f, 100.0f, 100.0f );
+        grid.Build();
+        CHECK( grid.Find( 20.0f, 20.0f ) == 0 && grid.Find( 100.0f, 100.0f ) == 3 );
+
+        grid.Clear();
+        grid.Build();
+        CHECK( grid.Size() == 0 && grid.Find( 20.0f, 20.0f ) == -1 );
+    }
+
+    // Layouts of every kind, each probed at random and on its boxes' corners, from a fixed seed.
+    void MatchesLinear(){
+        RandomStream random( 49 );
+        HitGrid grid;
+        vector<Box> boxes;
+        for( int layout = 0; layout < 3000; ++layout ){
+            int kind = layout % 3;
+            int count = random.Random( 1, kind == 0 ? 600 : 60 );
+            boxes.clear();
+            for( int i = 0; i < count; ++i ){
+                Box box;
+                if( kind == 0 ){ // Rows of keys
+                    box.x_ = ( i % 30 ) * 42.0f + 10.0f;
+                    box.y_ = ( i / 30 ) * 50.0f + 300.0f;
+                    box.width_ = 40.0f;
+                    box.height_ = 45.0f;
+                }
+                else if( kind == 1 ){ // Scattered, overlapping
+                    box.x_ = Between( random, 0.0f, 1000.0f );
+                    box.y_ = Between( random, 0.0f, 800.0f );
+                    box.width_ = Between( random, 0.0f, 200.0f );
+                    box.height_ = Between( random, 0.0f, 100.0f );
+                }
+                else{ // Tiny, some with no height, some far off to the sides
+                    box.x_ = Between( random, -5.0f, 5.0f ) * ( random.Random( 0, 1 ) ? 1.0f : 100.0f );
+                    box.y_ = Between( random, -5.0f, 5.0f );
+                    box.width_ = Between( random, 0.0f, 3.0f );
+                    box.height_ = random.Random( 0, 4 ) ? Between( random, 0.0f, 3.0f ) : 0.0f;
+                }
+                boxes.push_back( box );
+            }
+            Build( grid, boxes );
+
+            for( int probe = 0; probe < 2000; ++probe ){
+                float x, y;
+                if( probe % 4 == 0 ){
+                    const Box& box = boxes[random.Random( 0, count - 1 )];
+                    x = box.x_ + ( random.Random( 0, 1 ) ? box.width_ : 0.0f );
+                    y = box.y_ + ( random.Random( 0, 1 ) ? box.height_ : 0.0f );
+                }
+                else{
+                    x = Between( random, -600.0f, 1400.0f );
+                    y = Between( random, -50.0f, 1000.0f );
+                }
+                if( !CHECK( grid.Find( x, y ) == LinearFind( boxes, x, y ) ) )
+                    return;
+            }
+        }
+    }
+}
+
+int main(){
+    Keys();
+    MatchesLinear();
+    return CheckResult();
+}
@@ -0,0 +1,157 @@
+// ImageCacheTest.cpp
+// ImageCache with a decoder that only hands out tokens, so it runs without GDI+ and can count every
+// Decode and Free.
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "ImageCache.h"
+
+using namespace std;
+
+namespace{
+    // Each Decode gives a new token standing in for a bitmap; "missing" can't be decoded.
+    class StubDecoder : public ImageDecoder{
+    public:
+        StubDecoder() : bytes_(100) {}
+
+        virtual Gdiplus::Bitmap* Decode( const std::wstring& path ){
+            ++decodes_[path];
+            if( path == L"missing" )
+                return 0;
+            Gdiplus::Bitmap* bitmap = reinterpret_cast<Gdiplus::Bitmap*>( new char[1] );
+            live_.insert( bitmap );
+            return bitmap;
+        }
+        virtual std::size_t Bytes( Gdiplus::Bitmap* ){
+            return bytes_;
+        }
+        virtual void Free( Gdiplus::Bitmap* bitmap ){
+            CHECK( live_.erase( bitmap ) == 1 ); // Only freed once, and only what was decoded
+            delete[] reinterpret_cast<char*>( bitmap );
+        }
+
+        unsigned int Decodes( const std::wstring& path ){
+            return decodes_[path];
+        }
+        bool Live( Gdiplus::Bitmap* bitmap ) const{
+            return live_.find( bitmap ) != live_.end();
+        }
+        std::size_t LiveCount() const{
+            return live_.size();
+        }
+
+        std::size_t bytes_; // Size of each bitmap decoded
+
+    private:
+        std::map<std::wstring, unsigned int> decodes_;
+        std::set<Gdiplus::Bitmap*> live_;
+    };
+
+    void DecodesOnce(){
+        StubDecoder decoder;
+        ImageCache cache( decoder, 1000 );
+        Gdiplus::Bitmap* a = cache.Acquire( L"a" );
+        CHECK( a != 0 );
+        CHECK( cache.Acquire( L"a" ) == a );
+        CHECK( cache.Acquire( L"a" ) == a );
+        CHECK( decoder.Decodes( L"a" ) == 1 );
+        CHECK( cache.Acquire( L"b" ) != a );
+        CHECK( cache.Size() == 2 && cache.Bytes() == 200 );
+        CHECK( cache.Hits() == 2 && cache.Misses() == 2 );
+
+        // A failed decode isn't cached, so it is tried again.
+        CHECK( cache.Acquire( L"missing" ) == 0 );
+        CHECK( cache.Acquire( L"missing" ) == 0 );
+        CHECK( decoder.Decodes( L"missing" ) == 2 );
+        CHECK( cache.Misses() == 4 && cache.Size() == 2 );
+    }
+
+    void CountsReferences(){
+        StubDecoder decoder;
+        ImageCache cache( decoder, 0 ); // Nothing unused is kept
+        Gdiplus::Bitmap* a = cache.Acquire( L"a" );
+        cache.Acquire( L"a" );
+        cache.Release( a );
+        CHECK( cache.Contains( L"a" ) && decoder.Live( a ) ); // Still one reference
+        cache.Release( a );
+        CHECK( !cache.Contains( L"a" ) && !decoder.Live( a ) );
+        CHECK( cache.Evictions() == 1 && cache.Bytes() == 0 );
+
+        // Releasing too often, or what the cache never gave out, does nothing.
+        cache.Release( a );
+        cache.Release( static_cast<Gdiplus::Bitmap*>( 0 ) );
+        CHECK( cache.Evictions() == 1 );
+
+        vector<Gdiplus::Bitmap*> bitmaps;
+        bitmaps.push_back( cache.Acquire( L"b" ) );
+        bitmaps.push_back( cache.Acquire( L"c" ) );
+        cache.Release( bitmaps );
+        CHECK( bitmaps.empty() && cache.Size() == 0 && decoder.LiveCount() == 0 );
+    }
+
+    void EvictsLeastRecentlyUsed(){
+        StubDecoder decoder;
+        ImageCache cache( decoder, 300 );
+        Gdiplus::Bitmap* a = cache.Acquire( L"a" );
+        Gdiplus::Bitmap* b = cache.Acquire( L"b" );
+        Gdiplus::Bitmap* c = cache.Acquire( L"c" );
+        Gdiplus::Bitmap* d = cache.Acquire( L"d" );
+        CHECK( cache.Bytes() == 400 && cache.Evictions() == 0 ); // Over budget, but all in use
+
+        cache.Release( b );
+        CHECK( !cache.Contains( L"b" ) && cache.Bytes() == 300 );
+        cache.Release( a );
+        cache.Release( c );
+        cache.Release( d );
+        CHECK( cache.Contains( L"a" ) && cache.Contains( L"c" ) && cache.Contains( L"d" ) );
+
+        // Using a again makes c the least recently used.
+        CHECK( cache.Acquire( L"a" ) == a );
+        cache.Release( a );
+        decoder.bytes_ = 200;
+        cache.Acquire( L"e" );
+        CHECK( !cache.Contains( L"c" ) && !cache.Contains( L"d" ) && cache.Contains( L"a" ) );
+        CHECK( cache.Bytes() == 300 && cache.Evictions() == 3 );
+
+        // A smaller budget frees what isn't in use at once.
+        cache.SetBudget( 0 );
+        CHECK( cache.Size() == 1 && cache.Contains( L"e" ) && !decoder.Live( a ) );
+        CHECK( cache.Budget() == 0 && cache.Bytes() == 200 );
+    }
+
+    void AdoptsPreloaded(){
+        StubDecoder decoder;
+        ImageCache cache( decoder, 1000 );
+        Gdiplus::Bitmap* a = decoder.Decode( L"a" );
+        cache.Adopt( L"a", a );
+        CHECK( cache.Contains( L"a" ) && cache.Bytes() == 100 );
+        CHECK( cache.Acquire( L"a" ) == a && cache.Hits() == 1 && cache.Misses() == 0 );
+
+        // A second copy of something already cached is freed.
+        Gdiplus::Bitmap* copy = decoder.Decode( L"a" );
+        cache.Adopt( L"a", copy );
+        CHECK( !decoder.Live( copy ) && cache.Size() == 1 );
+    }
+
+    void FreesEverything(){
+        StubDecoder decoder;
+        {
+            ImageCache cache( decoder, 100 );
+            cache.Acquire( L"a" );
+            cache.Release( cache.Acquire( L"b" ) );
+        }
+        CHECK( decoder.LiveCount() == 0 );
+    }
+}
+
+int main(){
+    DecodesOnce();
+    CountsReferences();
+    EvictsLeastRecentlyUsed();
+    AdoptsPreloaded();
+    FreesEverything();
+    return CheckResult();
+}
@@ -0,0 +1,124 @@
+// KeyboardLayoutTest.cpp
+// The three shipped layouts compile to the rows and keys their files describe, KeyboardLayouts keeps each
+// one, and a Keyboard loaded from a compiled layout is the one loaded from its file.
+//
+//   keyboard_layout_test [directory of the layouts]
+
+#include <string>
+#include "Check.h"
+#include "Keyboard.h"
+#include "KeyboardLayout.h"
+
+using namespace std;
+
+namespace{
+    string directory = "../Data/Keyboards/";
+
+    bool Offsets( const KeyboardLayout& layout, const float* offsets, size_t rows ){
+        if( layout.RowOffsets().size() != rows )
+            return false;
+        for( size_t i = 0; i < rows; ++i ){
+            if( layout.RowOffsets()[i] != offsets[i] )
+                return false;
+        }
+        return true;
+    }
+
+    // The key whose current character is c, or 0.
+    const KeyboardLayout::KeyRecord* FindKey( const KeyboardLayout& layout, wchar_t c ){
+        const vector<KeyboardLayout::KeyRecord>& keys = layout.Keys();
+        for( vector<KeyboardLayout::KeyRecord>::const_iterator key = keys.begin(); key != keys.end(); ++key ){
+            if( key->current_ == c )
+                return &*key;
+        }
+        return 0;
+    }
+
+    bool IsKey( const KeyboardLayout& layout, wchar_t c, int row, int col, wchar_t alternate, bool disabled,
+                const wstring& text, bool displayIsChar, int width, int height ){
+        const KeyboardLayout::KeyRecord* key = FindKey( layout, c );
+        return key && key->row_ == row && key->col_ == col && key->alternate_ == alternate &&
+               key->disabled_ == disabled && layout.DisplayText( *key ) == text &&
+               key->displayIsChar_ == displayIsChar && key->scaleWidth_ == width && key->scaleHeight_ == height;
+    }
+
+    void Qwerty(){
+        KeyboardLayout layout;
+        if( !CHECK( layout.Compile( directory + "qwerty.txt" ) ) )
+            return;
+        const float offsets[] = { 0.0f, 0.3f, 0.6f, 1.0f, 3.2f }; // The first row is implied
+        CHECK( Offsets( layout, offsets, 5 ) );
+        CHECK( layout.Keys().size() == 46 );
+        CHECK( IsKey( layout, L'1', 1, 1, L'1', true, L"1", true, 1, 1 ) );
+        CHECK( IsKey( layout, L'-', 1, 11, L'_', false, L"-", true, 1, 1 ) );
+        CHECK( IsKey( layout, 8, 1, 13, 8, false, L"\x2190", false, 2, 1 ) );   // Backspace, by code
+        CHECK( IsKey( layout, 13, 2, 13, 13, false, L"\x21B2", false, 1, 2 ) ); // Enter, two rows high
+        CHECK( IsKey( layout, L'm', 4, 7, L'M', false, L"m", true, 1, 1 ) );
+        CHECK( IsKey( layout, 44, 4, 8, 44, true, L"", true, 1, 1 ) );         // Comma, by code: no text, the key shows it
+        CHECK( IsKey( layout, L' ', 5, 1, L' ', false, L" ", true, 5, 1 ) );
+    }
+
+    void Abc(){
+        KeyboardLayout layout;
+        if( !CHECK( layout.Compile( directory + "abc.txt" ) ) )
+            return;
+        const float offsets[] = { 0.0f, 0.0f, 0.0f };
+        CHECK( Offsets( layout, offsets, 3 ) );
+        CHECK( layout.Keys().size() == 27 );
+        CHECK( IsKey( layout, L'a', 1, 1, L'A', false, L"a", true, 1, 1 ) ); // Uppercase taken if not given
+        CHECK( IsKey( layout, L'k', 2, 1, L'K', false, L"k", true, 1, 1 ) );
+        CHECK( IsKey( layout, L' ', 3, 7, L' ', false, L"SPACE", false, 3, 1 ) );
+        CHECK( !FindKey( layout, 8 ) && !FindKey( layout, 13 ) );
+    }
+
+    void Special(){
+        KeyboardLayout layout;
+        if( !CHECK( layout.Compile( directory + "special.txt" ) ) )
+            return;
+        const float offsets[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        CHECK( Offsets( layout, offsets, 6 ) );
+        CHECK( layout.Keys().size() == 26 );
+        CHECK( IsKey( layout, L'\xE0', 1, 1, L'\xC0', false, L"\xE0", true, 1, 1 ) );
+        CHECK( IsKey( layout, L'\xFF', 6, 3, L'\x0178', false, L"\xFF", true, 1, 1 ) );
+    }
+
+    void Layouts(){
+        KeyboardLayouts layouts;
+        CHECK( layouts.Get( directory + "missing.txt" ) == 0 && layouts.Size() == 0 );
+        const char* files[] = { "qwerty.txt", "abc.txt", "special.txt" };
+        for( int i = 0; i < 3; ++i ){
+            string file = directory + files[i];
+            const KeyboardLayout* layout = layouts.Get( file );
+            if( !CHECK( layout != 0 ) )
+                continue;
+            CHECK( layouts.Get( file ) == layout ); // Compiled once, then kept
+
+            // A keyboard from the file and one from the compiled layout have the same rows and keys.
+            Keyboard fromFile, fromLayout;
+            CHECK( fromFile.LoadKeyboard( file ) && fromLayout.LoadKeyboard( layout ) );
+            CHECK( fromFile.mRowOffsets == fromLayout.mRowOffsets && fromFile.KeyCount() == fromLayout.KeyCount() );
+            KeyMask a, b;
+            fromFile.EnabledKeys( a );
+            fromLayout.EnabledKeys( b );
+            CHECK( a == b );
+            bool found = true;
+            const vector<KeyboardLayout::KeyRecord>& keys = layout->Keys();
+            for( vector<KeyboardLayout::KeyRecord>::const_iterator key = keys.begin(); key != keys.end(); ++key )
+                found = found && fromFile.KeyIndex( key->current_ ) >= 0 &&
+                        fromFile.KeyIndex( key->current_ ) == fromLayout.KeyIndex( key->current_ );
+            CHECK( found );
+        }
+        CHECK( layouts.Size() == 3 );
+        CHECK( !Keyboard().LoadKeyboard( static_cast<const KeyboardLayout*>( 0 ) ) );
+    }
+}
+
+int main( int argc, char* argv[] ){
+    if( argc > 1 )
+        directory = string( argv[1] ) + "/";
+    Qwerty();
+    Abc();
+    Special();
+    Layouts();
+    return CheckResult();
+}
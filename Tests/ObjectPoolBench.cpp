@@ -0,0 +1,174 @@
+// ObjectPoolBench.cpp
+// Counts the heap allocations the word list screen makes each time it opens, before and after its rows
+// came from WordRows and an ObjectPool.  Every allocation goes through the operator new below.
+//
+//   object_pool_bench [words] [tags] [opens] [seed]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "Convert.h"
+#include "Definitions.h"
+#include "ObjectPool.h"
+#include "Options.h"
+#include "Random.h"
+#include "ScrollBox.h"
+#include "Word.h"
+
+using namespace std;
+
+namespace{
+    size_t allocations = 0;
+}
+
+void* operator new( size_t size ){
+    ++allocations;
+    void* p = malloc( size > 0 ? size : 1 );
+    if( !p )
+        throw bad_alloc();
+    return p;
+}
+
+void operator delete( void* p ) throw(){
+    free( p );
+}
+
+namespace{
+    typedef chrono::steady_clock Clock;
+
+    double Milliseconds( Clock::time_point start ){
+        return chrono::duration<double, milli>( Clock::now() - start ).count();
+    }
+
+    // A tag's row, as SetUpTagScrollBox makes it.
+    RowData TagRow( unsigned int tag ){
+        RowData rd;
+        rd.dataID_ = tag;
+        rd.data_.push_back( L"tag" + stringify( tag ) );
+        rd.data_.push_back( stringify( tag % 50 ) );
+        return rd;
+    }
+
+    // A word's row, as the word list made them all before WordRows.
+    RowData WordRow( const WordBank::value_type& word, const IDList& stars ){
+        RowData rd;
+        rd.dataID_ = word.first;
+        rd.data_.push_back( stringify( word.second.GetDifficulty() ) );
+        rd.data_.push_back( word.second.GetMainSpellingString() );
+        rd.data_.push_back( stars.count( word.first ) ? L"1On" : L"2Off" );
+        return rd;
+    }
+}
+
+int main( int argc, char* argv[] ){
+    unsigned int words = argc > 1 ? strtoul( argv[1], 0, 10 ) : 200000;
+    unsigned int tags = argc > 2 ? strtoul( argv[2], 0, 10 ) : 300;
+    unsigned int opens = argc > 3 ? strtoul( argv[3], 0, 10 ) : 5;
+    RandomStream random( argc > 4 ? strtoull( argv[4], 0, 10 ) : 1 );
+    if( opens == 0 )
+        opens = 1;
+
+    WordBank bank;
+    IDList stars;
+    for( unsigned int id = 1; id <= words; ++id ){
+        wstring spelling;
+        for( int length = random.Random( 3, 12 ); length > 0; --length )
+            spelling += static_cast<wchar_t>( L'a' + random.Random( 0, 25 ) );
+        Word word( id, random.Random( 1, 10 ), false, 1 );
+        word.AddSpelling( Spelling( 1, spelling ) );
+        bank.insert( make_pair( id, word ) );
+        if( random.Random( 0, 9 ) == 0 )
+            stars.insert( id );
+    }
+
+    // Before: a RowData made with new for every word and every tag, each time the screen opens.
+    unsigned long long mismatches = 0;
+    size_t start = allocations;
+    Clock::time_point clock = Clock::now();
+    for( unsigned int open = 0; open < opens; ++open ){
+        TableData wordData, tagData;
+        for( WordBank::const_iterator iter = bank.begin(); iter != bank.end(); ++iter ){
+            RowData rd = WordRow( *iter, stars );
+            wordData.push_back( new RowData( rd.dataID_, rd.data_, rd.active_ ) );
+        }
+        for( unsigned int tag = 0; tag < tags; ++tag ){
+            RowData rd = TagRow( tag );
+            tagData.push_back( new RowData( rd.dataID_, rd.data_, rd.active_ ) );
+        }
+        for( TableData::iterator iter = wordData.begin(); iter != wordData.end(); ++iter )
+            delete *iter;
+        for( TableData::iterator iter = tagData.begin(); iter != tagData.end(); ++iter )
+            delete *iter;
+    }
+    size_t before = ( allocations - start ) / opens;
+    double beforeMs = Milliseconds( clock ) / opens;
+
+    // After: WordRows makes a word's row only when it is shown, and the tags come from a pool.
+    start = allocations;
+    clock = Clock::now();
+    for( unsigned int open = 0; open < opens; ++open ){
+        WordRows rows( bank, stars );
+        rows.SortAlphabetically();
+        rows.SortByDifficulty();
+        for( int row = 0; row < 12 && row < rows.Rows(); ++row ) // A screenful
+            rows.Row( row );
+        TableData tagData;
+        RowPool tagRows;
+        for( unsigned int tag = 0; tag < tags; ++tag )
+            tagData.push_back( tagRows.Make( TagRow( tag ) ) );
+    }
+    size_t after = ( allocations - start ) / opens;
+    double afterMs = Milliseconds( clock ) / opens;
+
+    // The tags on their own, made as SetUpTagScrollBox made them and as it makes them now.
+    start = allocations;
+    {
+        TableData tagData;
+        for( unsigned int tag = 0; tag < tags; ++tag ){
+            RowData rd = TagRow( tag );
+            tagData.push_back( new RowData( rd.dataID_, rd.data_, rd.active_ ) );
+        }
+        for( TableData::iterator iter = tagData.begin(); iter != tagData.end(); ++iter )
+            delete *iter;
+    }
+    size_t tagsBefore = allocations - start;
+    size_t tagsAfter = 0;
+    {
+        start = allocations;
+        TableData tagData;
+        RowPool tagRows;
+        for( unsigned int tag = 0; tag < tags; ++tag )
+            tagData.push_back( tagRows.Make( TagRow( tag ) ) );
+        tagsAfter = allocations - start;
+
+        // The pooled rows hold what the rows made with new did.
+        for( unsigned int tag = 0; tag < tags; ++tag ){
+            RowData rd = TagRow( tag );
+            if( tagData[tag]->dataID_ != rd.dataID_ || tagData[tag]->data_ != rd.data_ ||
+                tagData[tag]->active_ != rd.active_ || !tagData[tag]->visible_ )
+                ++mismatches;
+        }
+    }
+
+    // WordRows gives every word the row it had before.
+    {
+        WordRows rows( bank, stars );
+        int row = 0;
+        for( WordBank::const_iterator iter = bank.begin(); iter != bank.end(); ++iter, ++row ){
+            RowData rd = WordRow( *iter, stars );
+            const RowData& shown = rows.Row( row );
+            if( shown.dataID_ != rd.dataID_ || shown.data_ != rd.data_ || shown.active_ != rd.active_ )
+                ++mismatches;
+        }
+    }
+
+    cout << words << " words, " << tags << " tags, " << opens << " opens\n"
+         << "per open, before: " << before << " allocations, " << beforeMs << " ms\n"
+         << "per open, after:  " << after << " allocations, " << afterMs << " ms\n"
+         << "tags alone:       " << tagsBefore << " allocations before, " << tagsAfter << " after\n"
+         << "mismatches:       " << mismatches << endl;
+    return mismatches == 0 && ( tags == 0 || tagsAfter < tagsBefore ) && after < before ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+// ObjectPoolTest.cpp
+// ObjectPool with an object that counts how many of it are alive, so every copy made and destroyed shows.
+
+#include <cstddef>
+#include <vector>
+#include "Check.h"
+#include "ObjectPool.h"
+
+using namespace std;
+
+namespace{
+    class Counted{
+    public:
+        explicit Counted( int value ) : value_(value) { ++live_; }
+        Counted( const Counted& other ) : value_(other.value_) { ++live_; }
+        ~Counted(){ --live_; }
+
+        int value_;
+        static int live_;
+    };
+    int Counted::live_ = 0;
+
+    void MakesInBlocks(){
+        ObjectPool<Counted> pool( 4 );
+        vector<Counted*> made;
+        for( int i = 0; i < 10; ++i )
+            made.push_back( pool.Make( Counted( i ) ) );
+
+        bool kept = true;
+        for( int i = 0; i < 10; ++i )
+            kept = kept && made[i]->value_ == i;
+        CHECK( kept );
+        CHECK( Counted::live_ == 10 && pool.Size() == 10 );
+        CHECK( pool.Allocations() == 3 ); // Three blocks of 4, the last half used
+        CHECK( made[1] == made[0] + 1 && made[3] == made[0] + 3 ); // Side by side in a block
+    }
+
+    void ClearKeepsBlocks(){
+        ObjectPool<Counted> pool( 4 );
+        for( int round = 0; round < 3; ++round ){
+            for( int i = 0; i < 10; ++i )
+                pool.Make( Counted( i ) );
+            pool.Clear();
+            CHECK( Counted::live_ == 0 && pool.Size() == 0 );
+        }
+        CHECK( pool.Allocations() == 3 );
+
+        // One more than the blocks hold takes one more block.
+        for( int i = 0; i < 13; ++i )
+            pool.Make( Counted( i ) );
+        CHECK( pool.Allocations() == 4 );
+    }
+
+    void DestroysWithPool(){
+        {
+            ObjectPool<Counted> pool;
+            for( int i = 0; i < 100; ++i )
+                pool.Make( Counted( i ) );
+            CHECK( Counted::live_ == 100 && pool.Allocations() == 2 ); // Blocks of 64
+        }
+        CHECK( Counted::live_ == 0 );
+
+        {
+            ObjectPool<Counted> empty( 0 ); // Taken as blocks of 1
+            empty.Make( Counted( 1 ) );
+            empty.Make( Counted( 2 ) );
+            CHECK( empty.Allocations() == 2 );
+        }
+        CHECK( Counted::live_ == 0 );
+    }
+}
+
+int main(){
+    MakesInBlocks();
+    ClearKeepsBlocks();
+    DestroysWithPool();
+    return CheckResult();
+}
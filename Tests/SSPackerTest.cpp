@@ -0,0 +1,145 @@
+// SSPackerTest.cpp
+// SSPacker with a made-up font: every letter the same width, shrinking with each smaller size.  Checks the
+// packings it makes, then packs thousands of questions with far too many, far too long wrong spellings to
+// see it still places every word once, in bounded time, and always the same way for the same seed.
+
+#include <set>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "Random.h"
+#include "SSPacker.h"
+
+using namespace std;
+
+namespace{
+    const float SCALES[] = { 1.0f, 0.85f, 0.7f, 0.55f };
+
+    class FakeMeasure : public WordMeasure{
+    public:
+        FakeMeasure() : widths_(0) {}
+
+        virtual unsigned int Sizes(){ return sizeof( SCALES ) / sizeof( SCALES[0] ); }
+        virtual float Width( unsigned int size, const std::wstring& word ){
+            ++widths_;
+            return 14.0f * SCALES[size] * word.size();
+        }
+        virtual float Height( unsigned int size ){ return 30.0f * SCALES[size]; }
+
+        unsigned int widths_; // Words measured
+    };
+
+    const float WIDTH = 1000.0f, HEIGHT = 500.0f, BOX_WIDTH = 60.0f, BOX_HEIGHT = 80.0f;
+
+    // Every word is either in a row or dropped, once; the correct spelling is never dropped; and the rows
+    // fit the region, save the correct spelling on its own when it is too wide for any row.
+    bool Valid( const SSPacking& packing, size_t words ){
+        set<int> seen;
+        bool correct = false;
+        if( packing.rows_.size() > static_cast<size_t>( HEIGHT / packing.rowHeight_ ) && packing.rows_.size() > 1 )
+            return false;
+        for( vector<SSPackedRow>::const_iterator row = packing.rows_.begin(); row != packing.rows_.end(); ++row ){
+            float width = 0.0f;
+            for( SSPackedRow::const_iterator word = row->begin(); word != row->end(); ++word ){
+                if( *word < 0 || static_cast<size_t>( *word ) >= words || !seen.insert( *word ).second )
+                    return false;
+                width += packing.widths_[*word];
+                correct = correct || *word == 0;
+            }
+            if( row->empty() || ( width > WIDTH && row->size() > 1 ) )
+                return false;
+        }
+        for( vector<int>::const_iterator word = packing.dropped_.begin(); word != packing.dropped_.end(); ++word ){
+            if( *word <= 0 || static_cast<size_t>( *word ) >= words || !seen.insert( *word ).second )
+                return false;
+        }
+        return correct && seen.size() == words;
+    }
+
+    void FitsAtFullSize(){
+        FakeMeasure measure;
+        SSPacker packer( measure, WIDTH, HEIGHT, BOX_WIDTH, BOX_HEIGHT );
+        vector<wstring> wrong;
+        wrong.push_back( L"elefant" );
+        wrong.push_back( L"ellephant" );
+        wrong.push_back( L"elephent" );
+        RandomStream random( 1 );
+        SSPacking packing;
+        packer.Pack( L"elephant", wrong, random, packing );
+
+        CHECK( Valid( packing, 4 ) );
+        CHECK( packing.size_ == 0 && packing.dropped_.empty() );
+        CHECK( packing.rowHeight_ == 30.0f + BOX_HEIGHT && packing.widths_[0] == 8 * 14.0f + BOX_WIDTH );
+        CHECK( measure.widths_ == 4 ); // Each word measured once
+    }
+
+    void ShrinksThenDrops(){
+        FakeMeasure measure;
+        SSPacker packer( measure, WIDTH, HEIGHT, BOX_WIDTH, BOX_HEIGHT );
+        RandomStream random( 2 );
+        SSPacking packing;
+
+        // 12 words of 20 letters: four rows of two at full size is too few, but a size down takes three a row.
+        vector<wstring> wrong( 11, wstring( 20, L'a' ) );
+        packer.Pack( wstring( 20, L'c' ), wrong, random, packing );
+        CHECK( Valid( packing, 12 ) );
+        CHECK( packing.size_ == 1 && packing.dropped_.empty() );
+
+        // Far too many to fit at any size: the smallest is used, and the wrong spellings that don't fit left out.
+        wrong.assign( 200, wstring( 20, L'a' ) );
+        packer.Pack( wstring( 20, L'c' ), wrong, random, packing );
+        CHECK( Valid( packing, 201 ) );
+        CHECK( packing.size_ == 3 && !packing.dropped_.empty() );
+    }
+
+    void CorrectTooWide(){
+        FakeMeasure measure;
+        SSPacker packer( measure, WIDTH, HEIGHT, BOX_WIDTH, BOX_HEIGHT );
+        RandomStream random( 3 );
+        SSPacking packing;
+        packer.Pack( wstring( 200, L'c' ), vector<wstring>( 5, L"short" ), random, packing );
+
+        CHECK( Valid( packing, 6 ) );
+        CHECK( packing.size_ == 3 );
+        bool alone = false;
+        for( vector<SSPackedRow>::const_iterator row = packing.rows_.begin(); row != packing.rows_.end(); ++row )
+            alone = alone || ( row->size() == 1 && row->front() == 0 );
+        CHECK( alone );
+    }
+
+    // Questions as bad as they come, from a fixed seed: up to 300 wrong spellings of up to 120 letters.
+    void WorstCases(){
+        FakeMeasure measure;
+        SSPacker packer( measure, WIDTH, HEIGHT, BOX_WIDTH, BOX_HEIGHT );
+        RandomStream questions( 46 );
+        for( int trial = 0; trial < 2000; ++trial ){
+            int count = questions.Random( 0, 300 );
+            vector<wstring> wrong;
+            for( int i = 0; i < count; ++i )
+                wrong.push_back( wstring( questions.Random( 1, 120 ), L'a' ) );
+            wstring correct( questions.Random( 1, 120 ), L'c' );
+            RandomStream::Seed seed = questions.Next();
+
+            RandomStream first( seed ), second( seed );
+            SSPacking a, b;
+            measure.widths_ = 0;
+            packer.Pack( correct, wrong, first, a );
+            // Bounded: no word is measured more than once a size.
+            if( !CHECK( measure.widths_ <= measure.Sizes() * ( wrong.size() + 1 ) ) )
+                break;
+            packer.Pack( correct, wrong, second, b );
+            if( !CHECK( Valid( a, wrong.size() + 1 ) ) )
+                break;
+            if( !CHECK( a.size_ == b.size_ && a.rows_ == b.rows_ && a.dropped_ == b.dropped_ ) )
+                break;
+        }
+    }
+}
+
+int main(){
+    FitsAtFullSize();
+    ShrinksThenDrops();
+    CorrectTooWide();
+    WorstCases();
+    return CheckResult();
+}
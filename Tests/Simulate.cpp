@@ -0,0 +1,82 @@
+// Simulate.cpp
+// Console runner for Simulator, built apart from the app (see CMakeLists.txt).  Every run is made-up data
+// from the seed given, so the same arguments give the same results, apart from the timings.
+//
+//   simulate run [spellers] [words] [attempts per speller] [weighting 0-2] [seed] [scratch database]
+//   simulate compare [attempts] [seed]
+//   simulate index [words] [queries] [k] [seed]
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include "Simulator.h"
+#include "Speller.h"
+#include "DBController.h"
+#include "Range.h"
+
+using namespace std;
+
+namespace{
+    // The argument at i, or fallback if there isn't one.
+    unsigned long long Argument( int argc, char* argv[], int i, unsigned long long fallback ){
+        return i < argc ? strtoull( argv[i], 0, 10 ) : fallback;
+    }
+
+    int Usage(){
+        wcerr << L"simulate run [spellers] [words] [attempts per speller] [weighting 0-2] [seed] [scratch database]\n"
+              << L"simulate compare [attempts] [seed]\n"
+              << L"simulate index [words] [queries] [k] [seed]" << endl;
+        return 1;
+    }
+}
+
+int main( int argc, char* argv[] ){
+    if( argc < 2 )
+        return Usage();
+    string command = argv[1];
+
+    if( command == "run" ){
+        SimulationSettings settings;
+        settings.spellers_ = Argument( argc, argv, 2, settings.spellers_ );
+        settings.words_ = Argument( argc, argv, 3, settings.words_ );
+        settings.attemptsPerSpeller_ = Argument( argc, argv, 4, settings.attemptsPerSpeller_ );
+        settings.weighting_ = static_cast<SpellingSession::WeightingOption>( Argument( argc, argv, 5, settings.weighting_ ) % 3 );
+        settings.seed_ = Argument( argc, argv, 6, settings.seed_ );
+
+        WordBank bank;
+        RandomStream random( settings.seed_ );
+        Simulator::MakeWordBank( bank, settings.words_, random );
+        DBController* db = argc > 7 ? new DBController( argv[7] ) : 0;
+        Simulator simulator( bank, db );
+        wcout << simulator.Run( settings ).ToString() << endl;
+        delete db;
+        return 0;
+    }
+
+    Speller speller( 1, L"Simulated", Range(1, 10), L"", IDList(), IDList() );
+    if( command == "compare" ){
+        unsigned int attempts = Argument( argc, argv, 2, 20000 );
+        RandomStream random( Argument( argc, argv, 3, 1 ) );
+        WordBank bank;
+        Simulator::MakeWordBank( bank, 2000, random );
+        Simulator simulator( bank );
+        Corpus corpus;
+        simulator.MakeCorpus( corpus, attempts, ErrorModel(), random );
+        ComparisonReport report = simulator.CompareEngines( corpus, speller );
+        report.seed_ = random.GetSeed();
+        wcout << report.ToString() << endl;
+        return 0;
+    }
+    if( command == "index" ){
+        unsigned int words = Argument( argc, argv, 2, 100000 );
+        unsigned int queries = Argument( argc, argv, 3, 5000 );
+        size_t k = Argument( argc, argv, 4, 5 );
+        RandomStream random( Argument( argc, argv, 5, 1 ) );
+        WordBank bank;
+        Simulator::MakeWordBank( bank, words, random );
+        Simulator simulator( bank );
+        wcout << simulator.BenchmarkIndex( queries, k, ErrorModel(), speller, random ).ToString() << endl;
+        return 0;
+    }
+    return Usage();
+}
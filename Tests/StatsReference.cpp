@@ -0,0 +1,240 @@
+// StatsReference.cpp
+// Copied from Word.cpp as it was before AnalysedWord::Tally replaced these, changed only to take the
+// letters as arguments.
+
+#include "StatsReference.h"
+#include <cstdlib>
+
+using namespace std;
+
+namespace StatsReference{
+
+    int Score( const AnalysedLetters& word, unsigned int originalLength ){
+        int total = originalLength * 10;
+    
+        int countA = 0;
+        int countB = 0;
+        LetterStatus currentType = Null;
+        LetterStatus lastType = Null;
+    
+        for(AWConstIter i = word.begin(); i != word.end(); ++i){
+
+            switch( i->status_ ){
+                case Correct:
+                case ThreeAwayMissingF:
+                case ThreeAwayMissingB:{
+                    // Do nothing.
+                    break;
+                }
+                case Swapped:{
+                    total -= 3;
+                    break;
+                }
+            
+                case ThreeAwayWrongF:
+                case ThreeAwayWrongB: {
+                    total -= 6;
+                    break;
+                }
+                case Missing:
+                case Wrong:
+                {
+                    total -= 10;
+                }
+                default:{
+                    break;
+                }
+            }//switch
+            if( currentType != i->status_ ){ // If the type is different to the type parsed previously...
+                lastType = currentType;      // ...make a copy of the previous type...
+                currentType = i->status_;    // ...and store the new type.
+            
+                if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
+                    if( countA < countB ){
+                        total += (11 * countA);
+                    } else {
+                        total += (11*countB);
+                    }
+                }
+                // TODO: Is it possible to have Missing - Wrong - Missing or similar?
+                // That is, to have a string of missing, followed by wrong, followed by missing, or vice versa?
+                if( currentType != Wrong && currentType != Missing ){
+                    countA = 0;
+                    countB = 0;
+                }
+            }
+            if( currentType != lastType ){ // This type is different from the type we've parsed previously.
+                if( currentType == Wrong ){ // If it's of type Wrong...
+                    if( lastType == Missing ){ // ...and previous was Missing...
+                        ++countB;              // ...increase the second counter.
+                    } else {                   
+                        ++countA;              // Otherwise increase the first counter.
+                    }
+                } else if( currentType == Missing ){
+                    if( lastType == Wrong ) {
+                        ++countB;
+                    } else {
+                        ++countA;
+                    }
+                }
+            }  
+        } // for loop
+        // Last check for any final missing/wrong letters
+        if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
+            if( countA < countB ){
+                total += (11*countA);
+            } else {
+                total += (11*countB);
+            }
+            countA = 0;
+            countB = 0;
+        }
+        return total;
+    }
+
+    void NumLetters( const AnalysedLetters& word, unsigned int originalLength,
+                     unsigned int& attemptLength, unsigned int& lengthDifference ){
+        // Total up number of correct, wrong, swapped and threeawaywrong
+        // Don't count missing (not in the attempt) and threeawaymissing (already counted as threeawaywrong)
+        attemptLength = 0;
+        for(AWConstIter iter = word.begin(); iter != word.end(); ++iter ){
+            switch( iter->status_ ){
+                case Correct:
+                case Wrong:
+                case Swapped:
+                case ThreeAwayWrongF:
+                case ThreeAwayWrongB: {
+                    ++attemptLength;
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }// end switch
+        }// End for
+    
+        // Calculate lengthDifference
+        lengthDifference = abs(static_cast<int>(attemptLength) - static_cast<int>(originalLength));
+    }
+
+    void Links( const AnalysedLetters& word, unsigned int& numLinks, unsigned int& largestLink,
+                double& averageLinkSize ){
+        averageLinkSize = 0;
+        largestLink = 0;
+        numLinks = 0;
+        int currentLinkSize = 0;
+        for(AWConstIter iter = word.begin(); iter != word.end(); ++iter ){
+        
+            switch( iter->status_ ){
+                case Correct:{
+                    if( currentLinkSize == 0 ){ // No link being counted
+                        ++numLinks;                    
+                    }
+                    ++currentLinkSize;
+                    break;
+                }
+                default:{
+                    if( currentLinkSize > 0 ){
+                        if( static_cast<unsigned int>( currentLinkSize ) > largestLink ){
+                            largestLink = currentLinkSize;
+                        }
+                        currentLinkSize = 0;
+                    }
+                    break;
+                }
+            } // End switch
+        }// End for
+    
+        // Avoid divide by zero problems.  Set average to zero in these circumstances.
+        if( numLinks == 0 )
+            averageLinkSize = 0;
+        else
+            averageLinkSize = static_cast<double>( CountStatus( word, Correct ) ) / static_cast<double>( numLinks ) ;
+    }
+
+    int NumErrors( const AnalysedLetters& word ){
+        // Each swapped pair is 1 error.
+        // Each three away is 1 error.
+        // Each matching pair of missing/wrong (adjacent groups) is 1 error
+        // Each extra wrong or missing is 1 error.
+        int errors = 0;
+        int countA = 0;
+        int countB = 0;
+        LetterStatus currentType = Null;
+        LetterStatus lastType = Null;
+    
+        for(AWConstIter i = word.begin(); i != word.end(); ++i){
+
+            switch( i->status_ ){
+                case Correct:
+                case ThreeAwayMissingF:
+                case ThreeAwayMissingB: 
+                case Missing:
+                case Wrong:{
+                    // Do nothing.
+                    // Missing and Wrong dealt with elsewhere
+                    // Only count ThreeAwayWrong, so the error isn't counted twice.
+                    break;
+                }
+                case Swapped:{
+                    ++errors;
+                    ++i; // advance iterator to skip next swapped
+                    break;
+                }
+            
+                case ThreeAwayWrongF:
+                case ThreeAwayWrongB: {
+                    ++errors;
+                    break;
+                }
+                default:{
+                    break;
+                }
+            }//switch
+            if( currentType != i->status_ ){ // If the type is different to the type parsed previously...
+                lastType = currentType;      // ...make a copy of the previous type...
+                currentType = i->status_;    // ...and store the new type.
+            
+                if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
+                    errors += (countA > countB ? countA : countB ); // Add the number of the largest group
+                }
+                if( currentType != Wrong && currentType != Missing ){
+                    countA = 0;
+                    countB = 0;
+                }
+            }
+            if( currentType != lastType ){ // This type is different from the type we've parsed previously.
+                if( currentType == Wrong ){ // If it's of type Wrong...
+                    if( lastType == Missing ){ // ...and previous was Missing...
+                        ++countB;              // ...increase the second counter.
+                    } else {                   
+                        ++countA;              // Otherwise increase the first counter.
+                    }
+                } else if( currentType == Missing ){
+                    if( lastType == Wrong ) {
+                        ++countB;
+                    } else {
+                        ++countA;
+                    }
+                }
+            }  
+        } // for loop
+        // Last check for any final missing/wrong letters
+        if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
+            errors += countA > countB ? countA : countB;
+            countA = 0;
+            countB = 0;
+        }
+        return errors;
+    }
+
+    unsigned int CountStatus( const AnalysedLetters& word, LetterStatus status ){
+         unsigned int countS = 0;
+         for(AWConstIter iter = word.begin(); iter != word.end(); ++iter ){
+            if( iter->status_ == status ){
+                ++countS;
+            }
+         }
+         return countS;
+    }
+}
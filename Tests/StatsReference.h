@@ -0,0 +1,25 @@
+// StatsReference.h
+// AnalysedWord's statistics as they were worked out before Tally: one pass per statistic.  Kept only so
+// AnalysisStatsTest can check Tally against them; nothing in the app uses these.
+
+#ifndef STATSREFERENCE_H
+#define STATSREFERENCE_H
+
+#include "Word.h"
+
+namespace StatsReference{
+    // The old AnalysedWord::CalculateScore
+    int Score( const AnalysedLetters& word, unsigned int originalLength );
+    // The old AnalysedWord::CalculateNumLetters
+    void NumLetters( const AnalysedLetters& word, unsigned int originalLength,
+                     unsigned int& attemptLength, unsigned int& lengthDifference );
+    // The old AnalysedWord::CalculateLinks
+    void Links( const AnalysedLetters& word, unsigned int& numLinks, unsigned int& largestLink,
+                double& averageLinkSize );
+    // The old AnalysedWord::NumErrors
+    int NumErrors( const AnalysedLetters& word );
+    // The old AnalysedWord::CountStatus
+    unsigned int CountStatus( const AnalysedLetters& word, LetterStatus status );
+}
+
+#endif
@@ -0,0 +1,102 @@
+// TextLayoutBench.cpp
+// Times TextLayout against what ScreenPrinter did before it, with a fake font that takes work loops
+// to measure a letter.  Lines are made-up attempts, coloured as feedback would colour them.
+//
+//   text_layout_bench [lines] [work per letter measured] [seed]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "FakeFont.h"
+#include "Random.h"
+#include "TextLayout.h"
+
+using namespace std;
+
+namespace{
+    typedef chrono::steady_clock Clock;
+
+    struct Line{
+        wstring text_;
+        vector<unsigned int> colours_;
+        float width_; // To fit the line in
+    };
+
+    double Seconds( Clock::time_point start ){
+        return chrono::duration<double>( Clock::now() - start ).count();
+    }
+
+    void MakeLines( vector<Line>& lines, unsigned int count, RandomStream& random ){
+        lines.resize( count );
+        for( vector<Line>::iterator line = lines.begin(); line != lines.end(); ++line ){
+            int length = random.Random( 3, 20 );
+            unsigned int colour = 0;
+            for( int i = 0; i < length; ++i ){
+                line->text_ += static_cast<wchar_t>( L'a' + random.Random( 0, 25 ) );
+                if( random.Random( 0, 3 ) == 0 ) // Mostly right, with some letters wrong or missing
+                    colour = random.Random( 0, 2 );
+                line->colours_.push_back( colour );
+            }
+            line->width_ = static_cast<float>( random.Random( 20, 150 ) );
+        }
+    }
+}
+
+int main( int argc, char* argv[] ){
+    unsigned int count = argc > 1 ? strtoul( argv[1], 0, 10 ) : 100000;
+    unsigned int work = argc > 2 ? strtoul( argv[2], 0, 10 ) : 200;
+    RandomStream random( argc > 3 ? strtoull( argv[3], 0, 10 ) : 1 );
+    vector<Line> lines;
+    MakeLines( lines, count, random );
+
+    // Before: every letter measured and drawn on its own, and truncation measuring the whole string
+    // again after dropping each letter from the front.
+    FakeFont before( work );
+    const Gdiplus::Font& beforeFont = before.Font( L"Arial 20" );
+    unsigned long long beforeDraws = 0, beforeCut = 0;
+    Clock::time_point start = Clock::now();
+    for( vector<Line>::const_iterator line = lines.begin(); line != lines.end(); ++line ){
+        float x = 0.0f;
+        for( size_t i = 0; i < line->text_.length(); ++i ){
+            x += before.Advance( beforeFont, line->text_[i] );
+            ++beforeDraws;
+        }
+        size_t cut = 0;
+        for( ; cut + 1 < line->text_.length(); ++cut ){
+            float measured = 0.0f;
+            for( size_t i = cut; i < line->text_.length(); ++i )
+                measured += before.Advance( beforeFont, line->text_[i] );
+            if( measured <= line->width_ )
+                break;
+        }
+        beforeCut += cut;
+    }
+    double beforeSeconds = Seconds( start );
+
+    // After: cached advances, a draw for each colour run, and truncation from the cached widths.
+    FakeFont after( work );
+    const Gdiplus::Font& afterFont = after.Font( L"Arial 20" );
+    TextLayout layout( after );
+    TextRunList runs;
+    unsigned long long afterDraws = 0, afterCut = 0;
+    start = Clock::now();
+    for( vector<Line>::const_iterator line = lines.begin(); line != lines.end(); ++line ){
+        layout.Runs( afterFont, line->text_, line->colours_, 0.0f, runs );
+        afterDraws += runs.size();
+        afterCut += layout.FrontCut( afterFont, line->text_, line->width_ );
+    }
+    double afterSeconds = Seconds( start );
+
+    cout << count << " lines, " << work << " work a letter measured\n"
+         << "before: " << beforeSeconds * 1e9 / count << " ns a line, " << before.Calls() << " letters measured, "
+         << beforeDraws << " draws\n"
+         << "after:  " << afterSeconds * 1e9 / count << " ns a line, " << after.Calls() << " letters measured, "
+         << afterDraws << " draws, " << layout.Hits() << " cache hits\n";
+    if( beforeCut != afterCut ){
+        cerr << "Truncation differs: " << beforeCut << " letters cut before, " << afterCut << " after" << endl;
+        return 1;
+    }
+    return 0;
+}
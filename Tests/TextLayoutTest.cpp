@@ -0,0 +1,105 @@
+// TextLayoutTest.cpp
+// TextLayout against a fake font: the advance cache, colour runs and cutting text to fit.
+
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "FakeFont.h"
+#include "TextLayout.h"
+
+using namespace std;
+
+namespace{
+    void CachesAdvances(){
+        FakeFont metrics;
+        TextLayout layout( metrics );
+        const Gdiplus::Font& font = metrics.Font( L"Arial 20" );
+
+        vector<float> advances;
+        CHECK( layout.Advances( font, L"mill", advances ) == 12.0f + 4.0f + 4.0f + 4.0f );
+        CHECK( advances.size() == 4 && advances[0] == 12.0f && advances[3] == 4.0f );
+        CHECK( metrics.Calls() == 3 ); // m, i and l, each measured once
+        CHECK( layout.Misses() == 3 && layout.Hits() == 1 );
+
+        layout.Advances( font, L"limm", advances );
+        CHECK( metrics.Calls() == 3 && layout.Hits() == 5 );
+
+        // Letters past Latin-1 are cached as well.
+        CHECK( layout.Advance( font, 0x0101 ) == 10.0f );
+        CHECK( layout.Advance( font, 0x0101 ) == 10.0f );
+        CHECK( metrics.Calls() == 4 );
+
+        // Another font measures for itself, unless it has the same key.
+        layout.Advance( metrics.Font( L"Arial 30" ), L'm' );
+        CHECK( metrics.Calls() == 5 );
+        layout.Advance( metrics.Font( L"Arial 20" ), L'm' );
+        CHECK( metrics.Calls() == 5 );
+
+        CHECK( layout.Advances( font, L"", advances ) == 0.0f && advances.empty() );
+    }
+
+    void BatchesRuns(){
+        FakeFont metrics;
+        TextLayout layout( metrics );
+        const Gdiplus::Font& font = metrics.Font( L"Arial 20" );
+
+        // cat, with a wrong a: three runs, each starting where the letters before it end.
+        unsigned int colours[] = { 1, 2, 1 };
+        TextRunList runs;
+        float end = layout.Runs( font, L"cat", vector<unsigned int>( colours, colours + 3 ), 10.0f, runs );
+        CHECK( end == 10.0f + 3 * 7.0f );
+        CHECK( runs.size() == 3 );
+        CHECK( runs[1].first_ == 1 && runs[1].length_ == 1 && runs[1].x_ == 17.0f );
+        CHECK( runs[2].first_ == 2 && runs[2].x_ == 24.0f );
+
+        // Letters of one colour are one run, however many there are.
+        unsigned int same[] = { 5, 5, 5, 5, 7, 7 };
+        layout.Runs( font, L"willow", vector<unsigned int>( same, same + 6 ), 0.0f, runs );
+        CHECK( runs.size() == 2 );
+        CHECK( runs[0].first_ == 0 && runs[0].length_ == 4 && runs[0].x_ == 0.0f );
+        CHECK( runs[1].first_ == 4 && runs[1].length_ == 2 && runs[1].x_ == 12.0f + 4.0f + 4.0f + 4.0f );
+
+        CHECK( layout.Runs( font, L"", vector<unsigned int>(), 3.0f, runs ) == 3.0f && runs.empty() );
+    }
+
+    // The old way: measure the whole string, then drop a letter from the front, until it fits.
+    size_t MeasuredCut( const wstring& text, float width ){
+        size_t cut = 0;
+        for( ; cut + 1 < text.length(); ++cut ){
+            float measured = 0.0f;
+            for( size_t i = cut; i < text.length(); ++i )
+                measured += FakeFont::Width( text[i] );
+            if( measured <= width )
+                break;
+        }
+        return cut;
+    }
+
+    void CutsToFit(){
+        FakeFont metrics;
+        TextLayout layout( metrics );
+        const Gdiplus::Font& font = metrics.Font( L"Arial 20" );
+
+        CHECK( layout.FrontCut( font, L"spelling", 1000.0f ) == 0 );
+        CHECK( layout.FrontCut( font, L"mill", 12.0f ) == 1 );  // ill is exactly 12
+        CHECK( layout.FrontCut( font, L"mill", 11.0f ) == 2 );
+        CHECK( layout.FrontCut( font, L"mill", 0.0f ) == 3 );   // One letter is always left
+        CHECK( layout.FrontCut( font, L"", 0.0f ) == 0 );
+
+        // Agrees with measuring every suffix, for every width.
+        const wstring texts[] = { L"elephant", L"Mississippi", L"will.i.am", L"wwwmmmiiilll", L"a" };
+        for( unsigned int t = 0; t < sizeof( texts ) / sizeof( texts[0] ); ++t ){
+            for( float width = 0.0f; width <= 120.0f; width += 1.0f ){
+                if( !CHECK( layout.FrontCut( font, texts[t], width ) == MeasuredCut( texts[t], width ) ) )
+                    break;
+            }
+        }
+    }
+}
+
+int main(){
+    CachesAdvances();
+    BatchesRuns();
+    CutsToFit();
+    return CheckResult();
+}
@@ -0,0 +1,123 @@
+// WordKeysTest.cpp
+// WordKeys against the per-key enabling MiniSpell did before it: for 20,000 words on each shipped keyboard,
+// with attempts part way through, under both write options and both diacritic options, the masks must leave
+// every key as EnableKey did.  From a fixed seed, so a failure repeats.
+//
+//   word_keys_test [directory of the layouts]
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "Keyboard.h"
+#include "KeyboardLayout.h"
+#include "Random.h"
+#include "Utility.h"
+#include "Word.h"
+#include "WordKeys.h"
+
+using namespace std;
+
+namespace{
+    // Letters on the keyboards and off them, capitals, diacritics and the punctuation words have.
+    const wstring LETTERS = L"abcdeimnorstuyzABEMS\xE0\xE9\xE8\xEF\xF1\xC9\xC7\xDF' -";
+
+    wstring RandomString( RandomStream& random, const wstring& from, int length ){
+        wstring s;
+        for( int i = 0; i < length; ++i )
+            s += from[random.Random( 0, static_cast<int>( from.size() ) - 1 )];
+        return s;
+    }
+
+    // MiniSpell's CharacterAccepted for LETTERSONCE.
+    bool Accepted( wchar_t character, const Word& word, const wstring& attempt, bool autoDiacritics ){
+        wchar_t converted = ToLower( character, autoDiacritics );
+        const wstring& spelling = word.GetMainSpelling().GetNormalised( autoDiacritics, true );
+        wstring convertedAttempt = ApplySpellingOptions( attempt, autoDiacritics, true );
+        return count( spelling.begin(), spelling.end(), converted ) >
+               count( convertedAttempt.begin(), convertedAttempt.end(), converted );
+    }
+
+    // The keys as MiniSpell's WriteOptionAllKeys left them before WordKeys, one EnableKey at a time.
+    void EnableOneByOne( Keyboard& keyboard, const Word& word, const wstring& attempt, bool once, bool autoDiacritics ){
+        keyboard.DisableAllKeys();
+        keyboard.EnableKey( static_cast<wchar_t>(8) );
+        keyboard.EnableKey( static_cast<wchar_t>(13) );
+        wstring spelling = word.GetMainSpellingString();
+        for( wstring::iterator iter = spelling.begin(); iter != spelling.end(); ++iter ){
+            wchar_t character = ToLower( *iter, autoDiacritics );
+            if( !once ){
+                keyboard.EnableKey( character );
+                keyboard.EnableKey( *iter );
+            } else {
+                if( Accepted( character, word, attempt, autoDiacritics ) )
+                    keyboard.EnableKey( character );
+                if( Accepted( *iter, word, attempt, autoDiacritics ) )
+                    keyboard.EnableKey( *iter );
+            }
+        }
+    }
+
+    // As WriteOptionAllKeys does now.
+    void EnableFromMasks( Keyboard& keyboard, WordKeys& wordKeys, const Word& word, const wstring& attempt,
+                          bool once, bool autoDiacritics ){
+        wordKeys.Update( keyboard, word, autoDiacritics );
+        if( !once ){
+            keyboard.EnableKeys( wordKeys.Uses() );
+            return;
+        }
+        KeyMask enabled;
+        wordKeys.Unused( ApplySpellingOptions( attempt, autoDiacritics, true ), enabled );
+        keyboard.EnableKeys( enabled );
+    }
+}
+
+int main( int argc, char* argv[] ){
+    string directory = argc > 1 ? string( argv[1] ) + "/" : "../Data/Keyboards/";
+    KeyboardLayouts layouts;
+    Keyboard keyboards[3];
+    const char* files[] = { "qwerty.txt", "abc.txt", "special.txt" };
+    for( int i = 0; i < 3; ++i ){
+        if( !CHECK( keyboards[i].LoadKeyboard( layouts.Get( directory + files[i] ) ) ) )
+            return CheckResult();
+    }
+
+    // Every word is kept, so no two share an address: WordKeys knows a word by its address.
+    RandomStream random( 50 );
+    const unsigned int WORDS = 20000;
+    vector<Word> words;
+    words.reserve( WORDS );
+    for( unsigned int id = 1; id <= WORDS; ++id ){
+        Word word( id, 1, false, 1 );
+        word.AddSpelling( Spelling( 1, RandomString( random, LETTERS, random.Random( 1, 12 ) ) ) );
+        words.push_back( word );
+    }
+
+    WordKeys wordKeys; // One for the whole run, as MiniSpell has, so it is worked out again on every change
+    unsigned int mismatches = 0;
+    for( unsigned int w = 0; w < WORDS; ++w ){
+        const Word& word = words[w];
+        wstring spelling = word.GetMainSpellingString();
+        for( int k = 0; k < 3; ++k ){
+            Keyboard& keyboard = keyboards[k];
+            for( int option = 0; option < 4; ++option ){
+                bool once = option % 2 == 1, autoDiacritics = option / 2 == 1;
+                // Attempts typed so far: nothing, part of the spelling, and some of its letters and others.
+                wstring attempts[3] = { L"", spelling.substr( 0, random.Random( 0, static_cast<int>( spelling.size() ) ) ),
+                                        RandomString( random, spelling + LETTERS, random.Random( 1, 12 ) ) };
+                for( int a = 0; a < 3; ++a ){
+                    KeyMask expected, actual;
+                    EnableOneByOne( keyboard, word, attempts[a], once, autoDiacritics );
+                    keyboard.EnabledKeys( expected );
+                    keyboard.EnableAllKeys();
+                    EnableFromMasks( keyboard, wordKeys, word, attempts[a], once, autoDiacritics );
+                    keyboard.EnabledKeys( actual );
+                    if( actual != expected )
+                        ++mismatches;
+                }
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+    return CheckResult();
+}
@@ -0,0 +1,88 @@
+// TextLayout.cpp
+
+#include "TextLayout.h"
+
+using namespace std;
+
+TextRun::TextRun( std::size_t first, std::size_t length, float x )
+: first_(first), length_(length), x_(x)
+{}
+
+TextLayout::Glyphs::Glyphs(){
+    for( int i = 0; i < 256; ++i )
+        latin1_[i] = -1.0f;
+}
+
+TextLayout::TextLayout( GlyphMetrics& metrics )
+: metrics_(metrics), hits_(0), misses_(0)
+{}
+
+float TextLayout::Advance( const Gdiplus::Font& font, wchar_t letter ){
+    return Advance( font, FontGlyphs( font ), letter );
+}
+
+float TextLayout::Advances( const Gdiplus::Font& font, const std::wstring& text, std::vector<float>& advances ){
+    Glyphs& glyphs = FontGlyphs( font );
+    advances.clear();
+    advances.reserve( text.length() );
+    float width = 0.0f;
+    for( wstring::const_iterator iter = text.begin(); iter != text.end(); ++iter ){
+        advances.push_back( Advance( font, glyphs, *iter ) );
+        width += advances.back();
+    }
+    return width;
+}
+
+std::size_t TextLayout::FrontCut( const Gdiplus::Font& font, const std::wstring& text, float width ){
+    vector<float> advances;
+    float remaining = Advances( font, text, advances );
+    size_t cut = 0;
+    while( remaining > width && cut + 1 < advances.size() )
+        remaining -= advances[cut++];
+    return cut;
+}
+
+float TextLayout::Runs( const Gdiplus::Font& font, const std::wstring& text, const std::vector<unsigned int>& colours,
+                        float x, TextRunList& runs ){
+    Glyphs& glyphs = FontGlyphs( font );
+    runs.clear();
+    for( size_t i = 0; i < text.length(); ++i ){
+        if( i == 0 || colours[i] != colours[i - 1] )
+            runs.push_back( TextRun( i, 0, x ) );
+        ++runs.back().length_;
+        x += Advance( font, glyphs, text[i] );
+    }
+    return x;
+}
+
+unsigned int TextLayout::Hits() const{
+    return hits_;
+}
+
+unsigned int TextLayout::Misses() const{
+    return misses_;
+}
+
+TextLayout::Glyphs& TextLayout::FontGlyphs( const Gdiplus::Font& font ){
+    return fonts_[metrics_.FontKey( font )];
+}
+
+float TextLayout::Advance( const Gdiplus::Font& font, Glyphs& glyphs, wchar_t letter ){
+    if( static_cast<unsigned int>( letter ) < 256 ){
+        float& advance = glyphs.latin1_[letter];
+        if( advance >= 0.0f ){
+            ++hits_;
+            return advance;
+        }
+        ++misses_;
+        advance = metrics_.Advance( font, letter );
+        return advance;
+    }
+    map<wchar_t, float>::iterator found = glyphs.others_.find( letter );
+    if( found != glyphs.others_.end() ){
+        ++hits_;
+        return found->second;
+    }
+    ++misses_;
+    return glyphs.others_[letter] = metrics_.Advance( font, letter );
+}
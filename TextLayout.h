@@ -0,0 +1,69 @@
+// TextLayout.h
+// Lays out lines of text from the advance width of each character, measured once for each font and
+// character, then cached.  The measuring is left to a GlyphMetrics, so the layout itself needs no
+// GDI+: ScreenPrinter supplies one that asks GDI+, and a fake font with made-up widths works as well.
+
+#ifndef TEXTLAYOUT_H
+#define TEXTLAYOUT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+namespace Gdiplus{
+    class Font;
+}
+
+class GlyphMetrics{
+public:
+    virtual ~GlyphMetrics() {}
+
+    virtual std::wstring FontKey( const Gdiplus::Font& font ) = 0;          // The same for fonts that measure the same
+    virtual float Advance( const Gdiplus::Font& font, wchar_t letter ) = 0; // How far after letter the next one starts
+};
+
+// Letters of a line drawn together, as they share a colour.  The run starts x_ along the line.
+struct TextRun{
+    TextRun( std::size_t first, std::size_t length, float x );
+    std::size_t first_;
+    std::size_t length_;
+    float x_;
+};
+typedef std::vector<TextRun> TextRunList;
+
+class TextLayout{
+public:
+    explicit TextLayout( GlyphMetrics& metrics );
+
+    float Advance( const Gdiplus::Font& font, wchar_t letter );
+    // Fills advances with the advance of each letter of text, and returns the width of text.
+    float Advances( const Gdiplus::Font& font, const std::wstring& text, std::vector<float>& advances );
+    // How many letters to drop from the front of text so the rest fits in width.  Always leaves one letter.
+    std::size_t FrontCut( const Gdiplus::Font& font, const std::wstring& text, float width );
+    // Splits text, laid out from x, into runs of letters next to each other with the same colour.
+    // colours holds a value (such as ARGB) for each letter.  Returns x after the last letter.
+    float Runs( const Gdiplus::Font& font, const std::wstring& text, const std::vector<unsigned int>& colours,
+                float x, TextRunList& runs );
+
+    unsigned int Hits() const;   // Advances found in the cache
+    unsigned int Misses() const; // Advances measured by the GlyphMetrics
+
+private:
+    struct Glyphs{
+        Glyphs();
+        float latin1_[256];               // Negative until measured
+        std::map<wchar_t, float> others_;
+    };
+    typedef std::map<std::wstring, Glyphs> FontMap;
+
+    Glyphs& FontGlyphs( const Gdiplus::Font& font );
+    float Advance( const Gdiplus::Font& font, Glyphs& glyphs, wchar_t letter );
+
+private:
+    GlyphMetrics& metrics_;
+    FontMap fonts_;
+    unsigned int hits_, misses_;
+};
+
+#endif // TEXTLAYOUT_H
@@ -1,19 +1,19 @@
 #include "TitleScreen.h"
 #include "BackBuffer.h"
 #include "App.h"
+#include "ImageCache.h"
 
 using namespace Gdiplus;
 
-TitleScreen::TitleScreen(unsigned int& nextMode, unsigned int previousMode, unsigned int id, BackBuffer* bb):
-Mode(nextMode, previousMode, id)
+TitleScreen::TitleScreen(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, BackBuffer* bb):
+Mode(nextMode, previousMode, id, images)
 {
-    pBackground_ = new Image(L"Images/Title1.jpg");
+    pBackground_ = images_.Acquire(L"Images/Title1.jpg");
 }
 
 TitleScreen::~TitleScreen(){
 
-delete pBackground_;
-pBackground_ = 0;
+images_.Release( pBackground_ );
 }
 
 void TitleScreen::Update( double dt, const Gdiplus::PointF* cursorPos){
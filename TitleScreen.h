@@ -10,7 +10,7 @@ class BackBuffer;
 class TitleScreen : public Mode {
 public:
 
-TitleScreen(unsigned int& nextMode, unsigned int previousMode, unsigned int id, BackBuffer* bb);
+TitleScreen(unsigned int& nextMode, unsigned int previousMode, unsigned int id, ImageCache& images, BackBuffer* bb);
 virtual ~TitleScreen();
 
 virtual void Update( double dt, const Gdiplus::PointF* cursorPos);
@@ -25,7 +25,7 @@ virtual void RMBDown(const Gdiplus::PointF* cursorPos);
 virtual void Wheel(short zDelta, Gdiplus::PointF* mousePos);
 
 private:
-    Gdiplus::Image* pBackground_;
+    Gdiplus::Bitmap* pBackground_;
 
 };
 
@@ -1,9 +1,7 @@
 // Utility.cpp
 #include "Utility.h"
-#include <deque>
 #include <algorithm>
 #include <limits>
-#include "Speller.h"
 using namespace std;
 
 bool ltwstr:: operator()(const std::wstring s1, std::wstring s2) const
@@ -111,6 +109,21 @@ wchar_t ToLower( wchar_t c, bool stripDiacritic, const std::locale loc ){
 
 
 
+wstring ApplySpellingOptions( const wstring& s, bool removeDiacritics, bool removeCapitals ){
+    if( removeDiacritics ){
+        if( removeCapitals ){
+            return ToLower( s, true ); // lose caps and diacritics
+        }
+        return RemoveDiacritics(s); // keep caps but lose diacritics
+    }
+    
+    if( removeCapitals ){ // keep diacritics but lose caps
+        return ToLower( s );
+    }
+    
+    return s; // keep diacritics and caps
+}
+
 wchar_t RemoveDiacritic( const wchar_t c ){
     switch(c){
         case L'':
@@ -231,39 +244,153 @@ wstring RemoveDiacritics( const wstring s ){
 //template <typename T>
 //static bool deleteAll( T* theElement ) { delete theElement; return true; }
 
+// Bit-parallel string comparisons
+unsigned int CountBits( BitVector v ){
+    unsigned int count = 0;
+    for( ; v; v &= v - 1 )
+        ++count;
+    return count;
+}
+
+LetterMasks::LetterMasks( const wstring& s )
+: length_(s.length()) {
+    fill( narrow_, narrow_ + 256, 0 );
+    for( size_t i = 0; i < s.length() && i < BITVECTORLENGTH; ++i ){
+        BitVector bit = BitVector(1) << i;
+        if( s[i] < 256 ){
+            narrow_[ static_cast<size_t>( s[i] ) ] |= bit;
+            continue;
+        }
+        vector< pair<wchar_t, BitVector> >::iterator iter = wide_.begin();
+        while( iter != wide_.end() && iter->first != s[i] )
+            ++iter;
+        if( iter == wide_.end() )
+            wide_.push_back( make_pair( s[i], bit ) );
+        else
+            iter->second |= bit;
+    }
+}
+
+BitVector LetterMasks::operator()( wchar_t c ) const {
+    if( c < 256 )
+        return narrow_[ static_cast<size_t>( c ) ];
+    for( vector< pair<wchar_t, BitVector> >::const_iterator iter = wide_.begin(); iter != wide_.end(); ++iter ){
+        if( iter->first == c )
+            return iter->second;
+    }
+    return 0;
+}
+
+size_t LetterMasks::Length() const {
+    return length_;
+}
+
+unsigned int EditDistance( const wstring& a, const wstring& b ){
+    if( a.length() <= BITVECTORLENGTH )
+        return EditDistance( LetterMasks(a), b );
+    
+    // Too long for a BitVector - one row of the table at a time.
+    vector<unsigned int> row( a.length() + 1 );
+    for( size_t i = 0; i <= a.length(); ++i )
+        row[i] = i;
+    for( size_t j = 1; j <= b.length(); ++j ){
+        unsigned int diagonal = row[0];
+        row[0] = j;
+        for( size_t i = 1; i <= a.length(); ++i ){
+            unsigned int above = row[i];
+            row[i] = min( min( row[i] + 1, row[i-1] + 1 ), diagonal + ( a[i-1] == b[j-1] ? 0 : 1 ) );
+            diagonal = above;
+        }
+    }
+    return row[ a.length() ];
+}
+
+// Myers (1999), in Hyyro's form: the columns of the table are kept as vertical +1/-1 deltas.
+unsigned int EditDistance( const LetterMasks& a, const wstring& b ){
+    size_t n = a.Length();
+    if( n == 0 )
+        return b.length();
+    BitVector last = BitVector(1) << ( n - 1 );
+    BitVector plus = ~BitVector(0); // Vertical +1 deltas
+    BitVector minus = 0;            // Vertical -1 deltas
+    unsigned int distance = n;
+    for( wstring::const_iterator iter = b.begin(); iter != b.end(); ++iter ){
+        BitVector eq = a( *iter );
+        BitVector xv = eq | minus;
+        BitVector xh = ( ( ( eq & plus ) + plus ) ^ plus ) | eq;
+        BitVector hPlus = minus | ~( xh | plus );
+        BitVector hMinus = plus & xh;
+        if( hPlus & last )
+            ++distance;
+        else if( hMinus & last )
+            --distance;
+        hPlus = ( hPlus << 1 ) | 1; // Top row of the table rises by one each letter
+        hMinus <<= 1;
+        plus = hMinus | ~( xv | hPlus );
+        minus = hPlus & xv;
+    }
+    return distance;
+}
+
 // FixedQueue
 FixedQueue::FixedQueue(size_t maxSize, bool unique)
-: maxSize_(maxSize), unique_(unique)
+: ring_(maxSize), head_(0), count_(0), maxSize_(maxSize), unique_(unique)
 {}
 
-unsigned int FixedQueue::Add(unsigned int newItem){
-    if( maxSize_ == 0 ) return 0; //Don't add anything if size is zero.
+bool FixedQueue::Add(unsigned int newItem, unsigned int& evicted){
+    if( maxSize_ == 0 ) return false; //Don't add anything if size is zero.
     
     if(unique_ && IsInList(newItem) ) // Nothing added if item is already in list and only unique values allowed.
-        return 0;
+        return false;
     
-    queue_.push_front(newItem); // Add value.
+    bool full = ( count_ == maxSize_ );
+    if( full )
+        evicted = Pop(); // make room, passing back the value leaving the queue.
     
-    if( queue_.size() > maxSize_ ){
-        unsigned int lastValue = queue_.back();
-        queue_.pop_back();
-        return lastValue; // return value leaving queue.
-    }
-    
-    return 0; // no value to return
+    Push(newItem); // Add value.
+    return full;
+}
+
+void FixedQueue::Clear(){
+    head_ = 0;
+    count_ = 0;
+    counts_.clear();
 }
 
-bool FixedQueue::IsInList(unsigned int newItem){
-    return ( find(queue_.begin(), queue_.end(), newItem) != queue_.end() );
+bool FixedQueue::IsInList(unsigned int searchItem) const{
+    return searchItem < counts_.size() && counts_[searchItem] > 0;
 }
 
 void FixedQueue::ChangeSize(size_t newSize ){
     if( maxSize_ == newSize ) return;
-    if( maxSize_ > newSize )
-        while( queue_.size() > newSize )
-            queue_.pop_back();
+    
+    while( count_ > newSize ) // Drop the oldest values that no longer fit.
+        Pop();
+    
+    // Lay the remaining values out from the start of a new ring, oldest first.
+    vector<unsigned int> newRing(newSize);
+    for( size_t i = 0; i < count_; ++i )
+        newRing[i] = ring_[(head_ + i) % maxSize_];
+    ring_.swap(newRing);
+    head_ = 0;
     maxSize_ = newSize;
+}
+
+void FixedQueue::Push(unsigned int item){
+    ring_[(head_ + count_) % maxSize_] = item;
+    ++count_;
     
+    if( item >= counts_.size() )
+        counts_.resize(item + 1, 0);
+    ++counts_[item];
+}
+
+unsigned int FixedQueue::Pop(){
+    unsigned int item = ring_[head_];
+    head_ = (head_ + 1) % maxSize_;
+    --count_;
+    --counts_[item];
+    return item;
 }
 
 bool SelectionID::operator==(const unsigned int& id) const{
@@ -282,70 +409,6 @@ int LevelWeighting( const int level ){
     return -50;                     // 15+
 }
 
-int FewestAttempts( const IDList& wordIDs, const Speller& speller ){
-    if( wordIDs.empty() ) { return 0; }
-    
-    int fewest = INT_MAX; // Set to highest possible value.
-    
-    for( IDList::const_iterator iter = wordIDs.begin();
-         iter != wordIDs.end();
-         ++iter ){
-        int attempts = speller.GetWordAttempts(*iter);    
-        if( attempts < fewest )
-            fewest = attempts;
-    }
-    return fewest;
-}
-
-/*
-The Weighting Calculator works as follows:
-1) From the list of word IDs currently being used by the Mode, find the fewest number of attempts
-by the Speller.  This might be zero.
-2) Subtract 1 from this number.  This is the "attemptsDeduction".  It might be -1.  The purpose of attemptsDeduction
-is to "drag" all attempts equally so that the smallest #attempts is 1.
-3) Going through the list of word IDs, create a Selection ID for populating the WorkingList that will
-be used by the Mode.  Default values are the word ID, enabled = true and a temporary Weighting calculated thus:
-    MULTIPLY:
-    (a)the speller's no. of attempts for THIS word (minus the "attemptsDeduction" - which might increase
-    the value by 1 if attemptsDeduction is -1)
-    BY
-    b) the basic LevelWeighting for the speller's current Level for THIS word. (the LevelWeighting is set
-    in the similarly named function).
-4) Once done for all words, the lowest value from step 3 is taken and reduced by one.  This "lowestWeighting" is
-used to "drag" all weights equally so that the smallest final weight is 1.
-
-The workingList of ids and weights, plus the total weight of all words, is stored in the referenced parameters.
-*/
-void WeightingCalculator( const IDList& wordIDs, const Speller& speller, WorkingList& workingList,
-                          unsigned int& totalWeighting ){
-    int attemptsDeduction = FewestAttempts( wordIDs, speller ) - 1;
-    
-    int lowestWeighting = INT_MAX; // Set to highest possible value.
-    
-    for( IDList::const_iterator iter = wordIDs.begin();
-        iter != wordIDs.end();
-        ++iter ){   
-        SelectionID sid;
-        sid.id_ = *iter;
-        sid.enabled_ = true;
-        sid.weighting_ = ( speller.GetWordAttempts( *iter ) - attemptsDeduction ) 
-                          *
-                         (LevelWeighting( speller.GetWordLevel( *iter ) ) );
-        workingList.push_back( sid );
-        if( sid.weighting_ < lowestWeighting )
-            lowestWeighting = sid.weighting_;
-    }
-    
-    --lowestWeighting; // need to do this to prevent the weight adjustment reducing a weight to zero.
-    totalWeighting = 0;
-    for( WorkingList::iterator iter = workingList.begin();
-         iter != workingList.end();
-         ++iter ){
-        iter->weighting_ -= lowestWeighting; // adjust the weighting
-        totalWeighting += iter->weighting_; // total up the final weightings.
-    }
-}
-
 Gdiplus::Color GetFadeColour( const Gdiplus::Color& start, const Gdiplus::Color& dest, double ratio ){
     BYTE rPen = start.GetRed();
     BYTE gPen = start.GetGreen();
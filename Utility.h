@@ -7,13 +7,9 @@
 #include <gdiplus.h>
 #include <string>
 #include <locale>
-#include <deque>
 #include <vector>
 #include "Definitions.h"
 
-// Forward declaration
-class Speller;
-
 // UNUSED?
 // std::wstring doesn't appear to have built-in less than comparison, so this does
 // the job required by std::map.
@@ -49,32 +45,66 @@ wchar_t ToUpper( wchar_t c, bool stripDiacritic = false, const std::locale loc =
 std::wstring ToLower( std::wstring s, bool stripDiacritic = false, const std::locale loc = std::locale() );
 wchar_t ToLower( wchar_t c, bool stripDiacritic = false, const std::locale loc = std::locale() );
 
+// Applies a speller's auto diacritics / auto capitals options to a string, as used when comparing spellings.
+std::wstring ApplySpellingOptions( const std::wstring& s, bool removeDiacritics, bool removeCapitals );
+
+// Bit vectors with one bit per letter of a short string, for bit-parallel string comparisons.
+typedef unsigned long long BitVector;
+const std::size_t BITVECTORLENGTH = 64; // Longest string a BitVector can describe.
+
+unsigned int CountBits( BitVector v );
+
+// Gives the positions of each letter in a string (of up to BITVECTORLENGTH letters) as a BitVector.
+class LetterMasks{
+public:
+    explicit LetterMasks( const std::wstring& s );
+    BitVector operator()( wchar_t c ) const;
+    std::size_t Length() const;
+
+private:
+    BitVector narrow_[256];
+    std::vector< std::pair<wchar_t, BitVector> > wide_; // Rare letters outside Latin-1
+    std::size_t length_;
+};
+
+// Levenshtein distance.  Uses Myers' bit-parallel method when a is short enough, otherwise the usual table.
+unsigned int EditDistance( const std::wstring& a, const std::wstring& b );
+unsigned int EditDistance( const LetterMasks& a, const std::wstring& b ); // a must be no longer than BITVECTORLENGTH
+
 template <typename T>
 static bool deleteAll( T* theElement )
  { delete theElement; return true; }
  
 // The FixedQueue keeps a list of integers (could be made into a template) up to a fixed size
 // then starts removing the oldest.
+// Stored in a ring buffer, with a count per value for membership, so Add, eviction and IsInList
+// are all constant time.  Intended for small, dense values such as indices into a list.
 class FixedQueue{
 public:
     FixedQueue(std::size_t maxSize, bool unique = true);
     
-    unsigned int Add(unsigned int newItem);
+    // Returns true if the oldest item had to leave the queue, and passes it back in evicted.
+    bool Add(unsigned int newItem, unsigned int& evicted);
     void Clear();
-    bool IsInList(unsigned int searchItem);
+    bool IsInList(unsigned int searchItem) const;
     void ChangeSize(size_t newSize);
 
 private:
-    std::deque<unsigned int> queue_;
+    void Push(unsigned int item);  // Adds item at the back of the ring; assumes there is room.
+    unsigned int Pop();            // Removes and returns the oldest item; assumes queue not empty.
+
+    std::vector<unsigned int> ring_;   // storage for the queue, sized to maxSize_.
+    std::size_t              head_;    // position of oldest item in ring_.
+    std::size_t              count_;   // number of items currently queued.
+    std::vector<unsigned int> counts_; // how many times each value is queued, indexed by value.
     std::size_t              maxSize_; // maximum size of queue.
     bool                     unique_; // if true, stored values must be unique.
 
 };
 
-// SelectionID combines a word id, selection weighting and simple check if disabled.
+// SelectionID combines a word id and simple check if disabled.  Weights are kept by WeightingModel.
 struct SelectionID{
     int id_;        // id of word
-    int weighting_;    // likelihood of selection
     bool enabled_;  // whether the item can be selected or not
     
     bool operator==(const unsigned int& id) const; // Checks if id exists.  Used as predicate.
@@ -83,13 +113,8 @@ struct SelectionID{
 
 typedef std::vector<SelectionID> WorkingList;
 
-// These GLOBAL FUNCTIONS are used in the calculations for Random Weighting.
+// Used in the calculations for Random Weighting (see WeightingModel).
 int LevelWeighting( const int level ); // converts a spelling record level into an initial weighting.
-int FewestAttempts( const IDList& wordIDs, const Speller& speller ); // Finds the least number of attempts
-                                                         // the Speller has for the supplied list of word IDs.
-                                                         
-// Populates the supplied workingList with Weighted values.
-void WeightingCalculator(const IDList& wordIDs, const Speller& speller, WorkingList& workingList, unsigned int& totalWeighting );
 
 //Supply a start and destination colour, and a ratio of how far between them, and this function
 // returns a colour partway (matching the ratio) between them.
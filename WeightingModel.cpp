@@ -0,0 +1,213 @@
+// WeightingModel.cpp
+
+#include "WeightingModel.h"
+#include "Speller.h"
+#include "Random.h"
+
+using namespace std;
+
+/*
+The weighting works as follows:
+1) From the list of word IDs currently being used by the Mode, find the fewest number of attempts
+by the Speller.  This might be zero.
+2) Subtract 1 from this number.  This is the "attemptsDeduction".  It might be -1.  The purpose of attemptsDeduction
+is to "drag" all attempts equally so that the smallest #attempts is 1.
+3) Each word is given a temporary Weighting calculated thus:
+    MULTIPLY:
+    (a)the speller's no. of attempts for THIS word (minus the "attemptsDeduction" - which might increase
+    the value by 1 if attemptsDeduction is -1)
+    BY
+    b) the basic LevelWeighting for the speller's current Level for THIS word. (the LevelWeighting is set
+    in the similarly named function).
+4) The lowest value from step 3 is taken and reduced by one.  This "lowestWeighting" is
+used to "drag" all weights equally so that the smallest final weight is 1.
+
+So weight = attempts*level - attemptsDeduction*level - lowestWeighting.  The first two terms, and a count of
+enabled words for the last, are kept in Fenwick trees, so changing one word is O(log n) and the two deductions
+are applied as the trees are read.  A disabled word is taken out of the trees, so it has no weight at all.
+As LevelWeighting only has a handful of values, the lowest step 3 value is found from the fewest (positive
+weightings) or most (negative weightings) attempts in each LevelWeighting group, without visiting every word.
+*/
+
+WeightingModel::WeightingModel()
+: weighted_(false), topStep_(0), sumAttemptsByLevel_(0), sumLevelWeights_(0), sumEnabled_(0),
+  attemptsDeduction_(0), lowestWeighting_(0)
+{}
+
+void WeightingModel::Build( const WorkingList& list, const Speller& speller, bool weighted ){
+    Clear();
+    weighted_ = weighted;
+    
+    size_t size = list.size();
+    ids_.resize( size );
+    attempts_.resize( size );
+    levelWeights_.resize( size );
+    enabled_.assign( size, true );
+    attemptsByLevelTree_.assign( size + 1, 0 );
+    levelWeightTree_.assign( size + 1, 0 );
+    enabledTree_.assign( size + 1, 0 );
+    topStep_ = 1;
+    while( topStep_ * 2 <= size )
+        topStep_ *= 2;
+    
+    for( size_t i = 0; i < size; ++i ){
+        ids_[i] = list[i].id_;
+        attempts_[i] = speller.GetWordAttempts( ids_[i] );
+        levelWeights_[i] = LevelWeighting( speller.GetWordLevel( ids_[i] ) );
+        AddToHistograms( attempts_[i], levelWeights_[i] );
+        
+        long long attemptsByLevel = static_cast<long long>( attempts_[i] ) * levelWeights_[i];
+        sumAttemptsByLevel_ += attemptsByLevel;
+        sumLevelWeights_ += levelWeights_[i];
+        ++sumEnabled_;
+        attemptsByLevelTree_[i + 1] += attemptsByLevel;
+        levelWeightTree_[i + 1] += levelWeights_[i];
+        enabledTree_[i + 1] += 1;
+        // Linear build: push each node's total up to its parent.
+        size_t parent = ( i + 1 ) + ( ( i + 1 ) & ( 0 - ( i + 1 ) ) );
+        if( parent <= size ){
+            attemptsByLevelTree_[parent] += attemptsByLevelTree_[i + 1];
+            levelWeightTree_[parent] += levelWeightTree_[i + 1];
+            enabledTree_[parent] += enabledTree_[i + 1];
+        }
+    }
+    UpdateOffsets();
+}
+
+void WeightingModel::Clear(){
+    ids_.clear();
+    attempts_.clear();
+    levelWeights_.clear();
+    enabled_.clear();
+    attemptsByLevelTree_.clear();
+    levelWeightTree_.clear();
+    enabledTree_.clear();
+    topStep_ = 0;
+    sumAttemptsByLevel_ = sumLevelWeights_ = sumEnabled_ = 0;
+    attemptCounts_.clear();
+    levelGroups_.clear();
+    attemptsDeduction_ = lowestWeighting_ = 0;
+}
+
+void WeightingModel::Refresh( size_t index, const Speller& speller ){
+    if( index >= ids_.size() ) return;
+    
+    int attempts = speller.GetWordAttempts( ids_[index] );
+    int levelWeight = LevelWeighting( speller.GetWordLevel( ids_[index] ) );
+    if( attempts == attempts_[index] && levelWeight == levelWeights_[index] )
+        return; // nothing changed
+    
+    RemoveFromHistograms( attempts_[index], levelWeights_[index] );
+    AddToHistograms( attempts, levelWeight );
+    if( enabled_[index] ){
+        AddToTrees( index,
+                    static_cast<long long>( attempts ) * levelWeight - static_cast<long long>( attempts_[index] ) * levelWeights_[index],
+                    levelWeight - levelWeights_[index], 0 );
+    }
+    attempts_[index] = attempts;
+    levelWeights_[index] = levelWeight;
+    UpdateOffsets();
+}
+
+void WeightingModel::SetEnabled( size_t index, bool enabled ){
+    if( index >= ids_.size() || enabled_[index] == enabled ) return;
+    
+    long long sign = enabled ? 1 : -1;
+    AddToTrees( index, sign * attempts_[index] * levelWeights_[index], sign * levelWeights_[index], sign );
+    enabled_[index] = enabled;
+}
+
+long long WeightingModel::Total() const{
+    if( !weighted_ )
+        return sumEnabled_;
+    return sumAttemptsByLevel_ - attemptsDeduction_ * sumLevelWeights_ - lowestWeighting_ * sumEnabled_;
+}
+
+long long WeightingModel::Weight( size_t index ) const{
+    if( index >= ids_.size() || !enabled_[index] ) return 0;
+    if( !weighted_ ) return 1;
+    return ( attempts_[index] - attemptsDeduction_ ) * levelWeights_[index] - lowestWeighting_;
+}
+
+size_t WeightingModel::Find( long long target ) const{
+    // Walk down the trees, skipping whole blocks whose weight is still short of the target.
+    size_t pos = 0;
+    for( size_t step = topStep_; step > 0; step /= 2 ){
+        size_t next = pos + step;
+        if( next > ids_.size() )
+            continue;
+        long long blockWeight = enabledTree_[next]; // Unweighted, every enabled word weighs 1
+        if( weighted_ ){
+            blockWeight = attemptsByLevelTree_[next] - attemptsDeduction_ * levelWeightTree_[next]
+                          - lowestWeighting_ * enabledTree_[next];
+        }
+        if( blockWeight < target ){
+            pos = next;
+            target -= blockWeight;
+        }
+    }
+    return pos; // tree position pos+1, so list index pos.
+}
+
+size_t WeightingModel::Select( RandomStream& random ) const{
+    return Find( static_cast<long long>( random.Below( static_cast<RandomStream::result_type>( Total() ) ) ) + 1 );
+}
+
+size_t WeightingModel::Size() const{
+    return ids_.size();
+}
+
+void WeightingModel::AddToTrees( size_t index, long long attemptsByLevel, long long levelWeight, long long enabled ){
+    sumAttemptsByLevel_ += attemptsByLevel;
+    sumLevelWeights_ += levelWeight;
+    sumEnabled_ += enabled;
+    for( size_t i = index + 1; i < attemptsByLevelTree_.size(); i += ( i & ( 0 - i ) ) ){
+        attemptsByLevelTree_[i] += attemptsByLevel;
+        levelWeightTree_[i] += levelWeight;
+        enabledTree_[i] += enabled;
+    }
+}
+
+void WeightingModel::AddToHistograms( int attempts, int levelWeight ){
+    ++attemptCounts_[attempts];
+    ++levelGroups_[levelWeight][attempts];
+}
+
+void WeightingModel::RemoveFromHistograms( int attempts, int levelWeight ){
+    Remove( attemptCounts_, attempts );
+    map<int, Histogram>::iterator group = levelGroups_.find( levelWeight );
+    if( group == levelGroups_.end() ) return;
+    Remove( group->second, attempts );
+    if( group->second.empty() )
+        levelGroups_.erase( group );
+}
+
+void WeightingModel::Remove( Histogram& h, int value ){
+    Histogram::iterator iter = h.find( value );
+    if( iter == h.end() ) return;
+    if( --(iter->second) == 0 )
+        h.erase( iter );
+}
+
+void WeightingModel::UpdateOffsets(){
+    if( attemptCounts_.empty() ){
+        attemptsDeduction_ = lowestWeighting_ = 0;
+        return;
+    }
+    attemptsDeduction_ = attemptCounts_.begin()->first - 1;
+    
+    bool first = true;
+    long long lowest = 0;
+    for( map<int, Histogram>::const_iterator group = levelGroups_.begin();
+         group != levelGroups_.end();
+         ++group ){
+        // Positive weightings are lowest with the fewest attempts; negative ones with the most.
+        int attempts = ( group->first >= 0 ) ? group->second.begin()->first : group->second.rbegin()->first;
+        long long weighting = ( attempts - attemptsDeduction_ ) * group->first;
+        if( first || weighting < lowest ){
+            lowest = weighting;
+            first = false;
+        }
+    }
+    lowestWeighting_ = lowest - 1; // need to do this to prevent the weight adjustment reducing a weight to zero.
+}
@@ -0,0 +1,71 @@
+// WeightingModel.h
+// Keeps the selection weights for a MiniSpell working list up to date as the speller's records change,
+// and picks words in proportion to those weights.
+
+#ifndef WEIGHTINGMODEL_H
+#define WEIGHTINGMODEL_H
+
+#include <vector>
+#include <map>
+#include <cstddef>
+#include "Utility.h"
+
+class Speller;
+class RandomStream;
+
+class WeightingModel{
+public:
+    WeightingModel();
+    
+    // Calculates weights for every word in list, using the speller's records.
+    // If weighted is false, every word has a weight of 1.
+    void Build( const WorkingList& list, const Speller& speller, bool weighted );
+    void Clear();
+    
+    // Re-reads the record of the word at index after it has changed, updating only what depends on it.
+    void Refresh( std::size_t index, const Speller& speller );
+    // A disabled word has no weight, so Select never returns it.  Its record still counts towards the
+    // deductions below, so the enabled words keep the weights they would have with it enabled.
+    void SetEnabled( std::size_t index, bool enabled );
+    
+    long long Total() const;                      // Sum of all weights.
+    long long Weight( std::size_t index ) const;  // Current weight of the word at index.  0 if disabled.
+    std::size_t Find( long long target ) const;   // Index of the word whose share of [1, Total()] holds target.
+    std::size_t Select( RandomStream& random ) const; // Weighted random index.  Some word must be enabled.
+    std::size_t Size() const;
+
+private:
+    typedef std::map<int, unsigned int> Histogram; // value -> number of words with that value
+    
+    void AddToTrees( std::size_t index, long long attemptsByLevel, long long levelWeight, long long enabled );
+    void AddToHistograms( int attempts, int levelWeight );
+    void RemoveFromHistograms( int attempts, int levelWeight );
+    static void Remove( Histogram& h, int value );
+    void UpdateOffsets();
+    
+private:
+    bool weighted_;
+    std::vector<int> ids_;          // word id for each index
+    std::vector<int> attempts_;     // attempts for each index
+    std::vector<int> levelWeights_; // LevelWeighting for each index
+    std::vector<bool> enabled_;     // whether each index can be selected
+    
+    // Fenwick trees (1-based) over attempts*levelWeight, levelWeight and enabled words, so that a weight
+    // change is O(log n) and prefix sums of the final weights can be found without a full walk.
+    // Disabled words are left out of the trees.
+    std::vector<long long> attemptsByLevelTree_;
+    std::vector<long long> levelWeightTree_;
+    std::vector<long long> enabledTree_;
+    std::size_t topStep_;           // largest power of two <= size, for searching the trees.
+    long long sumAttemptsByLevel_;
+    long long sumLevelWeights_;
+    long long sumEnabled_;
+    
+    Histogram attemptCounts_;                 // for the fewest attempts
+    std::map<int, Histogram> levelGroups_;    // attempts histogram for each distinct LevelWeighting
+    
+    long long attemptsDeduction_;   // fewest attempts - 1
+    long long lowestWeighting_;     // lowest weight before adjustment - 1
+};
+
+#endif // WEIGHTINGMODEL_H
@@ -3,6 +3,8 @@
 #include <map>
 #include <algorithm>
 #include <functional> //needed for equal_to
+#include <climits>
+#include <thread>
 
 #include "Speller.h"
 #include "ScreenPrinter.h"
@@ -81,7 +83,7 @@ bool Breakdown::operator<( const Breakdown& rhs ) const{
 
 // SPELLING
 Spelling::Spelling(unsigned int id, std::wstring spelling)
-    : id_(id), spelling_(spelling)
+    : id_(id), spelling_(spelling), normalisedMask_(0)
     {
         breakdownList_.clear();
     }
@@ -103,6 +105,19 @@ wstring Spelling::GetSpelling() const {
     return spelling_;
 }
 
+const wstring& Spelling::GetNormalised( bool removeDiacritics, bool removeCapitals, bool reversed ) const {
+    if( !removeDiacritics && !removeCapitals && !reversed )
+        return spelling_;
+    unsigned int index = ( removeDiacritics ? 4 : 0 ) + ( removeCapitals ? 2 : 0 ) + ( reversed ? 1 : 0 );
+    if( !( normalisedMask_ & ( 1u << index ) ) ){
+        normalised_[index] = ApplySpellingOptions( spelling_, removeDiacritics, removeCapitals );
+        if( reversed )
+            reverse( normalised_[index].begin(), normalised_[index].end() );
+        normalisedMask_ |= 1u << index;
+    }
+    return normalised_[index];
+}
+
 size_t Spelling::GetBreakdownListSize() const{
     return breakdownList_.size();
 }
@@ -133,6 +148,10 @@ bool Word::IsConfusable() const {
     return confusable_;
 }
 
+void Word::SetConfusable(bool confusable){
+    confusable_ = confusable;
+}
+
 unsigned int Word::GetDifficulty() const {
     return difficulty_;
 }
@@ -203,17 +222,88 @@ bool Word::SoundOnlyOK() const {
 AnalysedLetter::AnalysedLetter(wchar_t letter, LetterStatus status)
 : letter_(letter), status_(status){}
 
+//PACKED ANALYSIS
+namespace {
+    enum PackedFormat{ NARROWLETTERS = 1, WIDELETTERS = 2 }; // First byte of a PackedAnalysis
+}
+
+void PackAnalysis( const AnalysedLetters& letters, PackedAnalysis& packed ){
+    size_t n = letters.size();
+    bool wide = false;
+    for( AWConstIter iter = letters.begin(); iter != letters.end(); ++iter )
+        if( iter->letter_ > 0xFF )
+            wide = true;
+    packed.clear();
+    packed.reserve( 1 + 3 + (n + 1) / 2 + ( wide ? 2 * n : n ) );
+    packed.push_back( wide ? WIDELETTERS : NARROWLETTERS );
+    // Count
+    size_t count = n;
+    do{
+        unsigned char b = count & 0x7F;
+        count >>= 7;
+        packed.push_back( count ? b | 0x80 : b );
+    } while( count );
+    // Statuses
+    for( size_t i = 0; i < n; i += 2 ){
+        unsigned char b = static_cast<unsigned char>( letters[i].status_ );
+        if( i + 1 < n )
+            b |= static_cast<unsigned char>( letters[i + 1].status_ ) << 4;
+        packed.push_back( b );
+    }
+    // Letters
+    for( AWConstIter iter = letters.begin(); iter != letters.end(); ++iter ){
+        packed.push_back( iter->letter_ & 0xFF );
+        if( wide )
+            packed.push_back( ( iter->letter_ >> 8 ) & 0xFF );
+    }
+}
+
+bool UnpackAnalysis( const unsigned char* data, std::size_t size, AnalysedLetters& letters ){
+    letters.clear();
+    if( size == 0 || ( data[0] != NARROWLETTERS && data[0] != WIDELETTERS ) )
+        return false;
+    size_t letterSize = data[0] == WIDELETTERS ? 2 : 1;
+    size_t pos = 1;
+    // Count
+    size_t n = 0;
+    for( unsigned int shift = 0; ; shift += 7 ){
+        if( pos == size || shift > 28 )
+            return false;
+        n |= static_cast<size_t>( data[pos] & 0x7F ) << shift;
+        if( !( data[pos++] & 0x80 ) )
+            break;
+    }
+    if( size - pos != (n + 1) / 2 + n * letterSize )
+        return false;
+    const unsigned char* statuses = data + pos;
+    const unsigned char* letter = statuses + (n + 1) / 2;
+    for( size_t i = 0; i < n; ++i, letter += letterSize ){
+        unsigned int status = ( statuses[i / 2] >> ( i % 2 ? 4 : 0 ) ) & 0x0F;
+        if( status > ThreeAwayWrongB ){
+            letters.clear();
+            return false;
+        }
+        wchar_t c = letter[0];
+        if( letterSize == 2 )
+            c |= static_cast<wchar_t>( letter[1] ) << 8;
+        letters.push_back( AnalysedLetter( c, static_cast<LetterStatus>( status ) ) );
+    }
+    return true;
+}
+
 //ANALYSEDWORD
 AnalysedWord::AnalysedWord(unsigned int numLetters)
-: originalLength_(numLetters), score_(-1), analysisState_(NA)
-{}
+: stats_(), statsValid_(false), originalLength_(numLetters), analysisState_(NA), spellingID_(0)
+{
+    stats_.score_ = -1;
+}
 
 bool AnalysedWord::SortOrder(const AnalysedWord &rhs){
-    if( score_ != rhs.score_ )
-        return score_ > rhs.score_;
-    if( averageLinkSize_ != rhs.averageLinkSize_ )
-        return averageLinkSize_ > rhs.averageLinkSize_;
-        return largestLink_ > rhs.largestLink_;
+    if( stats_.score_ != rhs.stats_.score_ )
+        return stats_.score_ > rhs.stats_.score_;
+    if( stats_.averageLinkSize_ != rhs.stats_.averageLinkSize_ )
+        return stats_.averageLinkSize_ > rhs.stats_.averageLinkSize_;
+        return stats_.largestLink_ > rhs.stats_.largestLink_;
         
     //1.	The highest Score is a better spelling.  If equal: 
     //2.	The largest average link length is better.  If equal:
@@ -226,38 +316,42 @@ bool AnalysedWord::SortOrder(const AnalysedWord &rhs){
 
 void AnalysedWord::Add(const AnalysedLetter &al){
     word_.push_back(al);
+    statsValid_ = false;
 }
 
 void AnalysedWord::Add(wchar_t letter, LetterStatus status){
     word_.push_back(AnalysedLetter(letter, status));
+    statsValid_ = false;
 }
 
 void AnalysedWord::Clear(){
     word_.clear();
+    statsValid_ = false;
 }
 
 // Variables accessors
 unsigned int AnalysedWord::LengthDifference() const{
-    return lengthDifference_;
+    return stats_.lengthDifference_;
 }
 
 double AnalysedWord::AverageLinkSize() const{
-    return averageLinkSize_;
+    return stats_.averageLinkSize_;
 }
 
 unsigned int AnalysedWord::LargestLink() const{
-    return largestLink_;
+    return stats_.largestLink_;
 }
 
 unsigned int AnalysedWord::NumLinks() const{
-    return numLinks_;
+    return stats_.numLinks_;
 }
 
 int AnalysedWord::Score() const{
-    return score_;
+    return stats_.score_;
 }
 
 AnalysedLetter& AnalysedWord::operator[]( unsigned int i ){
+    statsValid_ = false; // The letter may be changed
     if( i >= word_.size() || i < 0 )
         return AnalysedLetter(L'', Null);
     return word_[i];
@@ -265,10 +359,12 @@ AnalysedLetter& AnalysedWord::operator[]( unsigned int i ){
 
 void AnalysedWord::RemoveNull(){
     word_.erase( remove_if(word_.begin(), word_.end(), IsNull() ), word_.end() );
+    statsValid_ = false;
 }
 
 void AnalysedWord::Reverse(){
     reverse( word_.begin(), word_.end() );
+    statsValid_ = false; // A final link may now come first
 }
 
 bool AnalysedWord::empty() const{
@@ -281,10 +377,72 @@ size_t AnalysedWord::size() const{
 
 
 
+namespace {
+    // Pairs up adjacent runs of Missing and Wrong letters, as the score and error rules do.  Whenever a
+    // letter of a different status follows runs of both, the shorter run is added to shorter_ and the
+    // longer to longer_.
+    class MissingWrongRuns{
+    public:
+        MissingWrongRuns()
+        : shorter_(0), longer_(0), countA_(0), countB_(0), currentType_(Null), lastType_(Null)
+        {}
+        
+        void Next( LetterStatus status ){
+            if( currentType_ != status ){ // If the type is different to the type parsed previously...
+                lastType_ = currentType_;  // ...make a copy of the previous type...
+                currentType_ = status;     // ...and store the new type.
+                Pair();
+                // TODO: Is it possible to have Missing - Wrong - Missing or similar?
+                // That is, to have a string of missing, followed by wrong, followed by missing, or vice versa?
+                if( currentType_ != Wrong && currentType_ != Missing ){
+                    countA_ = 0;
+                    countB_ = 0;
+                }
+            }
+            if( currentType_ != lastType_ ){ // This type is different from the type we've parsed previously.
+                if( currentType_ == Wrong ){ // If it's of type Wrong...
+                    if( lastType_ == Missing ) // ...and previous was Missing...
+                        ++countB_;             // ...increase the second counter.
+                    else
+                        ++countA_;             // Otherwise increase the first counter.
+                } else if( currentType_ == Missing ){
+                    if( lastType_ == Wrong )
+                        ++countB_;
+                    else
+                        ++countA_;
+                }
+            }
+        }
+        
+        void Finish(){ // Last check for any final missing/wrong letters
+            Pair();
+        }
+        
+        int shorter_;
+        int longer_;
+        
+    private:
+        void Pair(){ // Has there been a string of Missing and Wrong?
+            if( countA_ > 0 && countB_ > 0 ){
+                shorter_ += min( countA_, countB_ );
+                longer_ += max( countA_, countB_ );
+            }
+        }
+        
+        int countA_;
+        int countB_;
+        LetterStatus currentType_;
+        LetterStatus lastType_;
+    };
+}
+
 void AnalysedWord::CalculateStats(){
-    CalculateScore();
-    CalculateNumLetters();
-    CalculateLinks();
+    Tally( stats_ );
+    statsValid_ = true;
+}
+
+const AnalysisStats& AnalysedWord::Stats() const{
+    return stats_;
 }
 
 int AnalysedWord::NumCorrect() const{
@@ -294,162 +452,98 @@ int AnalysedWord::NumCorrect() const{
 //TODO: Not sure if this definitely works, but it's only used with 2 and 3 letter words currently.
 // Should check it's valid.  It uses similar algorithm to the score calculator.
 int AnalysedWord::NumErrors() const{
+    if( statsValid_ )
+        return stats_.errors_;
+    AnalysisStats stats;
+    Tally( stats );
+    return stats.errors_;
+}
+
+void AnalysedWord::Tally( AnalysisStats& stats ) const{
+    stats = AnalysisStats();
+    
+    // Score: starts at 10 per letter of the original word, less each error.
+    // A string of Missing next to a string of Wrong (a wrong letter in place of the right one) gets 11 back for
+    // each pair, so it costs 9 rather than 20.
+    int total = originalLength_ * 10;
+    MissingWrongRuns scoreRuns;
+    
+    // Errors:
     // Each swapped pair is 1 error.
     // Each three away is 1 error.
     // Each matching pair of missing/wrong (adjacent groups) is 1 error
     // Each extra wrong or missing is 1 error.
-    int errors = 0;
-    int countA = 0;
-    int countB = 0;
-    LetterStatus currentType = Null;
-    LetterStatus lastType = Null;
+    // The first letter of a swapped pair is counted, and the second is paired up instead.
+    MissingWrongRuns errorRuns;
+    bool secondSwapped = false;
     
+    int currentLinkSize = 0;
     for(AWConstIter i = word_.begin(); i != word_.end(); ++i){
-
-        switch( i->status_ ){
-            case Correct:
-            case ThreeAwayMissingF:
-            case ThreeAwayMissingB: 
-            case Missing:
-            case Wrong:{
-                // Do nothing.
-                // Missing and Wrong dealt with elsewhere
-                // Only count ThreeAwayWrong, so the error isn't counted twice.
-                break;
-            }
-            case Swapped:{
-                ++errors;
-                ++i; // advance iterator to skip next swapped
-                break;
-            }
-            
-            case ThreeAwayWrongF:
-            case ThreeAwayWrongB: {
-                ++errors;
-                break;
-            }
-            default:{
-                break;
-            }
-        }//switch
-        if( currentType != i->status_ ){ // If the type is different to the type parsed previously...
-            lastType = currentType;      // ...make a copy of the previous type...
-            currentType = i->status_;    // ...and store the new type.
-            
-            if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
-                errors += (countA > countB ? countA : countB ); // Add the number of the largest group
-            }
-            if( currentType != Wrong && currentType != Missing ){
-                countA = 0;
-                countB = 0;
-            }
-        }
-        if( currentType != lastType ){ // This type is different from the type we've parsed previously.
-            if( currentType == Wrong ){ // If it's of type Wrong...
-                if( lastType == Missing ){ // ...and previous was Missing...
-                    ++countB;              // ...increase the second counter.
-                } else {                   
-                    ++countA;              // Otherwise increase the first counter.
-                }
-            } else if( currentType == Missing ){
-                if( lastType == Wrong ) {
-                    ++countB;
-                } else {
-                    ++countA;
-                }
-            }
-        }  
-    } // for loop
-    // Last check for any final missing/wrong letters
-    if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
-        errors += countA > countB ? countA : countB;
-        countA = 0;
-        countB = 0;
-    }
-    return errors;
-}
-
-void AnalysedWord::CalculateScore(){
-    int total = originalLength_ * 10;
-    
-    int countA = 0;
-    int countB = 0;
-    LetterStatus currentType = Null;
-    LetterStatus lastType = Null;
-    
-    for(AWiter i = word_.begin(); i != word_.end(); ++i){
-
-        switch( i->status_ ){
-            case Correct:
-            case ThreeAwayMissingF:
-            case ThreeAwayMissingB:{
-                // Do nothing.
-                break;
-            }
+        LetterStatus status = i->status_;
+        ++stats.statusCounts_[status];
+        
+        switch( status ){
             case Swapped:{
                 total -= 3;
                 break;
             }
-            
             case ThreeAwayWrongF:
             case ThreeAwayWrongB: {
                 total -= 6;
                 break;
             }
             case Missing:
-            case Wrong:
-            {
+            case Wrong:{
                 total -= 10;
+                break;
             }
             default:{
                 break;
             }
         }//switch
-        if( currentType != i->status_ ){ // If the type is different to the type parsed previously...
-            lastType = currentType;      // ...make a copy of the previous type...
-            currentType = i->status_;    // ...and store the new type.
-            
-            if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
-                if( countA < countB ){
-                    total += (11 * countA);
-                } else {
-                    total += (11*countB);
-                }
-            }
-            // TODO: Is it possible to have Missing - Wrong - Missing or similar?
-            // That is, to have a string of missing, followed by wrong, followed by missing, or vice versa?
-            if( currentType != Wrong && currentType != Missing ){
-                countA = 0;
-                countB = 0;
-            }
+        scoreRuns.Next( status );
+        
+        if( secondSwapped ){
+            secondSwapped = false;
+            errorRuns.Next( status );
         }
-        if( currentType != lastType ){ // This type is different from the type we've parsed previously.
-            if( currentType == Wrong ){ // If it's of type Wrong...
-                if( lastType == Missing ){ // ...and previous was Missing...
-                    ++countB;              // ...increase the second counter.
-                } else {                   
-                    ++countA;              // Otherwise increase the first counter.
-                }
-            } else if( currentType == Missing ){
-                if( lastType == Wrong ) {
-                    ++countB;
-                } else {
-                    ++countA;
-                }
-            }
-        }  
-    } // for loop
-    // Last check for any final missing/wrong letters
-    if( countA > 0 && countB > 0 ){ // Has there been a string of Missing and Wrong?
-        if( countA < countB ){
-            total += (11*countA);
-        } else {
-            total += (11*countB);
+        else if( status == Swapped ){
+            ++stats.errors_;
+            secondSwapped = true;
         }
-        countA = 0;
-        countB = 0;
-    }
-    score_ = total;
+        else{
+            // Only count ThreeAwayWrong, so the error isn't counted twice.
+            if( status == ThreeAwayWrongF || status == ThreeAwayWrongB )
+                ++stats.errors_;
+            errorRuns.Next( status );
+        }
+        
+        // Don't count missing (not in the attempt) and threeawaymissing (already counted as threeawaywrong)
+        if( status == Correct || status == Wrong || status == Swapped ||
+            status == ThreeAwayWrongF || status == ThreeAwayWrongB ){
+            ++stats.attemptLength_;
+        }
+        
+        if( status == Correct ){
+            if( currentLinkSize == 0 ) // No link being counted
+                ++stats.numLinks_;
+            ++currentLinkSize;
+        }
+        else if( currentLinkSize > 0 ){
+            if( currentLinkSize > static_cast<int>( stats.largestLink_ ) )
+                stats.largestLink_ = currentLinkSize;
+            currentLinkSize = 0;
+        }
+    } // for loop
+    scoreRuns.Finish();
+    errorRuns.Finish();
+    
+    stats.score_ = total + 11 * scoreRuns.shorter_;
+    stats.errors_ += errorRuns.longer_;
+    stats.lengthDifference_ = abs(static_cast<int>(stats.attemptLength_) - static_cast<int>(originalLength_));
+    // Avoid divide by zero problems.  Set average to zero in these circumstances.
+    if( stats.numLinks_ != 0 )
+        stats.averageLinkSize_ = static_cast<double>( stats.statusCounts_[Correct] ) / static_cast<double>( stats.numLinks_ );
 }
 
 std::wstring AnalysedWord::GetString() const{
@@ -472,69 +566,13 @@ std::wstring AnalysedWord::GetString() const{
     return s;
 }
 
-std::vector<AnalysedLetter> AnalysedWord::GetAnalysis() const{
+const AnalysedLetters& AnalysedWord::GetAnalysis() const{
     return word_;
 }
 
-void AnalysedWord::CalculateNumLetters(){
-    // Total up number of correct, wrong, swapped and threeawaywrong
-    // Don't count missing (not in the attempt) and threeawaymissing (already counted as threeawaywrong)
-    attemptLength_ = 0;
-    for(AWiter iter = word_.begin(); iter != word_.end(); ++iter ){
-        switch( iter->status_ ){
-            case Correct:
-            case Wrong:
-            case Swapped:
-            case ThreeAwayWrongF:
-            case ThreeAwayWrongB: {
-                ++attemptLength_;
-                break;
-            }
-            default: {
-                break;
-            }
-        }// end switch
-    }// End for
-    
-    // Calculate lengthDifference_
-    lengthDifference_ = abs(static_cast<int>(attemptLength_) - static_cast<int>(originalLength_));
-}
-
-void AnalysedWord::CalculateLinks(){
-    averageLinkSize_ = 0;
-    largestLink_ = 0;
-    numLinks_ = 0;
-    int currentLinkSize = 0;
-    for(AWiter iter = word_.begin(); iter != word_.end(); ++iter ){
-        
-        switch( iter->status_ ){
-            case Correct:{
-                if( currentLinkSize == 0 ){ // No link being counted
-                    ++numLinks_;                    
-                }
-                ++currentLinkSize;
-                break;
-            }
-            default:{
-                if( currentLinkSize > 0 ){
-                    if( currentLinkSize > largestLink_ ){
-                        largestLink_ = currentLinkSize;
-                    }
-                    currentLinkSize = 0;
-                }
-                break;
-            }
-        } // End switch
-    }// End for
-    
-    // Avoid divide by zero problems.  Set average to zero in these circumstances.
-    if( numLinks_ == 0 )
-        averageLinkSize_ = 0;
-    else
-        averageLinkSize_ = static_cast<double>( CountStatus( Correct ) ) / static_cast<double>( numLinks_ ) ;
-}
-
 int AnalysedWord::CountStatus(LetterStatus status) const{
+     if( statsValid_ )
+        return stats_.statusCounts_[status];
      unsigned int countS = 0;
      for(AWConstIter iter = word_.begin(); iter != word_.end(); ++iter ){
         if( iter->status_ == status ){
@@ -566,126 +604,216 @@ bool AnalysedWord::IsBeyondWrong() const{
             analysisState_ == BEYONDWRONG3;
 }
 
+void AnalysedWord::SetSpellingID( unsigned int id ){
+    spellingID_ = id;
+}
+
+unsigned int AnalysedWord::SpellingID() const{
+    return spellingID_;
+}
+
 // SPELLINGANALYSER
 SpellingAnalyser::SpellingAnalyser(const std::wstring& attempt, const Word* word, Speller& speller,
-                     AnalysedWord& analysedWord)
+                     AnalysedWord& analysedWord, Engine engine)
 : attempt_(attempt), pWord_(word), speller_(speller),
   analysedWord_(analysedWord)
 {
     // Compare the attempt with the original spelling
     attCopy_ = ApplyOptionsToString( attempt_ );
-    spelling_ = pWord_->GetMainSpellingString();
-    speCopy_ = ApplyOptionsToString( spelling_ );
-    if( !ExactMatch() ){
-        // Start comparison algorithms
-        vector<AnalysedWord> analyses; // Store results of each analysis
-        // For reverse analysis
-        wstring revAttempt = attempt_;
-        reverse( revAttempt.begin(), revAttempt.end() );
-        wstring revAttemptProcessed = ApplyOptionsToString( revAttempt );
-        wstring revSpelling = spelling_;
-        reverse( revSpelling.begin(), revSpelling.end() );
-        wstring revSpellingProcessed = ApplyOptionsToString( revSpelling );        
-        unsigned int distance;
-        // For each distance ( no. letters in attempt - 2 )
-        for(distance = attempt_.length(); distance >= 2; --distance){
-            analysedWord_.Clear();
-            //Pattern Matching
-            PatternMatching( distance, attCopy_, attempt_, speCopy_, spelling_, analysedWord_ );            
-            // FindSwaps (length of original spelling > 2? letters)
-            if( spelling_.length() > 2 )
-                SwapSearch( analysedWord_ );
-            // ThreeAway (length of original spelling > 3? letters)
-            if( spelling_.length() > 3 )
-                ThreeAwaySearch( analysedWord_ );
-            //Store AnalysedWord
-            analyses.push_back( analysedWord_ );
-                
-            // Repeat in REVERSE
-            analysedWord_.Clear();
-            PatternMatching( distance, revAttemptProcessed, revAttempt, revSpellingProcessed, revSpelling, analysedWord_ );
-            if( spelling_.length() > 2 )
-                SwapSearch( analysedWord_ );
-            // Re-reverse analysedWord results
-            analysedWord_.Reverse();
-            if( spelling_.length() > 3 )
-                ThreeAwaySearch( analysedWord_ );
-
-            //Store AnalysedWord
-            analyses.push_back( analysedWord_ );    
-            
-            // Pattern Matching with Swaps (length of original spelling > 2? letters)
-            analysedWord_.Clear();
-            PatternMatching( distance, attCopy_, attempt_, speCopy_, spelling_, analysedWord_, true );
-            // FindSwaps (length of original spelling > 2? letters)
-            if( spelling_.length() > 2 )
-                SwapSearch( analysedWord_ );
-            // ThreeAway (length of original spelling > 3? letters)
-            if( spelling_.length() > 3 )
-                ThreeAwaySearch( analysedWord_ );
-            // Store AnalysedWord
-            analyses.push_back( analysedWord_ ); 
-            // Repeat in REVERSE
-            analysedWord_.Clear();
-            PatternMatching( distance, revAttemptProcessed, revAttempt, revSpellingProcessed, revSpelling, analysedWord_, true );
-            if( spelling_.length() > 2 )
-                SwapSearch( analysedWord_ );
-            // Re-reverse analysedWord results
-            analysedWord_.Reverse();
-            if( spelling_.length() > 3 )
-                ThreeAwaySearch( analysedWord_ );
-
-            //Store AnalysedWord
-            analyses.push_back( analysedWord_ );    
+    pSpelling_ = &pWord_->GetMainSpelling();
+    spelling_ = pSpelling_->GetSpelling();
+    speCopy_ = Normalised( *pSpelling_ );
+    if( ExactMatch() )
+        return;
+    
+    // Only the spellings nearest the attempt are worth a full analysis - usually just one.
+    SpellingTargets targets;
+    ClosestSpellings( targets );
+    if( targets.size() == 1 ){
+        Analyse( engine, *targets[0] );
+        return;
+    }
+    
+    // Several equally near: analyse each.  Pattern matching is slow enough to be worth a thread per
+    // spelling; alignment takes a few microseconds, so is quicker than starting a thread.
+    vector<AnalysedWord> results( targets.size(), analysedWord_ );
+    vector<thread> workers;
+    for( size_t i = 1; i < targets.size(); ++i ){
+        if( engine == PATTERNMATCHING )
+            workers.push_back( thread( &SpellingAnalyser::AnalyseSpelling, cref( attempt_ ), pWord_, ref( speller_ ),
+                                       ref( results[i] ), engine, cref( *targets[i] ) ) );
+        else
+            AnalyseSpelling( attempt_, pWord_, speller_, results[i], engine, *targets[i] );
+    }
+    AnalyseSpelling( attempt_, pWord_, speller_, results[0], engine, *targets[0] );
+    for( vector<thread>::iterator iter = workers.begin(); iter != workers.end(); ++iter ){
+        iter->join();
+    }
+    
+    // Best result wins, though anything not Beyond Wrong beats anything that is.  Ties go to the main spelling.
+    size_t best = 0;
+    for( size_t i = 1; i < results.size(); ++i ){
+        if( results[i].IsBeyondWrong() != results[best].IsBeyondWrong() ){
+            if( !results[i].IsBeyondWrong() )
+                best = i;
+        }
+        else if( results[i].SortOrder( results[best] ) ){
+            best = i;
         }
-        // Select Best AnalysedWord
-        for_each(analyses.begin(), analyses.end(), mem_fun_ref(&AnalysedWord::CalculateStats));
-        sort(analyses.begin(), analyses.end(), mem_fun_ref( &AnalysedWord::SortOrder ) );
-        // Select the first item as the analysed Word choice.
-        analysedWord_.Clear();
-        analysedWord_ = analyses[0];
-        // Now check for Special Cases: Beyond Wrong.  If a special case, set a flag to this effect.
-        CheckBeyondWrong();        
     }
+    analysedWord_ = move( results[best] );
 }
 
-std::wstring SpellingAnalyser::ApplyOptionsToString( const std::wstring s ){
-    if( speller_.UseAutoDiacritics() ){
-        if( speller_.UseAutoCapitals() ){
-            return ToLower( s, true ); // lose caps and diacritics
+SpellingAnalyser::SpellingAnalyser(const std::wstring& attempt, const Word* word, Speller& speller,
+                     AnalysedWord& analysedWord, Engine engine, const Spelling& target)
+: attempt_(attempt), pWord_(word), speller_(speller),
+  analysedWord_(analysedWord)
+{
+    attCopy_ = ApplyOptionsToString( attempt_ );
+    Analyse( engine, target );
+}
+
+void SpellingAnalyser::AnalyseSpelling(const std::wstring& attempt, const Word* word, Speller& speller,
+                                       AnalysedWord& analysedWord, Engine engine, const Spelling& target){
+    SpellingAnalyser analyser( attempt, word, speller, analysedWord, engine, target );
+}
+
+void SpellingAnalyser::Analyse( Engine engine, const Spelling& target ){
+    pSpelling_ = &target;
+    spelling_ = target.GetSpelling();
+    speCopy_ = Normalised( target );
+    analysedWord_ = AnalysedWord( static_cast<unsigned int>( spelling_.length() ) ); // Scored against this spelling's length
+    // Junk needs no careful analysis - the quicker engine will do, as the verdict is already known.
+    if( engine == ALIGNMENT || ClearlyBeyondWrong() )
+        Alignment();
+    else
+        BestPatternMatch();
+    // Now check for Special Cases: Beyond Wrong.  If a special case, set a flag to this effect.
+    CheckBeyondWrong();
+    analysedWord_.SetSpellingID( target.GetID() );
+}
+
+void SpellingAnalyser::ClosestSpellings( SpellingTargets& targets ){
+    targets.clear();
+    const Spelling& main = pWord_->GetMainSpelling();
+    targets.push_back( &main );
+    const SpellingList& spellings = pWord_->GetSpellings();
+    if( spellings.size() < 2 )
+        return;
+    
+    unsigned int nearest = EditDistance( attCopy_, speCopy_ );
+    for( SpellingList::const_iterator iter = spellings.begin(); iter != spellings.end(); ++iter ){
+        if( iter->GetID() == main.GetID() )
+            continue;
+        unsigned int distance = EditDistance( attCopy_, Normalised( *iter ) );
+        if( distance < nearest ){
+            nearest = distance;
+            targets.clear();
         }
-        return RemoveDiacritics(s); // keep caps but lose diacritics
+        if( distance == nearest )
+            targets.push_back( &*iter );
     }
-    
-    if( speller_.UseAutoCapitals() ){ // keep diacritics but lose caps
-        return ToLower( s );
+}
+
+// Runs PatternMatching at each distance, forwards and backwards, with and without swaps, and keeps the best.
+void SpellingAnalyser::BestPatternMatch(){
+    // Each analysis is made in analysedWord_, and only moved into best if it beats it.
+    AnalysedWord best( static_cast<unsigned int>( spelling_.length() ) );
+    bool found = false;
+    // For reverse analysis
+    wstring revAttempt = attempt_;
+    reverse( revAttempt.begin(), revAttempt.end() );
+    wstring revAttemptProcessed = ApplyOptionsToString( revAttempt );
+    const wstring& revSpelling = pSpelling_->GetNormalised( false, false, true );
+    const wstring& revSpellingProcessed = Normalised( *pSpelling_, true );
+    unsigned int distance;
+    // For each distance ( no. letters in attempt - 2 ).  Attempts shorter than two letters get a single pass.
+    for(distance = max<size_t>( attempt_.length(), 2 ); distance >= 2; --distance){
+        analysedWord_.Clear();
+        //Pattern Matching
+        PatternMatching( distance, attCopy_, attempt_, speCopy_, spelling_, analysedWord_ );            
+        // FindSwaps (length of original spelling > 2? letters)
+        if( spelling_.length() > 2 )
+            SwapSearch( analysedWord_ );
+        // ThreeAway (length of original spelling > 3? letters)
+        if( spelling_.length() > 3 )
+            ThreeAwaySearch( analysedWord_ );
+        KeepBest( best, found ); // analysedWord_ is cleared before reuse
+            
+        // Repeat in REVERSE
+        analysedWord_.Clear();
+        PatternMatching( distance, revAttemptProcessed, revAttempt, revSpellingProcessed, revSpelling, analysedWord_ );
+        if( spelling_.length() > 2 )
+            SwapSearch( analysedWord_ );
+        // Re-reverse analysedWord results
+        analysedWord_.Reverse();
+        if( spelling_.length() > 3 )
+            ThreeAwaySearch( analysedWord_ );
+        KeepBest( best, found );
+        
+        // Pattern Matching with Swaps (length of original spelling > 2? letters)
+        analysedWord_.Clear();
+        PatternMatching( distance, attCopy_, attempt_, speCopy_, spelling_, analysedWord_, true );
+        // FindSwaps (length of original spelling > 2? letters)
+        if( spelling_.length() > 2 )
+            SwapSearch( analysedWord_ );
+        // ThreeAway (length of original spelling > 3? letters)
+        if( spelling_.length() > 3 )
+            ThreeAwaySearch( analysedWord_ );
+        KeepBest( best, found );
+        // Repeat in REVERSE
+        analysedWord_.Clear();
+        PatternMatching( distance, revAttemptProcessed, revAttempt, revSpellingProcessed, revSpelling, analysedWord_, true );
+        if( spelling_.length() > 2 )
+            SwapSearch( analysedWord_ );
+        // Re-reverse analysedWord results
+        analysedWord_.Reverse();
+        if( spelling_.length() > 3 )
+            ThreeAwaySearch( analysedWord_ );
+        KeepBest( best, found );
     }
-    
-    return s; // keep diacritics and caps
+    analysedWord_ = move( best );
+}
+
+// Ties go to the earlier analysis.
+void SpellingAnalyser::KeepBest( AnalysedWord& best, bool& found ){
+    analysedWord_.CalculateStats();
+    if( !found || analysedWord_.SortOrder( best ) ){
+        best = move( analysedWord_ );
+        found = true;
+    }
+}
+
+std::wstring SpellingAnalyser::ApplyOptionsToString( const std::wstring s ){
+    return ApplySpellingOptions( s, speller_.UseAutoDiacritics(), speller_.UseAutoCapitals() );
+}
+
+const std::wstring& SpellingAnalyser::Normalised( const Spelling& spelling, bool reversed ) const {
+    return spelling.GetNormalised( speller_.UseAutoDiacritics(), speller_.UseAutoCapitals(), reversed );
 }
 
 bool SpellingAnalyser::ExactMatch(){
-    // TODO: Make a note if an alternative spelling is used
     if( attCopy_ == speCopy_ ){
         // Construct AnalysedWord out of spelling_
         ConstructAnalysedWordFromSpelling( spelling_ );
         analysedWord_.SetAnalysisState( EXACT );
+        analysedWord_.SetSpellingID( pWord_->GetMainSpelling().GetID() );
         return true;
     }
     // No match, so try each alternative spelling.
-    SpellingList sList = pWord_->GetSpellings();
-    for( SpellingList::iterator iter = sList.begin();
+    const SpellingList& sList = pWord_->GetSpellings();
+    for( SpellingList::const_iterator iter = sList.begin();
          iter != sList.end();
          ++iter ){
          
-        if( iter->GetSpelling() == pWord_->GetMainSpellingString() ) // Don't bother with main spelling again.
+        if( iter->GetID() == pSpelling_->GetID() ) // Don't bother with main spelling again.
             continue;
-        wstring copy = ApplyOptionsToString( iter->GetSpelling() );
-        if( attCopy_ == copy ){
+        if( attCopy_ == Normalised( *iter ) ){
             // Construct AnalysedWord out of *iter.
             ConstructAnalysedWordFromSpelling( iter->GetSpelling() );
             // Set Special Case flag
             analysedWord_.SetAnalysisState( ALTSPELLING );
+            analysedWord_.SetSpellingID( iter->GetID() );
             return true;
         }
     }
@@ -700,7 +828,8 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
     wstring::size_type patternStart = 0;
     
     wstring::size_type length = spellingProcessed.length() - patternStart;// Set the length of the pattern to be searched for.
-    wstring pattern = L"";
+    // The pattern is spellingProcessed from patternStart, length letters long.  Nothing is copied out of the
+    // strings: letters are added to the analysis straight from them.
     // Set the beginning of the search to the first letter of the attempt copy.
     wstring::size_type searchPosition = 0;
     // Find the 1st occurrence of the current pattern in the search range.
@@ -709,35 +838,22 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
         // If no pattern (no letters) left:
         if( length == 0 ){
             // Any remaining letters in the attempt are WRONG
-            wstring wrongLetters = attempt.substr( searchPosition );
-            FillAnalysedWord( wrongLetters, Wrong );
+            FillAnalysedWord( attempt, searchPosition, wstring::npos, Wrong );
             return;
         }
-        pattern = spellingProcessed.substr(patternStart, length);
-        location = attemptProcessed.find(pattern, searchPosition );
+        location = attemptProcessed.find( spellingProcessed.data() + patternStart, searchPosition, length );
         // If found:
         if( location != wstring::npos && location <= distance ){
-            // Check for preceding letters in the attempt copy.
-            wstring wrongLetters = attempt.substr(searchPosition, location - searchPosition);
-            // If any:
-            if( !wrongLetters.empty() ){
-                // Record these letters as WRONG.
-                FillAnalysedWord( wrongLetters, Wrong );
-            }
+            // Record any preceding letters in the attempt copy as WRONG.
+            FillAnalysedWord( attempt, searchPosition, location - searchPosition, Wrong );
             // Mark the range (using the target original) as CORRECT.
-            wstring correctLetters = spelling.substr(patternStart, length);
-            FillAnalysedWord( correctLetters, Correct );
+            FillAnalysedWord( spelling, patternStart, length, Correct );
             // Set the beginning of the pattern range to the next letter after the end of the located pattern.
             patternStart += length;
             // If none:
             if( patternStart >= speCopy_.length() ){
-                // Check for any remaining letters in the attempt copy.
-                wrongLetters = attempt.substr( location + length );
-                // If any:
-                if( !wrongLetters.empty() ){
-                    // Record these letters (using the attempt original) as WRONG.
-                    FillAnalysedWord( wrongLetters, Wrong );
-                }
+                // Record any remaining letters (using the attempt original) as WRONG.
+                FillAnalysedWord( attempt, location + length, wstring::npos, Wrong );
                 return;
             }
              // Set the beginning of the search to the first letter after the located pattern.
@@ -745,13 +861,8 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
 
             // If none:
             if( searchPosition >= attemptProcessed.length() ){
-                // Check for any remaining letters in the target copy.
-                wstring missingLetters = spelling.substr(patternStart);
-                // If any:
-                if( !missingLetters.empty() ){
-                    // Record these letters (using the target original) as MISSING.
-                    FillAnalysedWord( missingLetters, Missing );
-                }
+                // Record any remaining letters (using the target original) as MISSING.
+                FillAnalysedWord( spelling, patternStart, wstring::npos, Missing );
                 return;
             }
             length = spellingProcessed.length() - patternStart; // Calculate new length
@@ -764,8 +875,7 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
             // If pattern length is one letter only:
             if( length == 1 ){
             // Record this letter (using the target original) as MISSING.
-                wstring missingLetter = spelling.substr(patternStart, 1);
-                FillAnalysedWord( missingLetter, Missing );
+                FillAnalysedWord( spelling, patternStart, 1, Missing );
                 // Advance pattern
                 ++patternStart;
                 length = spellingProcessed.length() - patternStart;
@@ -775,23 +885,17 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
             // SWAP ON THE FLY SHOULD HAPPEN HERE
             if( swapOnTheFly ){
                 // Swap the pair of letters around
-                reverse( pattern.begin(), pattern.end() );
-                location = attemptProcessed.find(pattern, searchPosition );
+                const wchar_t swapped[2] = { spellingProcessed[patternStart + 1], spellingProcessed[patternStart] };
+                location = attemptProcessed.find( swapped, searchPosition, 2 );
 
                 if( location != wstring::npos && location <= distance ){
                     // Found reversed pattern, so follow almost the same process as finding correct letters
-                    // Check for preceding letters in the attempt copy.
-                    wstring wrongLetters = attempt.substr(searchPosition, location - searchPosition);
-                    // If any:
-                    if( !wrongLetters.empty() ){
-                        // Record these letters as WRONG.
-                        FillAnalysedWord( wrongLetters, Wrong );
-                    }
+                    // Record any preceding letters in the attempt copy as WRONG.
+                    FillAnalysedWord( attempt, searchPosition, location - searchPosition, Wrong );
                     // Record Swapped letters
                     // (Need to get the letters from the original spelling and reverse them.)
-                    wstring lettersFromOriginal = spelling_.substr(patternStart,2);
-                    reverse( lettersFromOriginal.begin(), lettersFromOriginal.end() );
-                    FillAnalysedWord( lettersFromOriginal, Swapped );
+                    analysedWord_.Add( spelling_[patternStart + 1], Swapped );
+                    analysedWord_.Add( spelling_[patternStart], Swapped );
                     // Advance pattern to after the swapped letters
                     patternStart += 2;
                     // Set search position and length
@@ -799,11 +903,9 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
                     length = spellingProcessed.length() - patternStart;
                     continue;
                 }
-                // Not found, so put pattern back as it was before continuing rest of algorithm
-                reverse( pattern.begin(), pattern.end() );                
             }
             // Look at first letter only.
-            wchar_t firstLetterOfPattern = pattern[0];
+            wchar_t firstLetterOfPattern = spellingProcessed[patternStart];
             // If this is the initial letter of the target original
             if( firstLetterOfPattern == spellingProcessed[0] ||
                 (patternStart > 1 && spelling[patternStart-1] == L' ') ){// OR if the letter immediately before this in the target original is a space,
@@ -812,16 +914,16 @@ void SpellingAnalyser::PatternMatching( const unsigned int distance,
                 continue;
             }
             // See this letter is unique in the remainder of the target copy,
-            wstring remainder = spellingProcessed.substr(patternStart);
-            if( count(remainder.begin(), remainder.end(), firstLetterOfPattern) == 1 ){
+            if( count(spellingProcessed.begin() + patternStart, spellingProcessed.end(), firstLetterOfPattern) == 1 ){
                 // It is, so reduce the pattern length by one and continue.
                 --length;
                 continue;
             }
             // Otherwise, record this letter (using the target original) as MISSING.
-            wstring missingLetter = spelling.substr(patternStart, 1);
-            FillAnalysedWord( missingLetter, Missing );
+            FillAnalysedWord( spelling, patternStart, 1, Missing );
             ++patternStart;// Advance the pattern start by one
+            // Don't let the pattern run past the end of the target copy.
+            length = min( length, spellingProcessed.length() - patternStart );
         } // End of section dealing with NOT found
     }// End While
 }
@@ -887,6 +989,215 @@ void SpellingAnalyser::ThreeAwaySearch( AnalysedWord& aw ){
     }
 }
 
+// Alignment costs, taken from the score penalties in AnalysedWord::Tally.
+// A Missing/Wrong pair gets 11 back, so a substituted letter costs 10 + 10 - 11.
+namespace {
+    enum AlignMove{ NOMOVE, MATCH, SUBSTITUTE, MISSINGLETTER, WRONGLETTER, SWAP, MISSINGFIRST, WRONGFIRST };
+    const int SUBSTITUTECOST = 9;
+    const int INDELCOST      = 10;
+    const int SWAPCOST       = 3;
+    const int THREEAWAYCOST  = 6;
+    
+    // Cost of the middle pair of a three away: both Correct, both Swapped, or not a three away (-1).
+    int MiddlePairCost( wchar_t s1, wchar_t s2, wchar_t a1, wchar_t a2 ){
+        if( s1 == a1 && s2 == a2 )
+            return 0;
+        if( s1 == a2 && s2 == a1 )
+            return SWAPCOST;
+        return -1;
+    }
+}
+
+void SpellingAnalyser::Alignment(){
+    const wstring& s = speCopy_;
+    const wstring& a = attCopy_;
+    const size_t n = s.length();
+    const size_t m = a.length();
+    const size_t width = m + 1;
+    const bool useSwaps = spelling_.length() > 2;      // Same limits as SwapSearch and ThreeAwaySearch
+    const bool useThreeAways = spelling_.length() > 3;
+    
+    // cost[i*width + j] is the cheapest alignment of the first i letters of the spelling with the first j of the attempt.
+    vector<int> cost( (n + 1) * width );
+    vector<unsigned char> move( (n + 1) * width, NOMOVE );
+    for( size_t i = 0; i <= n; ++i ){
+        for( size_t j = 0; j <= m; ++j ){
+            size_t here = i * width + j;
+            if( i == 0 && j == 0 ){
+                cost[here] = 0;
+                continue;
+            }
+            // Earlier moves win ties, except that missing and wrong letters beat a match, so that
+            // the earliest of a run of repeated letters is the one marked Correct, as in PatternMatching.
+            int best = INT_MAX;
+            unsigned char bestMove = NOMOVE;
+            if( i > 0 && j > 0 ){
+                int c = cost[here - width - 1];
+                if( s[i-1] == a[j-1] ){
+                    best = c;
+                    bestMove = MATCH;
+                }
+            }
+            if( useSwaps && i > 1 && j > 1 && s[i-1] != s[i-2] &&
+                s[i-1] == a[j-2] && s[i-2] == a[j-1] ){
+                int c = cost[here - 2*width - 2] + SWAPCOST;
+                if( c < best ){ best = c; bestMove = SWAP; }
+            }
+            if( useThreeAways && i > 2 && j > 2 ){
+                // Spelling x p q, attempt p q x
+                int middle = MiddlePairCost( s[i-2], s[i-1], a[j-3], a[j-2] );
+                if( s[i-3] == a[j-1] && middle >= 0 ){
+                    int c = cost[here - 3*width - 3] + THREEAWAYCOST + middle;
+                    if( c < best ){ best = c; bestMove = MISSINGFIRST; }
+                }
+                // Attempt x p q, spelling p q x
+                middle = MiddlePairCost( s[i-3], s[i-2], a[j-2], a[j-1] );
+                if( a[j-3] == s[i-1] && middle >= 0 ){
+                    int c = cost[here - 3*width - 3] + THREEAWAYCOST + middle;
+                    if( c < best ){ best = c; bestMove = WRONGFIRST; }
+                }
+            }
+            if( i > 0 && j > 0 ){
+                int c = cost[here - width - 1] + SUBSTITUTECOST;
+                if( c < best ){ best = c; bestMove = SUBSTITUTE; }
+            }
+            if( i > 0 ){
+                int c = cost[here - width] + INDELCOST;
+                if( c <= best ){ best = c; bestMove = MISSINGLETTER; }
+            }
+            if( j > 0 ){
+                int c = cost[here - 1] + INDELCOST;
+                if( c <= best ){ best = c; bestMove = WRONGLETTER; }
+            }
+            cost[here] = best;
+            move[here] = bestMove;
+        }
+    }
+    
+    // Trace back from the end, then replay forwards.
+    vector<unsigned char> path;
+    size_t i = n, j = m;
+    while( i > 0 || j > 0 ){
+        unsigned char mv = move[i * width + j];
+        path.push_back( mv );
+        switch( mv ){
+            case MATCH:
+            case SUBSTITUTE:    --i; --j;       break;
+            case MISSINGLETTER: --i;            break;
+            case WRONGLETTER:   --j;            break;
+            case SWAP:          i -= 2; j -= 2; break;
+            default:            i -= 3; j -= 3; break; // three aways
+        }
+    }
+    
+    // Letters between matches are recorded as Missing then Wrong, as PatternMatching usually does.
+    analysedWord_.Clear();
+    wstring missing, wrong;
+    i = 0;
+    j = 0;
+    for( vector<unsigned char>::reverse_iterator iter = path.rbegin(); iter != path.rend(); ++iter ){
+        if( *iter == SUBSTITUTE || *iter == MISSINGLETTER || *iter == WRONGLETTER ){
+            if( *iter != WRONGLETTER )
+                missing += spelling_[i++];
+            if( *iter != MISSINGLETTER )
+                wrong += attempt_[j++];
+            continue;
+        }
+        FillAnalysedWord( missing, Missing );
+        FillAnalysedWord( wrong, Wrong );
+        missing.clear();
+        wrong.clear();
+        switch( *iter ){
+            case MATCH:{
+                analysedWord_.Add( spelling_[i], Correct );
+                ++i;
+                ++j;
+                break;
+            }
+            case SWAP:{
+                analysedWord_.Add( spelling_[i+1], Swapped );
+                analysedWord_.Add( spelling_[i], Swapped );
+                i += 2;
+                j += 2;
+                break;
+            }
+            case MISSINGFIRST:{
+                analysedWord_.Add( spelling_[i], ThreeAwayMissingF );
+                if( s[i+1] == a[j] ){
+                    analysedWord_.Add( spelling_[i+1], Correct );
+                    analysedWord_.Add( spelling_[i+2], Correct );
+                } else {
+                    analysedWord_.Add( spelling_[i+2], Swapped );
+                    analysedWord_.Add( spelling_[i+1], Swapped );
+                }
+                analysedWord_.Add( attempt_[j+2], ThreeAwayWrongB );
+                i += 3;
+                j += 3;
+                break;
+            }
+            case WRONGFIRST:{
+                analysedWord_.Add( attempt_[j], ThreeAwayWrongF );
+                if( s[i] == a[j+1] ){
+                    analysedWord_.Add( spelling_[i], Correct );
+                    analysedWord_.Add( spelling_[i+1], Correct );
+                } else {
+                    analysedWord_.Add( spelling_[i+1], Swapped );
+                    analysedWord_.Add( spelling_[i], Swapped );
+                }
+                analysedWord_.Add( spelling_[i+2], ThreeAwayMissingB );
+                i += 3;
+                j += 3;
+                break;
+            }
+            default:{
+                break;
+            }
+        }
+    }
+    FillAnalysedWord( missing, Missing );
+    FillAnalysedWord( wrong, Wrong );
+    analysedWord_.CalculateStats();
+}
+
+// CheckBeyondWrong only looks at the length difference and the links (runs of Correct letters).
+// Any analysis's Correct letters form a common subsequence of the processed strings, and each link
+// is a common substring.  So the longest common subsequence and the longest common substring bound
+// the links of every analysis, and can sometimes settle the verdict before any analysis is done.
+bool SpellingAnalyser::ClearlyBeyondWrong() const {
+    const wstring& s = speCopy_;
+    const wstring& a = attCopy_;
+    if( s.empty() || s.length() > BITVECTORLENGTH )
+        return false;
+    
+    LetterMasks masks( s );
+    BitVector lcs = ~BitVector(0); // Hyyro's bit-parallel LCS - zero bits count the common subsequence
+    BitVector runs1 = 0;           // Spelling positions ending a common substring of 1 letter at the current attempt letter
+    BitVector runs2 = 0;           // ...and of 2 letters
+    bool longestAtLeast3 = false;
+    for( wstring::const_iterator iter = a.begin(); iter != a.end(); ++iter ){
+        BitVector matches = masks( *iter );
+        BitVector u = lcs & matches;
+        lcs = ( lcs + u ) | ( lcs - u );
+        if( matches & ( runs2 << 1 ) )
+            longestAtLeast3 = true;
+        runs2 = matches & ( runs1 << 1 );
+        runs1 = matches;
+    }
+    BitVector used = ( s.length() == BITVECTORLENGTH ) ? ~BitVector(0) : ( BitVector(1) << s.length() ) - 1;
+    unsigned int commonLetters = CountBits( ~lcs & used );
+    
+    // Every letter of the attempt is in the analysis, so the length difference is known now.
+    size_t lengthDifference = a.length() > spelling_.length() ? a.length() - spelling_.length()
+                                                             : spelling_.length() - a.length();
+    // RULE SET 1 needs an average link below 3 (the shorter word test is below 2, so is covered by this).
+    // Links no longer than 2 make that certain.
+    if( lengthDifference > 3 )
+        return !longestAtLeast3;
+    // RULE SET 2 needs no more than one Correct letter in all.
+    // RULE SET 3 can't be reached - a length difference of 5 or more is dealt with by rule set 1.
+    return spelling_.length() > 3 && commonLetters <= 1;
+}
+
 void SpellingAnalyser::ConstructAnalysedWordFromSpelling( const wstring s ){
     for( wstring::const_iterator iter = s.begin();
          iter != s.end();
@@ -903,6 +1214,15 @@ void SpellingAnalyser::FillAnalysedWord(const std::wstring s, const LetterStatus
     }
 }
 
+void SpellingAnalyser::FillAnalysedWord( const std::wstring& s, std::wstring::size_type start,
+                                         std::wstring::size_type count, const LetterStatus stat ){
+    if( start >= s.length() )
+        return;
+    wstring::size_type end = count < s.length() - start ? start + count : s.length();
+    for( ; start < end; ++start )
+        analysedWord_.Add( s[start], stat );
+}
+
 void SpellingAnalyser::CheckBeyondWrong(){
     // RULE SET 1 (ALL the following must apply):
     // Difference between letters in Target and letters in Attempt > ?3?
@@ -947,40 +1267,23 @@ void WordPrinter::PrintWord(const Word *word, const Speller *speller,
     const Spelling& spelling = word->GetMainSpelling();
     wstring spellingString = spelling.GetSpelling();
     
-    Gdiplus::Color inkColour;
-    Gdiplus::PointF workingPosition = position; // make a copy.
-    
-    // Start a loop from first letter to last letter of Word's main spelling.
-    for( int i = 0; i < spellingString.size(); ++i ){
-        Breakdown breakdown;
-        Gdiplus::Color inkColour = speller->GetColour(Speller::PEN);
-        // If Speller has "breakdown" option:
-        if( speller->UseWordBreakdown() ){
-            spelling.GetBreakdownAtPosition( i + 1, breakdown );
-            // If current breakdown matches current letter (WARNING: zero-based vs. one-based)
-            if( breakdown.position_ ){
-                // Set colour to Speller's matching breakdown colour
-                inkColour = speller->GetColour(breakdown.colourNum_);
-                // Print EACH letter in breakdown using Speller's spacing setting // TODO:Spacing setting
-                for( int j = i; j < i + breakdown.length_;){
-                    workingPosition = screenPrinter->PrintLetter(spellingString[j], workingPosition, *font, inkColour);
-                    ++j;
-                    if( j > spellingString.size() )
-                        break;
-                }
-                // Advance to next letter AFTER breakdown group, checking for overrun
-                i += (breakdown.length_ - 1);
-                if( i > spellingString.size() )
-                    break;
-            } else {
-                workingPosition = screenPrinter->PrintLetter(spellingString[i], workingPosition, *font, inkColour);
+    // Colour each letter with the pen, or the matching breakdown colour if Speller has "breakdown" option.
+    vector<Gdiplus::Color> inkColours(spellingString.size(), speller->GetColour(Speller::PEN));
+    if( speller->UseWordBreakdown() ){
+        for( size_t i = 0; i < spellingString.size(); ++i ){
+            Breakdown breakdown;
+            spelling.GetBreakdownAtPosition( static_cast<unsigned int>(i + 1), breakdown ); // (WARNING: zero-based vs. one-based)
+            if( breakdown.position_ && breakdown.length_ ){
+                // Every letter in breakdown, checking for overrun // TODO:Spacing setting
+                for( size_t j = i; j < i + breakdown.length_ && j < spellingString.size(); ++j )
+                    inkColours[j] = speller->GetColour(breakdown.colourNum_);
+                // Advance to next letter AFTER breakdown group
+                i += breakdown.length_ - 1;
             }
-        } else {
-        // else, print current letter with pen colour using Speller's spacing setting
-        workingPosition = screenPrinter->PrintLetter(spellingString[i], workingPosition, *font, inkColour);
         }
-            // Advance to next letter
     }
+    // Letters in the same colour are printed together
+    screenPrinter->PrintLetters(spellingString, position, *font, inkColours);
 }
 
 void WordPrinter::PrintAttempt(const std::wstring attempt,
@@ -988,10 +1291,5 @@ void WordPrinter::PrintAttempt(const std::wstring attempt,
                                ScreenPrinter *screenPrinter, BackBuffer *bb,
                                Gdiplus::Font *font, const Gdiplus::PointF position) const{
     
-    Gdiplus::Color inkColour = speller->GetColour(Speller::PEN);;
-    Gdiplus::PointF workingPosition = position; // make a copy.
-    
-    for( int i = 0; i < attempt.size(); ++i ){
-        workingPosition = screenPrinter->PrintLetter(attempt[i], workingPosition, *font, inkColour);
-    }
+    screenPrinter->PrintLetters(attempt, position, *font, speller->GetColour(Speller::PEN));
 }
\ No newline at end of file
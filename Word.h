@@ -22,6 +22,8 @@
 #include <list>
 #include <set>
 #include "Definitions.h"
+#include "InlineVector.h"
+#include "LetterStatus.h"
 
 
 //Forward Declarations
@@ -81,6 +83,9 @@ public:
     
     unsigned int GetID() const;
     std::wstring GetSpelling() const;
+    // The spelling with diacritics and/or capitals removed, optionally reversed.  Worked out on first use,
+    // then kept.  Not safe for two threads to fill the same Spelling's forms at once.
+    const std::wstring& GetNormalised( bool removeDiacritics, bool removeCapitals, bool reversed = false ) const;
     size_t GetBreakdownListSize() const;
     void GetBreakdownAtPosition( unsigned int position, Breakdown& breakdown ) const;
     bool AddBreakdown(unsigned int position, unsigned int length, unsigned int colourNum);
@@ -89,6 +94,8 @@ private:
     std::wstring spelling_;  // How the word is actually spelled
     unsigned int id_;        // Database identifier - also distinguishes alternative spellings
     std::map<unsigned int, Breakdown> breakdownList_; // set of breakdown objects
+    mutable std::wstring normalised_[8]; // Indexed by removeDiacritics * 4 + removeCapitals * 2 + reversed
+    mutable unsigned int normalisedMask_; // Bit set for each of normalised_ worked out
         
 };
 
@@ -121,6 +128,7 @@ public:
     void AddTagID(unsigned int tagID); // No bool return, as checks should be made prior to call.
     
     bool SetDifficulty(int difficulty = 1); // returns false if invalid difficulty
+    void SetConfusable(bool confusable = true);
     
     bool EqualToID( const unsigned int id ) const; // Function to see if id passed in is equal.  Used as predicate.
     
@@ -143,15 +151,6 @@ private:
 
 };
 
-enum LetterStatus{ Null, Correct, Missing, Wrong, Swapped,
-                 ThreeAwayMissingF, ThreeAwayMissingB, ThreeAwayWrongF, ThreeAwayWrongB };
-// NOTE: the ThreeAwayMissing F and B are required for the animated feedback.
-// The F and B denote Front and Back of the threeaway group.  If the missing letter is first in the analysed letters
-// container, it gets an F(ront); if the ThreeAwayWrong appears first in the order, it gets a B(ack).
-// This aids the AnimatedFeedback object to know whether a particular ThreeAwayMissing letter has already been
-// animated, and should therefore be displayed in appropriate colours.
-// IMPORTANT - this means the ThreeAwaySearch MUST be done in forward (not reverse) order.
-
 // Stores a letter with its status after it has been Analysed (by Spelling Analyser)
 struct AnalysedLetter{
     
@@ -161,10 +160,21 @@ struct AnalysedLetter{
 
 };
 
-typedef std::vector<AnalysedLetter> AnalysedLetters;
+// Most letters an analysis of a word can hold without the heap: every letter of the attempt wrong,
+// and every letter of the spelling missing.
+const unsigned int ANALYSED_LETTERS_LIMIT = 2 * WORD_LENGTH_LIMIT;
+typedef InlineVector<AnalysedLetter, ANALYSED_LETTERS_LIMIT> AnalysedLetters;
 typedef AnalysedLetters::iterator AWiter;
 typedef AnalysedLetters::const_iterator AWConstIter;
 
+// AnalysedLetters packed for storage: a format byte, the letter count (7 bits per byte, low first),
+// each status in 4 bits (two to a byte, first in the low half), then the letters - one byte each if
+// all are Latin-1, otherwise two.  A 10 letter word packs into 17 bytes.
+typedef std::vector<unsigned char> PackedAnalysis;
+void PackAnalysis( const AnalysedLetters& letters, PackedAnalysis& packed );
+// Replaces letters with the unpacked analysis.  Returns false, leaving letters empty, if data is not a packed analysis.
+bool UnpackAnalysis( const unsigned char* data, std::size_t size, AnalysedLetters& letters );
+
 // Helper class to check null status of AnalysedLetters.
 class IsNull
 {
@@ -177,6 +187,18 @@ public:
 
 enum AnalysisState{ NA, EXACT, ALTSPELLING, BEYONDWRONG1, BEYONDWRONG2, BEYONDWRONG3};
 
+// Statistics of an AnalysedWord, all worked out in one pass over its letters.
+struct AnalysisStats{
+    int score_;                    // the value of the attempted spelling
+    unsigned int attemptLength_;   // How many letters in the attempt
+    unsigned int lengthDifference_; // Difference between attempt length and original length
+    unsigned int numLinks_;
+    unsigned int largestLink_;     // Largest no. of consecutive correct letters (not counting a final link)
+    double averageLinkSize_;       // Average no. of letters in each consecutive correct letter chain
+    int errors_;                   // As NumErrors
+    unsigned int statusCounts_[ThreeAwayWrongB + 1]; // No. of letters with each LetterStatus
+};
+
 class AnalysedWord{
 public:
     
@@ -215,44 +237,59 @@ public:
     bool IsAlternateSpelling() const;
     bool IsBeyondWrong() const;
     
+    // Which of the word's spellings the attempt was analysed against.
+    void SetSpellingID( unsigned int id );
+    unsigned int SpellingID() const;
+    
     void CalculateStats();
+    const AnalysisStats& Stats() const; // As of the last CalculateStats
     
     int  NumCorrect() const; // return the number of correct letters in the attempt (calculated)
     int  NumErrors() const;         // return the number of errors in the attempt (calculated)
     
     std::wstring GetString() const; // Recreates the speller's original attempt as a wstring
-    AnalysedLetters GetAnalysis() const; // Returns just the word_ part of AnalysedWord.
+    const AnalysedLetters& GetAnalysis() const; // Returns just the word_ part of AnalysedWord.
     
 private:
-    void CalculateScore();
-    void CalculateNumLetters();
-    void CalculateLinks();
+    void Tally( AnalysisStats& stats ) const; // Works out every statistic in one pass over word_
     
 private:
 
     AnalysedLetters word_;
     
     // These stats are required for creating a WrongSpelling, as well as some comparisons of algorithms.
-    int score_; // the value of the attempted spelling
-    unsigned int numLinks_;
-    double averageLinkSize_;     // Average no. of letters in each consecutive correct letter chain
-    unsigned int largestLink_;   // Largest no. of consecutive correct letters
-    unsigned int attemptLength_; // How many letters in the attempt
+    AnalysisStats stats_;
+    bool statsValid_;             // False once word_ has changed since CalculateStats
     unsigned int originalLength_; // How many letters in the original word
-    unsigned int lengthDifference_; // Difference between attempt length and original length
     AnalysisState analysisState_;
+    unsigned int spellingID_;
     
 
 };
 
 class SpellingAnalyser{
 public:
+    // PATTERNMATCHING is the original search; ALIGNMENT gives the same labels in O(n*m) time and memory.
+    enum Engine{ PATTERNMATCHING, ALIGNMENT };
+    
+    // Analyses against whichever of the word's spellings is nearest the attempt; the result records which.
     SpellingAnalyser(const std::wstring& attempt, const Word* word, Speller& speller,
-                     AnalysedWord& analysedWord);
+                     AnalysedWord& analysedWord, Engine engine = PATTERNMATCHING);
                      
 private:
+    // Analyses against target only.
+    SpellingAnalyser(const std::wstring& attempt, const Word* word, Speller& speller,
+                     AnalysedWord& analysedWord, Engine engine, const Spelling& target);
+    static void AnalyseSpelling(const std::wstring& attempt, const Word* word, Speller& speller,
+                                AnalysedWord& analysedWord, Engine engine, const Spelling& target); // Thread entry point
+    void Analyse( Engine engine, const Spelling& target ); // Runs engine against target
+    typedef InlineVector<const Spelling*, 4> SpellingTargets; // Usually only the one
+    void ClosestSpellings( SpellingTargets& targets ); // Spellings at the least edit distance, main first
+    
+
     bool SpellingsEqual(); // returns true if (processed) strings are the same
     std::wstring ApplyOptionsToString( const std::wstring s ); // returns a string cleaned of diacritics and/or capitals, depending on options
+    const std::wstring& Normalised( const Spelling& spelling, bool reversed = false ) const; // As above, cached by spelling
     
     // Algorithms
     bool ExactMatch(); // Checks if the (processed) strings are identical.
@@ -262,9 +299,15 @@ private:
                           AnalysedWord& aw, bool swapOnTheFly = false );
     void SwapSearch( AnalysedWord& aw );
     void ThreeAwaySearch( AnalysedWord& aw );
+    void BestPatternMatch(); // PATTERNMATCHING engine
+    void KeepBest( AnalysedWord& best, bool& found ); // Moves analysedWord_ into best if it's better, or the first
+    bool ClearlyBeyondWrong() const; // Bit-parallel pre-pass: true if every analysis would be Beyond Wrong
+    void Alignment();        // ALIGNMENT engine - weighted Damerau-style alignment with swaps and three aways
     
     void ConstructAnalysedWordFromSpelling( const std::wstring s );
     void FillAnalysedWord( const std::wstring s, const LetterStatus stat ); // Fill analysed word with string setting to specified status
+    void FillAnalysedWord( const std::wstring& s, std::wstring::size_type start, std::wstring::size_type count,
+                           const LetterStatus stat ); // As above, with count letters of s from start (fewer at its end)
     void CheckBeyondWrong();
     
 private:
@@ -272,6 +315,7 @@ private:
     std::wstring attCopy_;      // The speller's processed attempt (diacritics / caps removed dependent on options)
     std::wstring spelling_;     // Original spelling
     std::wstring speCopy_;      // Original spelling with diacritics / caps removed dependent on options.
+    const Spelling* pSpelling_; // Spelling being analysed against
     Speller& speller_;
     const Word* pWord_;
     AnalysedWord& analysedWord_;    // Stores the result of the analysis.
@@ -0,0 +1,187 @@
+// WordIndex.cpp
+
+#include "WordIndex.h"
+#include <algorithm>
+#include <set>
+#include "Word.h"
+#include "Speller.h"
+#include "Utility.h"
+
+using namespace std;
+
+namespace {
+    const size_t RECENTLIMIT = 65536; // Deletions held in recent_ before merging into the main table
+
+    // FNV-1a hash of s, skipping removed letters.
+    unsigned int HashWithout( const wstring& s, const vector<bool>& removed ){
+        unsigned int hash = 2166136261u;
+        for( size_t i = 0; i < s.length(); ++i ){
+            if( removed[i] )
+                continue;
+            hash = ( hash ^ static_cast<unsigned int>( s[i] ) ) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Hashes s with every combination of up to remaining letters from position from onwards removed.
+    void AddDeletions( const wstring& s, size_t from, unsigned int remaining, vector<bool>& removed,
+                       vector<unsigned int>& hashes ){
+        hashes.push_back( HashWithout( s, removed ) );
+        if( remaining == 0 )
+            return;
+        for( size_t i = from; i < s.length(); ++i ){
+            removed[i] = true;
+            AddDeletions( s, i + 1, remaining - 1, removed, hashes );
+            removed[i] = false;
+        }
+    }
+}
+
+WordIndex::Match::Match( unsigned int wordID, const wstring& spelling, unsigned int distance )
+: wordID_(wordID), spelling_(spelling), distance_(distance)
+{}
+
+bool WordIndex::Match::operator<( const Match& rhs ) const {
+    if( distance_ != rhs.distance_ )
+        return distance_ < rhs.distance_;
+    if( wordID_ != rhs.wordID_ )
+        return wordID_ < rhs.wordID_;
+    return spelling_ < rhs.spelling_;
+}
+
+WordIndex::WordIndex( unsigned int maxDistance )
+: maxDistance_(maxDistance)
+{}
+
+void WordIndex::Build( const WordBank& wordBank ){
+    Clear();
+    for( WordBank::const_iterator iter = wordBank.begin(); iter != wordBank.end(); ++iter ){
+        const SpellingList& spellings = iter->second.GetSpellings();
+        for( SpellingList::const_iterator spelling = spellings.begin(); spelling != spellings.end(); ++spelling ){
+            AddEntry( iter->first, spelling->GetSpelling(), deletions_ );
+        }
+    }
+    sort( deletions_.begin(), deletions_.end() ); // One sort is much quicker than keeping it sorted
+}
+
+void WordIndex::Insert( const Word& word ){
+    const SpellingList& spellings = word.GetSpellings();
+    for( SpellingList::const_iterator iter = spellings.begin(); iter != spellings.end(); ++iter ){
+        AddEntry( word.GetID(), iter->GetSpelling(), recent_ );
+    }
+    sort( recent_.begin(), recent_.end() );
+    if( recent_.size() > RECENTLIMIT ){
+        size_t middle = deletions_.size();
+        deletions_.insert( deletions_.end(), recent_.begin(), recent_.end() );
+        inplace_merge( deletions_.begin(), deletions_.begin() + middle, deletions_.end() );
+        recent_.clear();
+    }
+}
+
+void WordIndex::Clear(){
+    entries_.clear();
+    deletions_.clear();
+    recent_.clear();
+}
+
+size_t WordIndex::Size() const {
+    return entries_.size();
+}
+
+unsigned int WordIndex::MaxDistance() const {
+    return maxDistance_;
+}
+
+void WordIndex::Find( const wstring& attempt, const Speller& speller, size_t k, MatchList& matches ) const {
+    matches.clear();
+    if( entries_.empty() || k == 0 )
+        return;
+    wstring key = ToLower( attempt, true );
+    if( key.length() > BITVECTORLENGTH ) // Far longer than any word
+        return;
+
+    // Every spelling sharing a deletion with the attempt is a candidate.
+    vector<unsigned int> hashes;
+    Deletions( key, hashes );
+    vector<unsigned int> candidates;
+    for( vector<unsigned int>::iterator iter = hashes.begin(); iter != hashes.end(); ++iter ){
+        Lookup( deletions_, *iter, candidates );
+        Lookup( recent_, *iter, candidates );
+    }
+    sort( candidates.begin(), candidates.end() );
+    candidates.erase( unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+    // Check each candidate's distance.  Removing caps and diacritics never increases a distance,
+    // so nothing within maxDistance_ under the speller's options has been missed.
+    LetterMasks keyMasks( key );
+    bool keyIsProcessed = speller.UseAutoDiacritics() && speller.UseAutoCapitals();
+    LetterMasks processedMasks( keyIsProcessed ? key : ApplyOptions( attempt, speller ) );
+    MatchList found;
+    for( vector<unsigned int>::iterator iter = candidates.begin(); iter != candidates.end(); ++iter ){
+        const Entry& entry = entries_[*iter];
+        size_t lengthDifference = key.length() > entry.key_.length() ? key.length() - entry.key_.length()
+                                                                     : entry.key_.length() - key.length();
+        if( lengthDifference > maxDistance_ )
+            continue;
+        unsigned int distance = EditDistance( keyMasks, entry.key_ );
+        if( distance > maxDistance_ )
+            continue;
+        if( !keyIsProcessed )
+            distance = EditDistance( processedMasks, ApplyOptions( entry.spelling_, speller ) );
+        if( distance <= maxDistance_ )
+            found.push_back( Match( entry.wordID_, entry.spelling_, distance ) );
+    }
+
+    // Keep each word's nearest spelling only.
+    sort( found.begin(), found.end() );
+    set<unsigned int> seen;
+    for( MatchList::iterator iter = found.begin(); iter != found.end() && matches.size() < k; ++iter ){
+        if( seen.insert( iter->wordID_ ).second )
+            matches.push_back( *iter );
+    }
+}
+
+unsigned int WordIndex::OtherWord( const wstring& attempt, const Speller& speller, unsigned int wordID ) const {
+    MatchList matches;
+    Find( attempt, speller, 2, matches );
+    for( MatchList::iterator iter = matches.begin(); iter != matches.end() && iter->distance_ == 0; ++iter ){
+        if( iter->wordID_ != wordID )
+            return iter->wordID_;
+    }
+    return 0;
+}
+
+void WordIndex::AddEntry( unsigned int wordID, const wstring& spelling, DeletionTable& table ){
+    Entry entry;
+    entry.wordID_ = wordID;
+    entry.spelling_ = spelling;
+    entry.key_ = ToLower( spelling, true );
+    Deletion index = entries_.size();
+    entries_.push_back( entry );
+
+    vector<unsigned int> hashes;
+    Deletions( entry.key_, hashes );
+    for( vector<unsigned int>::iterator iter = hashes.begin(); iter != hashes.end(); ++iter ){
+        table.push_back( ( Deletion(*iter) << 32 ) | index );
+    }
+}
+
+void WordIndex::Deletions( const wstring& key, vector<unsigned int>& hashes ) const {
+    hashes.clear();
+    vector<bool> removed( key.length(), false );
+    AddDeletions( key, 0, maxDistance_, removed, hashes );
+    // Repeated letters give the same deletion more than once.
+    sort( hashes.begin(), hashes.end() );
+    hashes.erase( unique( hashes.begin(), hashes.end() ), hashes.end() );
+}
+
+void WordIndex::Lookup( const DeletionTable& table, unsigned int hash, vector<unsigned int>& entries ){
+    DeletionTable::const_iterator iter = lower_bound( table.begin(), table.end(), Deletion(hash) << 32 );
+    for( ; iter != table.end() && static_cast<unsigned int>( *iter >> 32 ) == hash; ++iter ){
+        entries.push_back( static_cast<unsigned int>( *iter ) );
+    }
+}
+
+wstring WordIndex::ApplyOptions( const wstring& s, const Speller& speller ){
+    return ApplySpellingOptions( s, speller.UseAutoDiacritics(), speller.UseAutoCapitals() );
+}
@@ -0,0 +1,70 @@
+// WordIndex.h
+// "Which word did you mean?" - finds the spellings in the WordBank closest to any attempt.
+// A deletion index (as in SymSpell): every spelling is filed under each string made by removing up
+// to maxDistance letters from it.  Two strings within that edit distance always share one of these,
+// so only spellings sharing a deletion with the attempt need their distance checked.
+// Spellings are filed with caps and diacritics removed; distances are then re-checked using the
+// speller's own options.
+
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "Definitions.h"
+
+class Word;
+class Speller;
+
+class WordIndex{
+public:
+    struct Match{
+        Match( unsigned int wordID, const std::wstring& spelling, unsigned int distance );
+        bool operator<( const Match& rhs ) const; // Nearest first, then by word ID
+        unsigned int wordID_;
+        std::wstring spelling_;
+        unsigned int distance_; // Edit distance from the attempt
+    };
+    typedef std::vector<Match> MatchList;
+
+    // Memory grows quickly with maxDistance: about 8 bytes per deletion, and a 7 letter word has 36 within 2.
+    explicit WordIndex( unsigned int maxDistance = 2 );
+
+    void Build( const WordBank& wordBank ); // Replaces the index with every spelling in wordBank.
+    void Insert( const Word& word );        // Adds all of word's spellings.
+    void Clear();
+    std::size_t Size() const;               // Number of spellings indexed
+    unsigned int MaxDistance() const;
+
+    // Fills matches with the k words nearest to attempt, within MaxDistance(), nearest first.
+    // Each word appears once, with its nearest spelling.
+    void Find( const std::wstring& attempt, const Speller& speller, std::size_t k, MatchList& matches ) const;
+
+    // Returns the ID of a word, other than wordID, that attempt spells exactly.  0 if none.
+    unsigned int OtherWord( const std::wstring& attempt, const Speller& speller, unsigned int wordID ) const;
+
+private:
+    struct Entry{
+        unsigned int wordID_;
+        std::wstring spelling_;
+        std::wstring key_; // spelling_ with caps and diacritics removed
+    };
+    // Hash of a deletion in the top 32 bits, index into entries_ in the bottom 32.
+    // Hashes can collide, but every candidate's distance is checked anyway.
+    typedef unsigned long long Deletion;
+    typedef std::vector<Deletion> DeletionTable;
+
+    void AddEntry( unsigned int wordID, const std::wstring& spelling, DeletionTable& table );
+    void Deletions( const std::wstring& key, std::vector<unsigned int>& hashes ) const; // Each different deletion once
+    static void Lookup( const DeletionTable& table, unsigned int hash, std::vector<unsigned int>& entries );
+    static std::wstring ApplyOptions( const std::wstring& s, const Speller& speller );
+
+private:
+    unsigned int maxDistance_;
+    std::vector<Entry> entries_;
+    DeletionTable deletions_; // Sorted
+    DeletionTable recent_;    // Sorted.  Added by Insert since deletions_ was last merged.
+};
+
+#endif // WORDINDEX_H
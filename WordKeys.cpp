@@ -0,0 +1,82 @@
+// WordKeys.cpp
+
+#include "WordKeys.h"
+#include <algorithm>
+#include "Utility.h"
+#include "Word.h"
+
+using namespace std;
+
+WordKeys::WordKeys()
+: keyboard_(0), word_(0), autoDiacritics_(false)
+{}
+
+void WordKeys::Update( Keyboard& keyboard, const Word& word, bool autoDiacritics ){
+    if( keyboard_ == &keyboard && word_ == &word && autoDiacritics_ == autoDiacritics )
+        return;
+    keyboard_ = &keyboard;
+    word_ = &word;
+    autoDiacritics_ = autoDiacritics;
+
+    always_.assign( keyboard.KeyCount(), false );
+    int key = keyboard.KeyIndex( static_cast<wchar_t>(8) ); // delete
+    if( key >= 0 )
+        always_[key] = true;
+    key = keyboard.KeyIndex( static_cast<wchar_t>(13) );    // enter
+    if( key >= 0 )
+        always_[key] = true;
+    uses_ = always_;
+    letters_.clear();
+    counts_.clear();
+    keys_.clear();
+
+    // Each letter enables the key for it, and the key for the character as spelt.  Each key is counted
+    // under its character converted, as CharacterAccepted did - converting an already converted letter
+    // can change it again (\xDF to \xFF to y), so the two keys aren't always counted under the same letter.
+    const wstring& normalised = word.GetMainSpelling().GetNormalised( autoDiacritics, true );
+    wstring spelling = word.GetMainSpellingString();
+    for( wstring::iterator iter = spelling.begin(); iter != spelling.end(); ++iter ){
+        wchar_t character = ToLower( *iter, autoDiacritics );
+        wchar_t characters[] = { character, *iter };
+        wchar_t counted[] = { ToLower( character, autoDiacritics ), character };
+        for( int i = 0; i < 2; ++i ){
+            key = keyboard.KeyIndex( characters[i] );
+            if( key < 0 )
+                continue;
+            uses_[key] = true;
+            vector<int>& keys = keys_[Letter( counted[i], normalised )];
+            if( find( keys.begin(), keys.end(), key ) == keys.end() )
+                keys.push_back( key );
+        }
+    }
+}
+
+const KeyMask& WordKeys::Uses() const{
+    return uses_;
+}
+
+void WordKeys::Unused( const std::wstring& attempt, KeyMask& enabled ) const{
+    vector<int> used( letters_.size(), 0 );
+    for( wstring::const_iterator iter = attempt.begin(); iter != attempt.end(); ++iter ){
+        size_t letter = letters_.find( *iter );
+        if( letter != wstring::npos )
+            ++used[letter];
+    }
+    enabled = always_;
+    for( size_t letter = 0; letter < letters_.size(); ++letter ){
+        if( counts_[letter] <= used[letter] )
+            continue;
+        for( vector<int>::const_iterator key = keys_[letter].begin(); key != keys_[letter].end(); ++key )
+            enabled[*key] = true;
+    }
+}
+
+size_t WordKeys::Letter( wchar_t letter, const std::wstring& normalised ){
+    size_t index = letters_.find( letter );
+    if( index != wstring::npos )
+        return index;
+    letters_ += letter;
+    counts_.push_back( static_cast<int>( count( normalised.begin(), normalised.end(), letter ) ) );
+    keys_.push_back( vector<int>() );
+    return letters_.size() - 1;
+}
@@ -0,0 +1,43 @@
+// WordKeys.h
+// The keys a word's spelling uses on a keyboard, for MiniSpell's LETTERS and LETTERSONCE write options.
+// Worked out once per word, keyboard and diacritic option, so each change to the attempt sets every key
+// from a mask in one pass (Keyboard::EnableKeys) instead of looking keys up letter by letter.
+// Letters are as ToLower gives them, so capitals (and diacritics if auto) share a letter.  Keys are enabled
+// exactly as the letter-by-letter EnableKey calls did (checked by Tests/WordKeysTest.cpp).
+
+#ifndef WORDKEYS_H
+#define WORDKEYS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Keyboard.h"
+
+class Word;
+
+class WordKeys{
+public:
+    WordKeys();
+
+    // Works the keys out again if the keyboard, word or diacritic option has changed.
+    void Update( Keyboard& keyboard, const Word& word, bool autoDiacritics );
+
+    const KeyMask& Uses() const; // Delete, enter and every key a letter enables (LETTERS)
+    // As Uses, less the keys of letters converted attempt has as many of as the spelling (LETTERSONCE).
+    void Unused( const std::wstring& attempt, KeyMask& enabled ) const;
+
+private:
+    std::size_t Letter( wchar_t letter, const std::wstring& normalised ); // Its index in letters_, added if new
+
+private:
+    const Keyboard* keyboard_;  // What the keys were worked out for
+    const Word* word_;
+    bool autoDiacritics_;
+    KeyMask always_;            // Delete and enter
+    KeyMask uses_;              // always_, and every key a letter enables
+    std::wstring letters_;      // Each different letter of the spelling
+    std::vector<int> counts_;   // How many of each the spelling has
+    std::vector<std::vector<int> > keys_; // The keys each letter enables
+};
+
+#endif // WORDKEYS_H